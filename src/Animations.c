@@ -12,8 +12,11 @@
 #include "Options.h"
 #include "Logger.h"
 
+#include "Animations.h"
+
+struct _AnimationsStats Animations_Stats;
 #ifndef CC_DISABLE_ANIMATIONS
-static void Animations_Update(int loc, struct Bitmap* bmp, int stride);
+static void Animations_Update(int loc, BitmapCol* pixels, int size, int stride);
 
 #ifdef CC_BUILD_LOWMEM
 	#define LIQUID_ANIM_MAX 16
@@ -38,13 +41,18 @@ static float L_flameHeat[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
 static RNGState L_rnd;
 static cc_bool  L_rndInited;
 
+static BitmapCol L_pixels[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
+
 static void LavaAnimation_Tick(void) {
-	BitmapCol pixels[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
-	BitmapCol* ptr = pixels;
+	/* Lookup table for (int)(1.2 * sin([ANGLE] * 22.5 * MATH_DEG2RAD)); */
+	/* [ANGLE] is integer x/y, so repeats every 16 intervals */
+	static const cc_int8 sin_adj_table[16] = { 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0 };
+	BitmapCol* ptr = L_pixels;
 	float soupHeat, potHeat, color;
 	int size, mask, shift;
-	int x, y, i = 0;
-	struct Bitmap bmp;
+	int x, y, i = 0, j;
+	int rows[5], potRow, potRowBelow;
+	int xx, xl, xr, xAdj, adj;
 
 	size  = min(Atlas2D.TileSize, LIQUID_ANIM_MAX);
 	mask  = size - 1;
@@ -56,32 +64,38 @@ static void LavaAnimation_Tick(void) {
 	}
 	
 	for (y = 0; y < size; y++) {
+		/* Row offsets only depend on y, so calculate them once per row */
+		/* Soup heat is sampled from rows (y - 2) to (y + 2), depending on x */
+		for (j = 0; j < 5; j++) { rows[j] = ((y - 2 + j) & mask) << shift; }
+		potRow      = y << shift;
+		potRowBelow = ((y + 1) & mask) << shift;
+		xAdj        = sin_adj_table[y & 0xF];
+
 		for (x = 0; x < size; x++) {
 			/* Calculate the color at this coordinate in the heatmap */
-
-			/* Lookup table for (int)(1.2 * sin([ANGLE] * 22.5 * MATH_DEG2RAD)); */
-			/* [ANGLE] is integer x/y, so repeats every 16 intervals */
-			static cc_int8 sin_adj_table[16] = { 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, -1, -1, -1, 0, 0 };
-			int xx = x + sin_adj_table[y & 0xF], yy = y + sin_adj_table[x & 0xF];
+			xx  = x + xAdj;
+			xl  = (xx - 1) & mask; xr = (xx + 1) & mask; xx &= mask;
+			adj = sin_adj_table[x & 0xF] + 1; /* index of row (yy - 1) in rows */
 
 			soupHeat =
-				L_soupHeat[((yy - 1) & mask) << shift | ((xx - 1) & mask)] +
-				L_soupHeat[((yy - 1) & mask) << shift | (xx       & mask)] +
-				L_soupHeat[((yy - 1) & mask) << shift | ((xx + 1) & mask)] +
+				L_soupHeat[rows[adj]     | xl] +
+				L_soupHeat[rows[adj]     | xx] +
+				L_soupHeat[rows[adj]     | xr] +
 
-				L_soupHeat[(yy & mask) << shift | ((xx - 1) & mask)] +
-				L_soupHeat[(yy & mask) << shift | (xx       & mask)] +
-				L_soupHeat[(yy & mask) << shift | ((xx + 1) & mask)] +
+				L_soupHeat[rows[adj + 1] | xl] +
+				L_soupHeat[rows[adj + 1] | xx] +
+				L_soupHeat[rows[adj + 1] | xr] +
 
-				L_soupHeat[((yy + 1) & mask) << shift | ((xx - 1) & mask)] +
-				L_soupHeat[((yy + 1) & mask) << shift | (xx       & mask)] +
-				L_soupHeat[((yy + 1) & mask) << shift | ((xx + 1) & mask)];
+				L_soupHeat[rows[adj + 2] | xl] +
+				L_soupHeat[rows[adj + 2] | xx] +
+				L_soupHeat[rows[adj + 2] | xr];
 
+			xr = (x + 1) & mask;
 			potHeat =
-				L_potHeat[i] +                                          /* x    , y     */
-				L_potHeat[y << shift | ((x + 1) & mask)] +              /* x + 1, y     */
-				L_potHeat[((y + 1) & mask) << shift | x] +              /* x    , y + 1 */
-				L_potHeat[((y + 1) & mask) << shift | ((x + 1) & mask)];/* x + 1, y + 1 */
+				L_potHeat[i] +                    /* x    , y     */
+				L_potHeat[potRow      | xr] +     /* x + 1, y     */
+				L_potHeat[potRowBelow | x ] +     /* x    , y + 1 */
+				L_potHeat[potRowBelow | xr];      /* x + 1, y + 1 */
 
 			L_soupHeat[i] = soupHeat * 0.1f + potHeat * 0.2f;
 
@@ -105,8 +119,7 @@ static void LavaAnimation_Tick(void) {
 		}
 	}
 
-	Bitmap_Init(bmp, size, size, pixels);
-	Animations_Update(LAVA_TEX_LOC, &bmp, size);
+	Animations_Update(LAVA_TEX_LOC, L_pixels, size, size);
 }
 
 
@@ -119,13 +132,13 @@ static float W_flameHeat[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
 static RNGState W_rnd;
 static cc_bool  W_rndInited;
 
+static BitmapCol W_pixels[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
+
 static void WaterAnimation_Tick(void) {
-	BitmapCol pixels[LIQUID_ANIM_MAX * LIQUID_ANIM_MAX];
-	BitmapCol* ptr = pixels;
+	BitmapCol* ptr = W_pixels;
 	float soupHeat, color;
 	int size, mask, shift;
-	int x, y, i = 0;
-	struct Bitmap bmp;
+	int x, y, i = 0, row;
 
 	size  = min(Atlas2D.TileSize, LIQUID_ANIM_MAX);
 	mask  = size - 1;
@@ -137,12 +150,14 @@ static void WaterAnimation_Tick(void) {
 	}
 	
 	for (y = 0; y < size; y++) {
+		row = y << shift;
+
 		for (x = 0; x < size; x++) {
 			/* Calculate the color at this coordinate in the heatmap */
 			soupHeat =
-				W_soupHeat[y << shift | ((x - 1) & mask)] +
-				W_soupHeat[y << shift | x               ] +
-				W_soupHeat[y << shift | ((x + 1) & mask)];
+				W_soupHeat[row | ((x - 1) & mask)] +
+				W_soupHeat[i] +
+				W_soupHeat[row | ((x + 1) & mask)];
 
 			W_soupHeat[i] = soupHeat / 3.3f + W_potHeat[i] * 0.8f;
 
@@ -167,12 +182,145 @@ static void WaterAnimation_Tick(void) {
 		}
 	}
 
-	Bitmap_Init(bmp, size, size, pixels);
-	Animations_Update(WATER_TEX_LOC, &bmp, size);
+	Animations_Update(WATER_TEX_LOC, W_pixels, size, size);
 }
 #endif
 
 
+/*########################################################################################################################*
+*----------------------------------------------------Animation uploads----------------------------------------------------*
+*#########################################################################################################################*/
+/* Tiles changed during a tick are queued up, so that tiles next to each other in the same */
+/*  1D atlas (i.e. horizontally adjacent tiles in terrain.png) can be uploaded all at once */
+struct AnimationUpload {
+	TextureLoc texLoc;
+	int size, stride;
+	BitmapCol* pixels;
+};
+static struct AnimationUpload anims_uploads[ATLAS1D_MAX_ATLASES + 2];
+static int anims_uploadsCount;
+
+static BitmapCol* anims_staging;
+static int anims_stagingTiles;
+
+/* Counters for the current second, moved into Animations_Stats once a second has passed */
+static struct _AnimationsStats anims_curStats;
+static int anims_statsTicks;
+
+static void Animations_Update(int texLoc, BitmapCol* pixels, int size, int stride) {
+	struct AnimationUpload* upload;
+	int i;
+
+	/* Later updates to the same tile replace earlier ones */
+	for (i = 0; i < anims_uploadsCount; i++)
+	{
+		if (anims_uploads[i].texLoc == texLoc) break;
+	}
+	if (i == Array_Elems(anims_uploads)) return;
+	if (i == anims_uploadsCount) anims_uploadsCount++;
+
+	upload = &anims_uploads[i];
+	upload->texLoc = texLoc;
+	upload->pixels = pixels;
+	upload->size   = size;
+	upload->stride = stride;
+	anims_curStats.Tiles++;
+}
+
+static void Animations_Upload(TextureLoc texLoc, BitmapCol* pixels, int width, int height, int stride) {
+	int dstX = Atlas1D_Index(texLoc);
+	int dstY = Atlas1D_RowId(texLoc) * Atlas2D.TileSize;
+	struct Bitmap part;
+	GfxResourceID tex;
+
+	tex = Atlas1D.TexIds[dstX];
+	if (!tex) return;
+
+	Bitmap_Init(part, width, height, pixels);
+	Gfx_UpdateTexture(tex, 0, dstY, &part, stride, Gfx.Mipmaps);
+
+	anims_curStats.Uploads++;
+	anims_curStats.UploadedBytes += width * height * BITMAPCOLOR_SIZE;
+}
+
+static cc_bool Animations_CanMerge(struct AnimationUpload* a, struct AnimationUpload* b) {
+	/* Only whole tiles can be merged, as the rest of a partial tile would need to be preserved */
+	return a->size == Atlas2D.TileSize && b->size == Atlas2D.TileSize 
+		&& b->texLoc == a->texLoc + 1 && Atlas1D_Index(a->texLoc) == Atlas1D_Index(b->texLoc);
+}
+
+static void Animations_UploadRun(struct AnimationUpload* run, int count) {
+	int tileSize = Atlas2D.TileSize;
+	int i, y, rowSize;
+	BitmapCol* dst;
+
+	if (count == 1) {
+		Animations_Upload(run->texLoc, run->pixels, run->size, run->size, run->stride);
+		return;
+	}
+
+	if (count > anims_stagingTiles) {
+		Mem_Free(anims_staging);
+		anims_staging = (BitmapCol*)Mem_TryAlloc(count * tileSize, tileSize * BITMAPCOLOR_SIZE);
+		anims_stagingTiles = anims_staging ? count : 0;
+	}
+
+	/* Not enough memory to merge the tiles, so upload each tile separately */
+	if (!anims_staging) {
+		for (i = 0; i < count; i++)
+		{
+			Animations_Upload(run[i].texLoc, run[i].pixels, run[i].size, run[i].size, run[i].stride);
+		}
+		return;
+	}
+
+	dst     = anims_staging;
+	rowSize = tileSize * BITMAPCOLOR_SIZE;
+	for (i = 0; i < count; i++)
+	{
+		for (y = 0; y < tileSize; y++, dst += tileSize)
+		{
+			Mem_Copy(dst, run[i].pixels + y * run[i].stride, rowSize);
+		}
+	}
+	Animations_Upload(run->texLoc, anims_staging, tileSize, tileSize * count, tileSize);
+}
+
+static void Animations_Flush(void) {
+	struct AnimationUpload tmp;
+	int i, j, beg;
+
+	/* Sort by tile, so adjacent tiles end up next to each other */
+	for (i = 1; i < anims_uploadsCount; i++)
+	{
+		tmp = anims_uploads[i];
+		for (j = i - 1; j >= 0 && anims_uploads[j].texLoc > tmp.texLoc; j--)
+		{
+			anims_uploads[j + 1] = anims_uploads[j];
+		}
+		anims_uploads[j + 1] = tmp;
+	}
+
+	for (beg = 0; beg < anims_uploadsCount; beg = i)
+	{
+		for (i = beg + 1; i < anims_uploadsCount; i++)
+		{
+			if (!Animations_CanMerge(&anims_uploads[i - 1], &anims_uploads[i])) break;
+		}
+		Animations_UploadRun(&anims_uploads[beg], i - beg);
+	}
+	anims_uploadsCount = 0;
+}
+
+static void Animations_UpdateStats(void) {
+	if (++anims_statsTicks < 20) return;
+
+	Animations_Stats  = anims_curStats;
+	anims_statsTicks  = 0;
+	Mem_Set(&anims_curStats, 0, sizeof(anims_curStats));
+}
+
+
 /*########################################################################################################################*
 *-------------------------------------------------------Animations--------------------------------------------------------*
 *#########################################################################################################################*/
@@ -184,6 +332,7 @@ struct AnimationData {
 	cc_uint16 statesCount;    /* Total number of animation frames */
 	cc_uint16 delay;          /* Delay in ticks until next frame is drawn */
 	cc_uint16 frameDelay;     /* Delay between each frame */
+	cc_bool uploaded;         /* Whether any frame has been uploaded to the atlas yet */
 };
 
 static struct Bitmap anims_bmp;
@@ -249,20 +398,30 @@ static void Animations_ReadDescription(struct Stream* stream, const cc_string* p
 	}
 }
 
-static void Animations_Update(int texLoc, struct Bitmap* bmp, int stride) {
-	int dstX = Atlas1D_Index(texLoc);
-	int dstY = Atlas1D_RowId(texLoc) * Atlas2D.TileSize;
-	GfxResourceID tex;
+static BitmapCol* Animations_GetFrame(struct AnimationData* data, int state) {
+	return anims_bmp.scan0 
+		+ data->frameY * anims_bmp.width
+		+ (data->frameX + state * data->frameSize);
+}
 
-	tex = Atlas1D.TexIds[dstX];
-	if (tex) Gfx_UpdateTexture(tex, 0, dstY, bmp, stride, Gfx.Mipmaps);
+static cc_bool Animations_SameFrame(struct AnimationData* data, BitmapCol* a, BitmapCol* b) {
+	int y, size = data->frameSize;
+	if (a == b) return true;
+
+	for (y = 0; y < size; y++)
+	{
+		if (!Mem_Equal(a + y * anims_bmp.width, b + y * anims_bmp.width, size * BITMAPCOLOR_SIZE)) return false;
+	}
+	return true;
 }
 
 static void Animations_Apply(struct AnimationData* data) {
-	struct Bitmap frame;
-	int loc, size;
+	BitmapCol* prev;
+	BitmapCol* cur;
+	int loc;
 	if (data->delay) { data->delay--; return; }
 
+	prev = Animations_GetFrame(data, data->state);
 	data->state++;
 	data->state %= data->statesCount;
 	data->delay  = data->frameDelay;
@@ -272,14 +431,15 @@ static void Animations_Apply(struct AnimationData* data) {
 	if (loc == LAVA_TEX_LOC  && useLavaAnim)  return;
 	if (loc == WATER_TEX_LOC && useWaterAnim) return;
 #endif
+	cur = Animations_GetFrame(data, data->state);
 
-	size = data->frameSize;
-	Bitmap_Init(frame, size, size, NULL);
+	/* Many animations have runs of identical frames (e.g. to pause between movements) */
+	if (data->uploaded && Animations_SameFrame(data, prev, cur)) {
+		anims_curStats.SkippedTiles++; return;
+	}
 
-	frame.scan0 = anims_bmp.scan0 
-				+ data->frameY * anims_bmp.width
-				+ (data->frameX + data->state * size);
-	Animations_Update(loc, &frame, anims_bmp.width);
+	data->uploaded = true;
+	Animations_Update(loc, cur, data->frameSize, anims_bmp.width);
 }
 
 static cc_bool Animations_IsDefaultZip(void) {
@@ -296,6 +456,11 @@ static void Animations_Clear(void) {
 	anims_count = 0;
 	anims_bmp.scan0 = NULL;
 	anims_validated = false;
+
+	Mem_Free(anims_staging);
+	anims_staging      = NULL;
+	anims_stagingTiles = 0;
+	anims_uploadsCount = 0;
 }
 
 static void Animations_Validate(void) {
@@ -333,13 +498,8 @@ static void Animations_Validate(void) {
 	}
 }
 
-static void Animations_Tick(struct ScheduledTask* task) {
+static void Animations_ApplyAll(void) {
 	int i;
-#ifndef CC_BUILD_WEB
-	if (useLavaAnim)  LavaAnimation_Tick();
-	if (useWaterAnim) WaterAnimation_Tick();
-#endif
-
 	if (!anims_count) return;
 	if (!anims_bmp.scan0) {
 		Chat_AddRaw("&cCurrent texture pack specifies it uses animations,");
@@ -354,12 +514,23 @@ static void Animations_Tick(struct ScheduledTask* task) {
 	}
 }
 
+static void Animations_Tick(struct ScheduledTask* task) {
+#ifndef CC_BUILD_WEB
+	if (useLavaAnim)  LavaAnimation_Tick();
+	if (useWaterAnim) WaterAnimation_Tick();
+#endif
+
+	Animations_ApplyAll();
+	Animations_Flush();
+	Animations_UpdateStats();
+}
+
 
 /*########################################################################################################################*
 *--------------------------------------------------Animations component---------------------------------------------------*
 *#########################################################################################################################*/
 static void AnimationsPngProcess(struct Stream* stream, const cc_string* name) {
-	cc_result res = Png_Decode(&anims_bmp, stream);
+	cc_result res = TexturePack_DecodePng(&anims_bmp, stream);
 	if (!res) return;
 
 	Logger_SysWarn2(res, "decoding", name);
@@ -389,6 +560,12 @@ static void OnPackChanged(void* obj) {
 	alwaysLavaAnim  = false;
 	alwaysWaterAnim = false;
 }
+static void OnAtlasChanged(void* obj) {
+	int i;
+	/* Atlas was recreated from terrain.png, so the current frames need to be uploaded again */
+	for (i = 0; i < anims_count; i++) { anims_list[i].uploaded = false; }
+}
+
 static void OnInit(void) {
 	TextureEntry_Register(&animations_entry);
 	TextureEntry_Register(&animations_txt);
@@ -396,7 +573,8 @@ static void OnInit(void) {
 	TextureEntry_Register(&lava_entry);
 
 	ScheduledTask_Add(GAME_DEF_TICKS, Animations_Tick);
-	Event_Register_(&TextureEvents.PackChanged, NULL, OnPackChanged);
+	Event_Register_(&TextureEvents.PackChanged,  NULL, OnPackChanged);
+	Event_Register_(&TextureEvents.AtlasChanged, NULL, OnAtlasChanged);
 }
 #else
 static void Animations_Clear(void) { }
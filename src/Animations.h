@@ -10,5 +10,11 @@ CC_BEGIN_HEADER
 struct IGameComponent;
 extern struct IGameComponent Animations_Component;
 
+/* Statistics about texture animation uploads over the most recent second */
+extern struct _AnimationsStats {
+	int Tiles, SkippedTiles;      /* Tiles changed, and tile frames skipped as identical to the previous frame */
+	int Uploads, UploadedBytes;  /* Texture uploads performed for changed tiles, and amount of data uploaded */
+} Animations_Stats;
+
 CC_END_HEADER
 #endif
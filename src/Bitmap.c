@@ -80,6 +80,15 @@ enum PngFilter {
 };
 
 typedef void (*Png_RowExpander)(int width, BitmapCol* palette, cc_uint8* src, BitmapCol* dst);
+
+/* Whether the byte layout of BitmapCol in memory is the same as PNG's R,G,B,A byte order */
+#if defined BITMAP_16BPP
+	/* Never the same */
+#elif !defined CC_BIG_ENDIAN && BITMAPCOLOR_R_SHIFT == 0  && BITMAPCOLOR_G_SHIFT == 8  && BITMAPCOLOR_B_SHIFT == 16 && BITMAPCOLOR_A_SHIFT == 24
+	#define PNG_RGBA_MATCHES_BITMAP
+#elif  defined CC_BIG_ENDIAN && BITMAPCOLOR_R_SHIFT == 24 && BITMAPCOLOR_G_SHIFT == 16 && BITMAPCOLOR_B_SHIFT == 8  && BITMAPCOLOR_A_SHIFT == 0
+	#define PNG_RGBA_MATCHES_BITMAP
+#endif
 static const cc_uint8 pngSig[PNG_SIG_SIZE] = { 137, 80, 78, 71, 13, 10, 26, 10 };
 
 /* 5.2 PNG signature */
@@ -89,6 +98,69 @@ cc_bool Png_Detect(const cc_uint8* data, cc_uint32 len) {
 
 /* 9 Filtering */
 /* 13.9 Filtering */
+/* 9.4 Filter type 4: Paeth */
+/* p - a, p - b and p - c are computed directly, which avoids calculating p */
+static CC_INLINE cc_uint8 Png_Paeth(int a, int b, int c) {
+	int pa = b - c, pb = a - c, pc = pa + pb;
+	int best, bestDist;
+	if (pa < 0) pa = -pa;
+	if (pb < 0) pb = -pb;
+	if (pc < 0) pc = -pc;
+
+	/* Same as (pa <= pb && pa <= pc) ? a : (pb <= pc ? b : c), but written */
+	/*  so that compilers can use conditional moves instead of branches */
+	best     = pb <= pc ? b  : c;
+	bestDist = pb <= pc ? pb : pc;
+	return pa <= bestDist ? a : best;
+}
+
+/* Most images are RGBA, so specialise filters for 4 bytes per pixel */
+/* Keeping left/upper left pixel in locals avoids having to reload them from memory */
+static void Png_Sub_4(cc_uint8* line, cc_uint32 lineLen) {
+	cc_uint8 a0 = line[0], a1 = line[1], a2 = line[2], a3 = line[3];
+	cc_uint32 i;
+
+	for (i = 4; i < lineLen; i += 4) 
+	{
+		a0 = line[i + 0] += a0;
+		a1 = line[i + 1] += a1;
+		a2 = line[i + 2] += a2;
+		a3 = line[i + 3] += a3;
+	}
+}
+
+static void Png_Average_4(cc_uint8* line, const cc_uint8* prior, cc_uint32 lineLen) {
+	cc_uint8 a0 = line[0], a1 = line[1], a2 = line[2], a3 = line[3];
+	cc_uint32 i;
+
+	for (i = 4; i < lineLen; i += 4) 
+	{
+		a0 = line[i + 0] += (prior[i + 0] + a0) >> 1;
+		a1 = line[i + 1] += (prior[i + 1] + a1) >> 1;
+		a2 = line[i + 2] += (prior[i + 2] + a2) >> 1;
+		a3 = line[i + 3] += (prior[i + 3] + a3) >> 1;
+	}
+}
+
+static void Png_Paeth_4(cc_uint8* line, const cc_uint8* prior, cc_uint32 lineLen) {
+	cc_uint8 a0 = line[0],  a1 = line[1],  a2 = line[2],  a3 = line[3];
+	cc_uint8 c0 = prior[0], c1 = prior[1], c2 = prior[2], c3 = prior[3];
+	cc_uint8 b0, b1, b2, b3;
+	cc_uint32 i;
+
+	for (i = 4; i < lineLen; i += 4) 
+	{
+		b0 = prior[i + 0]; b1 = prior[i + 1]; b2 = prior[i + 2]; b3 = prior[i + 3];
+
+		a0 = line[i + 0] += Png_Paeth(a0, b0, c0);
+		a1 = line[i + 1] += Png_Paeth(a1, b1, c1);
+		a2 = line[i + 2] += Png_Paeth(a2, b2, c2);
+		a3 = line[i + 3] += Png_Paeth(a3, b3, c3);
+
+		c0 = b0; c1 = b1; c2 = b2; c3 = b3;
+	}
+}
+
 static void Png_ReconstructFirst(cc_uint8 type, cc_uint8 bytesPerPixel, cc_uint8* line, cc_uint32 lineLen) {
 	/* First scanline is a special case, where all values in prior array are 0 */
 	cc_uint32 i, j;
@@ -119,6 +191,8 @@ static void Png_Reconstruct(cc_uint8 type, cc_uint8 bytesPerPixel, cc_uint8* lin
 
 	switch (type) {
 	case PNG_FILTER_SUB:
+		if (bytesPerPixel == 4) { Png_Sub_4(line, lineLen); return; }
+
 		for (i = bytesPerPixel, j = 0; i < lineLen; i++, j++) {
 			line[i] += line[j];
 		}
@@ -134,26 +208,21 @@ static void Png_Reconstruct(cc_uint8 type, cc_uint8 bytesPerPixel, cc_uint8* lin
 		for (i = 0; i < bytesPerPixel; i++) {
 			line[i] += (prior[i] >> 1);
 		}
+		if (bytesPerPixel == 4) { Png_Average_4(line, prior, lineLen); return; }
+
 		for (j = 0; i < lineLen; i++, j++) {
 			line[i] += ((prior[i] + line[j]) >> 1);
 		}
 		return;
 
 	case PNG_FILTER_PAETH:
-		/* TODO: verify this is right */
 		for (i = 0; i < bytesPerPixel; i++) {
 			line[i] += prior[i];
 		}
+		if (bytesPerPixel == 4) { Png_Paeth_4(line, prior, lineLen); return; }
+
 		for (j = 0; i < lineLen; i++, j++) {
-			cc_uint8 a = line[j], b = prior[i], c = prior[j];
-			int p = a + b - c;
-			int pa = Math_AbsI(p - a);
-			int pb = Math_AbsI(p - b);
-			int pc = Math_AbsI(p - c);
-
-			if (pa <= pb && pa <= pc) { line[i] += a; } 
-			else if (pb <= pc) {        line[i] += b; } 
-			else {                      line[i] += c; }
+			line[i] += Png_Paeth(line[j], prior[i], prior[j]);
 		}
 		return;
 	}
@@ -254,12 +323,15 @@ static void Png_Expand_GRAYSCALE_A_8(int width, BitmapCol* palette, cc_uint8* sr
 
 static void Png_Expand_RGB_A_8(int width, BitmapCol* palette, cc_uint8* src, BitmapCol* dst) {
 	/* Processed in forward order */
-
+#if defined PNG_RGBA_MATCHES_BITMAP
+	Mem_Copy(dst, src, width * 4);
+#else
 	for (; width >= 4; width -= 4) {
 		PNG_Do_RGB_A__8(); PNG_Do_RGB_A__8();
 		PNG_Do_RGB_A__8(); PNG_Do_RGB_A__8();
 	}
 	for (; width > 0; width--) { PNG_Do_RGB_A__8(); }
+#endif
 }
 
 static Png_RowExpander Png_GetExpander(cc_uint8 col, cc_uint8 bitsPerSample) {
@@ -653,13 +725,12 @@ static void Png_EncodeRow(const cc_uint8* cur, const cc_uint8* prior, cc_uint8*
 
 static BitmapCol* DefaultGetRow(struct Bitmap* bmp, int y, void* ctx) { return Bitmap_GetRow(bmp, y); }
 static cc_result Png_EncodeCore(struct Bitmap* bmp, struct Stream* stream, cc_uint8* buffer,
-					Png_RowGetter getRow, cc_bool alpha, void* ctx) {
+					struct ZLibState* zlState, Png_RowGetter getRow, cc_bool alpha, void* ctx) {
 	cc_uint8 tmp[32];
 	cc_uint8* prevLine = buffer;
 	cc_uint8*  curLine = buffer + (bmp->width * 4) * 1;
 	cc_uint8* bestLine = buffer + (bmp->width * 4) * 2;
 
-	struct ZLibState zlState;
 	struct Stream chunk, zlStream;
 	cc_uint32 stream_end, stream_beg;
 	int y, lineSize;
@@ -692,7 +763,7 @@ static cc_result Png_EncodeCore(struct Bitmap* bmp, struct Stream* stream, cc_ui
 	Stream_SetU32_BE(&tmp[0], PNG_FourCC('I','D','A','T'));
 	if ((res = Stream_Write(&chunk, tmp, 4))) return res;
 
-	ZLib_MakeStream(&zlStream, &zlState, &chunk); 
+	ZLib_MakeStream(&zlStream, zlState, &chunk); 
 	lineSize = bmp->width * (alpha ? 4 : 3);
 	Mem_Set(prevLine, 0, lineSize);
 
@@ -727,12 +798,20 @@ static cc_result Png_EncodeCore(struct Bitmap* bmp, struct Stream* stream, cc_ui
 
 cc_result Png_Encode(struct Bitmap* bmp, struct Stream* stream, 
 					Png_RowGetter getRow, cc_bool alpha, void* ctx) {
+	struct ZLibState* zlState;
+	cc_uint8* buffer;
 	cc_result res;
+
 	/* Add 1 for scanline filter type byter */
-	cc_uint8* buffer = (cc_uint8*)Mem_TryAlloc(3, bmp->width * 4 + 1);
+	buffer = (cc_uint8*)Mem_TryAlloc(3, bmp->width * 4 + 1);
 	if (!buffer) return ERR_NOT_SUPPORTED;
 
-	res = Png_EncodeCore(bmp, stream, buffer, getRow, alpha, ctx);
+	/* ZLib state is over 100 KB, so too large for the stack of e.g. the screenshot thread */
+	zlState = (struct ZLibState*)Mem_TryAlloc(1, sizeof(struct ZLibState));
+	if (!zlState) { Mem_Free(buffer); return ERR_OUT_OF_MEMORY; }
+
+	res = Png_EncodeCore(bmp, stream, buffer, zlState, getRow, alpha, ctx);
+	Mem_Free(zlState);
 	Mem_Free(buffer);
 	return res;
 }
@@ -244,6 +244,245 @@ static void PrepareChunk(int x1, int y1, int z1) {
 	}
 }
 
+/* Chunks far away from the camera can be built at a lower level of detail. In that case, */
+/*  the chunk is divided into cells of 2x2x2 or 4x4x4 blocks, with each cell then drawn */
+/*  as a single cube of whichever block is most common within that cell. */
+#define LOD_MAX_CELLS (CHUNK_SIZE / 2)
+#define Lod_Pack(cx, cy, cz) ((((cy) * LOD_MAX_CELLS) + (cz)) * LOD_MAX_CELLS + (cx))
+
+static BlockID lod_cells[LOD_MAX_CELLS * LOD_MAX_CELLS * LOD_MAX_CELLS];
+static cc_uint8 lod_faces[LOD_MAX_CELLS * LOD_MAX_CELLS * LOD_MAX_CELLS];
+/* Size of each cell in blocks, and number of cells along each axis */
+static int lod_size, lod_cellsX, lod_cellsY, lod_cellsZ;
+/* Coordinates of the chunk in the world, and its extent (can be less than 16 at the world edges) */
+static int lod_x1, lod_y1, lod_z1;
+static int lod_endX, lod_endY, lod_endZ;
+
+static BlockID Lod_CalcCell(int x1, int y1, int z1, int x2, int y2, int z2) {
+	BlockID blocks[8];
+	int counts[8];
+	int x, y, z, i, best = 0, numBlocks = 0;
+	int solid = 0, total = 0;
+	cc_bool onEdge = false;
+	BlockID block;
+
+	for (y = y1; y < y2; y++) {
+		for (z = z1; z < z2; z++) {
+			for (x = x1; x < x2; x++) 
+			{
+				block = Builder_Chunk[Builder_PackChunk(x, y, z)];
+				total++;
+				if (Blocks.Draw[block] == DRAW_GAS || Blocks.Draw[block] == DRAW_SPRITE) continue;
+
+				solid++;
+				onEdge |= x == 0 || x == CHUNK_MAX || y == 0 || y == CHUNK_MAX || z == 0 || z == CHUNK_MAX;
+
+				for (i = 0; i < numBlocks && blocks[i] != block; i++) { }
+				if (i < numBlocks) {
+					counts[i]++;
+				} else if (numBlocks < Array_Elems(blocks)) {
+					blocks[numBlocks] = block; counts[numBlocks] = 1; numBlocks++;
+				}
+			}
+		}
+	}
+
+	/* Cells which touch the chunk's boundary are kept if they contain any block at all. This ensures */
+	/*  cells cover every block that a neighbouring chunk may have hidden its own faces against, */
+	/*  which avoids gaps appearing between chunks that are at different levels of detail. */
+	if (!solid || (solid * 2 < total && !onEdge)) return BLOCK_AIR;
+
+	for (i = 1; i < numBlocks; i++) 
+	{
+		if (counts[i] > counts[best]) best = i;
+	}
+	return blocks[best];
+}
+
+static cc_bool Lod_IsFaceHidden(BlockID block, int cx, int cy, int cz, Face face) {
+	int size = lod_size;
+	int x1 = cx * size, x2 = min(x1 + size, lod_endX);
+	int y1 = cy * size, y2 = min(y1 + size, lod_endY);
+	int z1 = cz * size, z2 = min(z1 + size, lod_endZ);
+	int x, y, z;
+
+	switch (face) {
+	case FACE_XMIN:
+		if (cx > 0) return Block_IsFaceHidden(block, lod_cells[Lod_Pack(cx - 1, cy, cz)], face) != 0;
+		if (lod_x1 == 0) return lod_y1 + y1 < Builder_SidesLevel;
+		x2 = x1; x1--; break;
+	case FACE_XMAX:
+		if (cx < lod_cellsX - 1) return Block_IsFaceHidden(block, lod_cells[Lod_Pack(cx + 1, cy, cz)], face) != 0;
+		if (lod_x1 + x2 == World.Width) return lod_y1 + y1 < Builder_SidesLevel;
+		x1 = x2; x2++; break;
+	case FACE_ZMIN:
+		if (cz > 0) return Block_IsFaceHidden(block, lod_cells[Lod_Pack(cx, cy, cz - 1)], face) != 0;
+		if (lod_z1 == 0) return lod_y1 + y1 < Builder_SidesLevel;
+		z2 = z1; z1--; break;
+	case FACE_ZMAX:
+		if (cz < lod_cellsZ - 1) return Block_IsFaceHidden(block, lod_cells[Lod_Pack(cx, cy, cz + 1)], face) != 0;
+		if (lod_z1 + z2 == World.Length) return lod_y1 + y1 < Builder_SidesLevel;
+		z1 = z2; z2++; break;
+	case FACE_YMIN:
+		if (cy > 0) return Block_IsFaceHidden(block, lod_cells[Lod_Pack(cx, cy - 1, cz)], face) != 0;
+		if (lod_y1 == 0) return true;
+		y2 = y1; y1--; break;
+	case FACE_YMAX:
+		if (cy < lod_cellsY - 1) return Block_IsFaceHidden(block, lod_cells[Lod_Pack(cx, cy + 1, cz)], face) != 0;
+		y1 = y2; y2++; break;
+	}
+
+	/* Neighbouring chunk may be at a different level of detail, so only hide the face */
+	/*  when every block next to it in the neighbouring chunk hides it */
+	for (y = y1; y < y2; y++) {
+		for (z = z1; z < z2; z++) {
+			for (x = x1; x < x2; x++) 
+			{
+				if (!Block_IsFaceHidden(block, Builder_Chunk[Builder_PackChunk(x, y, z)], face)) return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void Lod_PrepareChunk(int x1, int y1, int z1, int size) {
+	int cx, cy, cz, x, y, z, index;
+	BlockID block;
+	Face face;
+	cc_uint8 faces;
+
+	lod_size = size;
+	lod_x1   = x1; lod_y1 = y1; lod_z1 = z1;
+	lod_endX = min(World.Width,  x1 + CHUNK_SIZE) - x1;
+	lod_endY = min(World.Height, y1 + CHUNK_SIZE) - y1;
+	lod_endZ = min(World.Length, z1 + CHUNK_SIZE) - z1;
+
+	lod_cellsX = (lod_endX + size - 1) / size;
+	lod_cellsY = (lod_endY + size - 1) / size;
+	lod_cellsZ = (lod_endZ + size - 1) / size;
+
+	for (cy = 0, y = 0; cy < lod_cellsY; cy++, y += size) {
+		for (cz = 0, z = 0; cz < lod_cellsZ; cz++, z += size) {
+			for (cx = 0, x = 0; cx < lod_cellsX; cx++, x += size) 
+			{
+				lod_cells[Lod_Pack(cx, cy, cz)] = Lod_CalcCell(x, y, z,
+					min(x + size, lod_endX), min(y + size, lod_endY), min(z + size, lod_endZ));
+			}
+		}
+	}
+
+	for (cy = 0; cy < lod_cellsY; cy++) {
+		for (cz = 0; cz < lod_cellsZ; cz++) {
+			for (cx = 0; cx < lod_cellsX; cx++) 
+			{
+				index = Lod_Pack(cx, cy, cz);
+				block = lod_cells[index];
+				faces = 0;
+
+				if (Blocks.Draw[block] != DRAW_GAS) {
+					for (face = 0; face < FACE_COUNT; face++) 
+					{
+						if (Lod_IsFaceHidden(block, cx, cy, cz, face)) continue;
+						faces |= 1 << face;
+						AddVertices(block, face);
+					}
+				}
+				lod_faces[index] = faces;
+			}
+		}
+	}
+}
+
+static void Lod_RenderCell(BlockID block, cc_uint8 faces, int x1, int y1, int z1, int x2, int y2, int z2) {
+	int baseOffset = (Blocks.Draw[block] == DRAW_TRANSLUCENT) * ATLAS1D_MAX_ATLASES;
+	cc_bool fullBright = Blocks.Brightness[block];
+	struct Builder1DPart* part;
+	TextureLoc loc;
+	PackedCol col;
+	/* Side faces are lit according to the top row of blocks in the cell */
+	int sideY = y2 - 1;
+
+	Drawer.MinBB.x = 0.0f; Drawer.MinBB.y = 1.0f; Drawer.MinBB.z = 0.0f;
+	Drawer.MaxBB.x = 1.0f; Drawer.MaxBB.y = 0.0f; Drawer.MaxBB.z = 1.0f;
+
+	Drawer.X1 = (float)x1; Drawer.Y1 = (float)y1; Drawer.Z1 = (float)z1;
+	Drawer.X2 = (float)x2; Drawer.Y2 = (float)y2; Drawer.Z2 = (float)z2;
+
+	Drawer.Tinted  = Blocks.Tinted[block];
+	Drawer.TintCol = Blocks.FogCol[block];
+
+	if (faces & FACE_BIT_XMIN) {
+		loc  = Block_Tex(block, FACE_XMIN);
+		part = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+
+		col = fullBright ? PACKEDCOL_WHITE :
+			x1 > 0 ? Lighting.Color_XSide_Fast(x1 - 1, sideY, z1) : Env.SunXSide;
+		Drawer_XMin(1, col, loc, &part->faces.vertices[FACE_XMIN]);
+	}
+
+	if (faces & FACE_BIT_XMAX) {
+		loc  = Block_Tex(block, FACE_XMAX);
+		part = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+
+		col = fullBright ? PACKEDCOL_WHITE :
+			x2 < World.Width ? Lighting.Color_XSide_Fast(x2, sideY, z1) : Env.SunXSide;
+		Drawer_XMax(1, col, loc, &part->faces.vertices[FACE_XMAX]);
+	}
+
+	if (faces & FACE_BIT_ZMIN) {
+		loc  = Block_Tex(block, FACE_ZMIN);
+		part = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+
+		col = fullBright ? PACKEDCOL_WHITE :
+			z1 > 0 ? Lighting.Color_ZSide_Fast(x1, sideY, z1 - 1) : Env.SunZSide;
+		Drawer_ZMin(1, col, loc, &part->faces.vertices[FACE_ZMIN]);
+	}
+
+	if (faces & FACE_BIT_ZMAX) {
+		loc  = Block_Tex(block, FACE_ZMAX);
+		part = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+
+		col = fullBright ? PACKEDCOL_WHITE :
+			z2 < World.Length ? Lighting.Color_ZSide_Fast(x1, sideY, z2) : Env.SunZSide;
+		Drawer_ZMax(1, col, loc, &part->faces.vertices[FACE_ZMAX]);
+	}
+
+	if (faces & FACE_BIT_YMIN) {
+		loc  = Block_Tex(block, FACE_YMIN);
+		part = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+
+		col = fullBright ? PACKEDCOL_WHITE : Lighting.Color_YMin_Fast(x1, y1 - 1, z1);
+		Drawer_YMin(1, col, loc, &part->faces.vertices[FACE_YMIN]);
+	}
+
+	if (faces & FACE_BIT_YMAX) {
+		loc  = Block_Tex(block, FACE_YMAX);
+		part = &Builder_Parts[baseOffset + Atlas1D_Index(loc)];
+
+		col = fullBright ? PACKEDCOL_WHITE : Lighting.Color_YMax_Fast(x1, y2, z1);
+		Drawer_YMax(1, col, loc, &part->faces.vertices[FACE_YMAX]);
+	}
+}
+
+static void Lod_RenderChunk(void) {
+	int size = lod_size;
+	int cx, cy, cz, x, y, z, index;
+
+	for (cy = 0, y = 0; cy < lod_cellsY; cy++, y += size) {
+		for (cz = 0, z = 0; cz < lod_cellsZ; cz++, z += size) {
+			for (cx = 0, x = 0; cx < lod_cellsX; cx++, x += size) 
+			{
+				index = Lod_Pack(cx, cy, cz);
+				if (!lod_faces[index]) continue;
+
+				Lod_RenderCell(lod_cells[index], lod_faces[index],
+					lod_x1 + x, lod_y1 + y, lod_z1 + z,
+					lod_x1 + min(x + size, lod_endX), lod_y1 + min(y + size, lod_endY), lod_z1 + min(z + size, lod_endZ));
+			}
+		}
+	}
+}
+
 #define ReadChunkBody(get_block)\
 for (yy = -1; yy < 17; ++yy) {\
 	y = yy + y1;\
@@ -359,27 +598,9 @@ static void OutputChunkPartsMeta(int x, int y, int z, struct ChunkInfo* info) {
 	}
 }
 
-void Builder_MakeChunk(struct ChunkInfo* info) {
-#ifdef CC_BUILD_TINYSTACK
-	/* The Saturn build only has 16 kb stack, not large enough */
-	static BlockID chunk[EXTCHUNK_SIZE_3]; 
-	static cc_uint8 counts[CHUNK_SIZE_3 * FACE_COUNT]; 
-	static int bitFlags[1];
-#else
-	BlockID chunk[EXTCHUNK_SIZE_3]; 
-	cc_uint8 counts[CHUNK_SIZE_3 * FACE_COUNT]; 
-	int bitFlags[EXTCHUNK_SIZE_3];
-#endif
-
+/* Reads the blocks in and around the given chunk, then calculates how many vertices are needed */
+static int CountChunkVertices(int x1, int y1, int z1, int lod, cc_bool* outAllAir) {
 	cc_bool allAir, allSolid, onBorder;
-	int xMax, yMax, zMax, totalVerts;
-	int cIndex, index;
-	int x, y, z, xx, yy, zz;
-	int x1 = info->centreX - 8, y1 = info->centreY - 8, z1 = info->centreZ - 8;
-
-	Builder_Chunk  = chunk;
-	Builder_Counts = counts;
-	Builder_BitFlags = bitFlags;
 	Builder_PrePrepareChunk();
 	
 	onBorder = 
@@ -388,26 +609,69 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 
 	if (onBorder) {
 		/* less optimal case here */
-		Mem_Set(chunk, BLOCK_AIR, EXTCHUNK_SIZE_3 * sizeof(BlockID));
+		Mem_Set(Builder_Chunk, BLOCK_AIR, EXTCHUNK_SIZE_3 * sizeof(BlockID));
 		allSolid = ReadBorderChunkData(x1, y1, z1, &allAir);
 	} else {
 		allSolid = ReadChunkData(x1, y1, z1, &allAir);
 	}
 
-	info->allAir = allAir;
-	if (allAir || allSolid) return;
+	*outAllAir = allAir;
+	if (allAir || allSolid) return 0;
 	Lighting.LightHint(x1 - 1, y1 - 1, z1 - 1);
 
-	Mem_Set(counts, 1, CHUNK_SIZE_3 * FACE_COUNT);
-	xMax = min(World.Width,  x1 + CHUNK_SIZE);
-	yMax = min(World.Height, y1 + CHUNK_SIZE);
-	zMax = min(World.Length, z1 + CHUNK_SIZE);
+	if (lod) {
+		Lod_PrepareChunk(x1, y1, z1, 1 << lod);
+	} else {
+		Mem_Set(Builder_Counts, 1, CHUNK_SIZE_3 * FACE_COUNT);
+		Builder_ChunkEndX = min(World.Width,  x1 + CHUNK_SIZE);
+		Builder_ChunkEndZ = min(World.Length, z1 + CHUNK_SIZE);
+		PrepareChunk(x1, y1, z1);
+	}
+	return Builder_TotalVerticesCount();
+}
+
+#ifdef CC_BUILD_TINYSTACK
+/* The Saturn build only has 16 kb stack, not large enough */
+#define Builder_DeclareBuffers() \
+	static BlockID chunk[EXTCHUNK_SIZE_3]; \
+	static cc_uint8 counts[CHUNK_SIZE_3 * FACE_COUNT]; \
+	static int bitFlags[1];
+#else
+#define Builder_DeclareBuffers() \
+	BlockID chunk[EXTCHUNK_SIZE_3]; \
+	cc_uint8 counts[CHUNK_SIZE_3 * FACE_COUNT]; \
+	int bitFlags[EXTCHUNK_SIZE_3];
+#endif
+
+int Builder_CountVertices(int x1, int y1, int z1, int lod) {
+	Builder_DeclareBuffers()
+	cc_bool allAir;
+
+	Builder_Chunk    = chunk;
+	Builder_Counts   = counts;
+	Builder_BitFlags = bitFlags;
+	return CountChunkVertices(x1, y1, z1, lod, &allAir);
+}
+
+void Builder_MakeChunk(struct ChunkInfo* info) {
+	Builder_DeclareBuffers()
+	cc_bool allAir;
+	int xMax, yMax, zMax, totalVerts;
+	int cIndex, index;
+	int x, y, z, xx, yy, zz;
+	int x1 = info->centreX - 8, y1 = info->centreY - 8, z1 = info->centreZ - 8;
 
-	Builder_ChunkEndX = xMax; Builder_ChunkEndZ = zMax;
-	PrepareChunk(x1, y1, z1);
+	Builder_Chunk    = chunk;
+	Builder_Counts   = counts;
+	Builder_BitFlags = bitFlags;
 
-	totalVerts = Builder_TotalVerticesCount();
+	totalVerts   = CountChunkVertices(x1, y1, z1, info->lod, &allAir);
+	info->allAir = allAir;
 	if (!totalVerts) return;
+
+	xMax = min(World.Width,  x1 + CHUNK_SIZE);
+	yMax = min(World.Height, y1 + CHUNK_SIZE);
+	zMax = min(World.Length, z1 + CHUNK_SIZE);
 	
 	OutputChunkPartsMeta(x1, y1, z1, info);
 #ifdef OCCLUSION
@@ -417,8 +681,7 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 
 #ifndef CC_BUILD_GL11
 	/* add an extra element to fix crashing on some GPUs */
-	Builder_Vertices = (struct VertexTextured*)Gfx_RecreateAndLockVb(&info->vb,
-													VERTEX_FORMAT_TEXTURED, totalVerts + 1);
+	Builder_Vertices = (struct VertexTextured*)MapRenderer_LockChunkVb(info, totalVerts + 1);
 #else
 	/* NOTE: Relies on assumption vb is ignored by GL11 Gfx_LockVb implementation */
 	Builder_Vertices = (struct VertexTextured*)Gfx_LockVb(0, 
@@ -427,17 +690,21 @@ void Builder_MakeChunk(struct ChunkInfo* info) {
 	Builder_PostPrepareChunk();
 	/* now render the chunk */
 
-	for (y = y1, yy = 0; y < yMax; y++, yy++) {
-		for (z = z1, zz = 0; z < zMax; z++, zz++) {
-			cIndex = Builder_PackChunk(0, yy, zz);
+	if (info->lod) {
+		Lod_RenderChunk();
+	} else {
+		for (y = y1, yy = 0; y < yMax; y++, yy++) {
+			for (z = z1, zz = 0; z < zMax; z++, zz++) {
+				cIndex = Builder_PackChunk(0, yy, zz);
 
-			for (x = x1, xx = 0; x < xMax; x++, xx++, cIndex++) {
-				Builder_Block = chunk[cIndex];
-				if (Blocks.Draw[Builder_Block] == DRAW_GAS) continue;
+				for (x = x1, xx = 0; x < xMax; x++, xx++, cIndex++) {
+					Builder_Block = chunk[cIndex];
+					if (Blocks.Draw[Builder_Block] == DRAW_GAS) continue;
 
-				index = Builder_PackCount(xx, yy, zz);
-				Builder_ChunkIndex = cIndex;
-				Builder_RenderBlock(index, x, y, z);
+					index = Builder_PackCount(xx, yy, zz);
+					Builder_ChunkIndex = cIndex;
+					Builder_RenderBlock(index, x, y, z);
+				}
 			}
 		}
 	}
@@ -21,6 +21,9 @@ extern cc_bool Builder_SmoothLighting;
 
 /* Builds the mesh of vertices for the given chunk. */
 void Builder_MakeChunk(struct ChunkInfo* info);
+/* Calculates how many vertices the mesh of the chunk at the given coordinates has */
+/*  when built at the given level of detail. Only used for diagnostics. */
+int Builder_CountVertices(int x1, int y1, int z1, int lod);
 
 void Builder_ApplyActive(void);
 
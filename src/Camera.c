@@ -12,6 +12,7 @@
 #include "Options.h"
 #include "Picking.h"
 #include "Platform.h"
+#include "EnvRenderer.h"
 
 struct _CameraData Camera;
 static struct RayTracer cameraClipPos;
@@ -49,7 +50,9 @@ void Camera_KeyLookUpdate(float delta) {
 static void PerspectiveCamera_GetProjection(struct Matrix* proj) {
 	float fovy = Camera.Fov * MATH_DEG2RAD;
 	float aspectRatio = (float)Game.Width / (float)Game.Height;
-	Gfx_CalcPerspectiveMatrix(proj, fovy, aspectRatio, (float)Game_ViewDistance);
+	/* Far terrain is drawn past the view distance */
+	float zFar = (float)max(Game_ViewDistance, EnvRenderer_FarDistance);
+	Gfx_CalcPerspectiveMatrix(proj, fovy, aspectRatio, zFar);
 }
 
 static void PerspectiveCamera_GetView(struct Matrix* mat) {
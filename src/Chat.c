@@ -33,6 +33,10 @@ double Chat_SmallAnnouncementReceived;
 
 struct StringsBuffer Chat_Log, Chat_InputLog;
 cc_bool Chat_Logging;
+int Chat_LogTrimmed;
+/* Default maximum number of messages kept in Chat_Log */
+#define CHAT_DEF_SCROLLBACK 10000
+static int chat_maxLogLines = CHAT_DEF_SCROLLBACK;
 
 /*########################################################################################################################*
 *-------------------------------------------------------Chat logging------------------------------------------------------*
@@ -44,6 +48,27 @@ static void ClearChatLogs(void) {
 	StringsBuffer_Clear(&Chat_Log);
 }
 
+static void TrimChatLog(int count) {
+	/* Always remove a multiple of recent log times, so Chat_GetLogTime stays valid */
+	count = (count + CHATLOG_TIME_MASK) & ~CHATLOG_TIME_MASK;
+	count = min(count, Chat_Log.count);
+
+	StringsBuffer_RemoveFirst(&Chat_Log, count);
+	Chat_LogTrimmed += count;
+}
+
+int Chat_FindInLog(const cc_string* text, int index) {
+	cc_string msg;
+	if (index >= Chat_Log.count) index = Chat_Log.count - 1;
+
+	for (; index >= 0; index--)
+	{
+		StringsBuffer_UNSAFE_GetRaw(&Chat_Log, index, &msg);
+		if (String_CaselessContains(&msg, text)) return index;
+	}
+	return -1;
+}
+
 static char      logNameBuffer[STRING_SIZE];
 static cc_string logName = String_FromArray(logNameBuffer);
 static char      logPathBuffer[FILENAME_SIZE];
@@ -52,6 +77,141 @@ static cc_string logPath = String_FromArray(logPathBuffer);
 static struct Stream logStream;
 static int lastLogDay, lastLogMonth, lastLogYear;
 
+/* Size of each of the two buffers that chat log lines are queued up in */
+#define LOGWRITER_BUFFER_SIZE (16 * 1024)
+/* Maximum time that queued up lines wait for before being written to disc */
+#define LOGWRITER_FLUSH_INTERVAL 1000
+
+#ifndef CC_BUILD_COOPTHREADED
+static void* logThread;
+static void* logMutex;
+static void* logWaitable;
+/* Main thread queues lines into logBuffers[logCur], while background thread writes the other */
+static cc_uint8 logBuffers[2][LOGWRITER_BUFFER_SIZE];
+static int logLengths[2], logCur;
+static cc_result logWriteRes;
+static cc_bool logStopping;
+/* Number of lines not queued up, due to both buffers being full */
+static int logDropped;
+
+/* Writes out all lines queued up so far. Returns whether background thread should stop. */
+static cc_bool LogWriter_Flush(void) {
+	cc_bool stopping;
+	cc_result res;
+	int full, len;
+
+	Mutex_Lock(logMutex);
+	{
+		full     = logCur;
+		len      = logLengths[full];
+		stopping = logStopping;
+
+		/* Other buffer was completely written out in the previous flush */
+		logCur = full ^ 1;
+		logLengths[logCur] = 0;
+	}
+	Mutex_Unlock(logMutex);
+	if (!len) return stopping;
+
+	res = Stream_Write(&logStream, logBuffers[full], len);
+	if (!res) return stopping;
+
+	Mutex_Lock(logMutex);
+	{
+		logWriteRes = res;
+	}
+	Mutex_Unlock(logMutex);
+	return stopping;
+}
+
+static void LogWriter_Loop(void) {
+	for (;;) 
+	{
+		/* Lines are written out in batches, instead of one write per line */
+		Waitable_WaitFor(logWaitable, LOGWRITER_FLUSH_INTERVAL);
+		if (LogWriter_Flush()) return;
+	}
+}
+
+static cc_bool LogWriter_TryAppend(const cc_uint8* data, int len, cc_result* res) {
+	cc_bool appended;
+	int used;
+
+	Mutex_Lock(logMutex);
+	{
+		used     = logLengths[logCur];
+		appended = used + len <= LOGWRITER_BUFFER_SIZE;
+		*res     = logWriteRes;
+
+		if (appended) {
+			Mem_Copy(logBuffers[logCur] + used, data, len);
+			logLengths[logCur] = used + len;
+		}
+	}
+	Mutex_Unlock(logMutex);
+
+	/* Wake up background thread early when buffer is filling up quickly */
+	if (appended && used + len >= LOGWRITER_BUFFER_SIZE / 2) Waitable_Signal(logWaitable);
+	return appended;
+}
+
+static void LogWriter_AppendDropped(void) {
+	cc_string str; char strBuffer[128];
+	cc_result res;
+
+	String_InitArray(str, strBuffer);
+	String_Format1(&str, "-- %i chat lines were not logged, as they arrived faster than could be written --" _NL, &logDropped);
+	if (!LogWriter_TryAppend((const cc_uint8*)str.buffer, str.length, &res)) return;
+
+	Platform_Log1("Chat logging fell behind and dropped %i lines", &logDropped);
+	logDropped = 0;
+}
+
+/* Queues up the given data to be written to the chat log file by the background thread */
+static cc_result LogWriter_Append(const cc_uint8* data, int len) {
+	cc_result res;
+	if (!logThread) {
+		logMutex    = Mutex_Create("Chat log queue");
+		logWaitable = Waitable_Create("Chat log wakeup");
+		Thread_Run(&logThread, LogWriter_Loop, 64 * 1024, "Chat logging");
+	}
+
+	if (logDropped) LogWriter_AppendDropped();
+	if (!LogWriter_TryAppend(data, len, &res)) logDropped++;
+	return res;
+}
+
+/* Writes out any lines still queued up, then stops the background thread */
+static void LogWriter_Stop(void) {
+	if (!logThread) return;
+
+	Mutex_Lock(logMutex);
+	{
+		logStopping = true;
+	}
+	Mutex_Unlock(logMutex);
+
+	Waitable_Signal(logWaitable);
+	Thread_Join(logThread);
+
+	if (logDropped) Platform_Log1("Chat logging fell behind and dropped %i lines", &logDropped);
+	Mutex_Free(logMutex);
+	Waitable_Free(logWaitable);
+
+	logThread   = NULL;
+	logStopping = false;
+	logWriteRes = 0;
+	logDropped  = 0;
+	logLengths[0] = 0; logLengths[1] = 0;
+}
+#else
+static cc_result LogWriter_Append(const cc_uint8* data, int len) {
+	/* No background threads, so just have to write on the main thread */
+	return Stream_Write(&logStream, data, len);
+}
+static void LogWriter_Stop(void) { }
+#endif
+
 /* Resets log name to empty and resets last log date */
 static void ResetLogFile(void) {
 	logName.length = 0;
@@ -61,6 +221,7 @@ static void ResetLogFile(void) {
 /* Closes handle to the chat log file */
 static void CloseLogFile(void) {
 	cc_result res;
+	LogWriter_Stop();
 	if (!logStream.meta.file) return;
 
 	res = logStream.Close(&logStream);
@@ -154,8 +315,11 @@ static void OpenChatLog(struct cc_datetime* now) {
 
 static void AppendChatLog(const cc_string* text) {
 	cc_string str; char strBuffer[DRAWER2D_MAX_TEXT_LENGTH];
+	cc_uint8 data[DRAWER2D_MAX_TEXT_LENGTH * 3 + 2]; /* space for UTF8 and newline */
 	struct cc_datetime now;
+	const char* nl;
 	cc_result res;	
+	int i, len;
 
 	if (!logName.length || !Chat_Logging) return;
 	DateTime_CurrentLocal(&now);
@@ -173,7 +337,13 @@ static void AppendChatLog(const cc_string* text) {
 	String_Format3(&str, "[%p2:%p2:%p2] ", &now.hour, &now.minute, &now.second);
 	Drawer2D_WithoutColors(&str, text);
 
-	res = Stream_WriteLine(&logStream, &str);
+	for (i = 0, len = 0; i < str.length; i++) 
+	{
+		len += Convert_CP437ToUtf8(str.buffer[i], data + len);
+	}
+	for (nl = _NL; *nl; ) { data[len++] = *nl++; }
+
+	res = LogWriter_Append(data, len);
 	if (!res) return;
 	Chat_DisableLogging();
 	Logger_SysWarn2(res, "writing to", &logPath);
@@ -205,14 +375,14 @@ void Chat_Add(const cc_string* text) { Chat_AddOf(text, MSG_TYPE_NORMAL); }
 void Chat_AddOf(const cc_string* text, int msgType) {
 	cc_string str;
 	if (msgType == MSG_TYPE_NORMAL) {
+		/* Oldest messages are removed in batches, so the cost is spread over many messages */
+		if (Chat_Log.count >= chat_maxLogLines) TrimChatLog(chat_maxLogLines / 4);
+
 		/* Check for chat overflow (see issue #837) */
 		/* This happens because Offset/Length are packed into a single 32 bit value, */
 		/*  with 9 bits used for length. Hence if offset exceeds 2^23 (8388608), it */
 		/*  overflows and earlier chat messages start wrongly appearing instead */
-		if (Chat_Log.totalLength > 8388000) {
-			ClearChatLogs();
-			Chat_AddRaw("&cChat log cleared as it hit 8.3 million character limit");
-		}
+		if (Chat_Log.totalLength > 8388000) TrimChatLog(Chat_Log.count / 2);
 
 		/* StringsBuffer_Add will abort game if try to add string > 511 characters */
 		str        = *text; 
@@ -278,6 +448,7 @@ static void OnInit(void) {
 #else
 	Chat_Logging = Options_GetBool(OPT_CHAT_LOGGING, true);
 #endif
+	chat_maxLogLines = Options_GetInt(OPT_CHAT_SCROLLBACK, 256, 1000000, CHAT_DEF_SCROLLBACK);
 }
 
 static void ClearCPEMessages(void) {
@@ -40,13 +40,20 @@ extern double Chat_SmallAnnouncementReceived;
 
 extern cc_string Chat_Status[5], Chat_BottomRight[3], Chat_ClientStatus[2];
 extern cc_string Chat_Announcement, Chat_BigAnnouncement, Chat_SmallAnnouncement;
-/* All chat messages received */
+/* Most recent chat messages received (up to scrollback limit) */
 extern struct StringsBuffer Chat_Log;
+/* Number of oldest messages removed from Chat_Log so far, to stay within scrollback limit */
+/* NOTE: Removed messages are still in the chat log file on disc, if chat logging is enabled */
+extern int Chat_LogTrimmed;
 /* All chat input entered by the user */
 extern struct StringsBuffer Chat_InputLog;
 /* Whether chat messages are logged to disc */
 extern cc_bool Chat_Logging;
 
+/* Returns index of most recent message in Chat_Log at or before the given index, */
+/*  which caselessly contains the given text. Returns -1 if no such message exists. */
+int Chat_FindInLog(const cc_string* text, int index);
+
 /* Sets the name of log file (no .txt, so e.g. just "singleplayer") */
 /* NOTE: This can only be set once. */
 void Chat_SetLogName(const cc_string* name);
@@ -17,6 +17,21 @@
 #include "TexturePack.h"
 #include "Options.h"
 #include "Drawer2D.h"
+#include "MapRenderer.h"
+#include "Particle.h"
+#include "ExtMath.h"
+#include "Picking.h"
+#include "Physics.h"
+#include "Platform.h"
+#include "Animations.h"
+#include "Bitmap.h"
+#include "Stream.h"
+#include "Deflate.h"
+#include "Errors.h"
+#include "Builder.h"
+#include "Camera.h"
+#include "LWeb.h"
+#include "SelectionBox.h"
 
 #define COMMANDS_PREFIX "/client"
 #define COMMANDS_PREFIX_SPACE "/client "
@@ -304,6 +319,825 @@ static struct ChatCommand MotdCommand = {
 	}
 };
 
+#define FIND_MAX_RESULTS 5
+/* All output starts with this, so that output from earlier searches isn't matched again */
+static const cc_string findPrefix = String_FromConst("&e/client find: ");
+
+static void FindCommand_Execute(const cc_string* args, int argsCount) {
+	int results[FIND_MAX_RESULTS];
+	int i, idx, ago, count = 0, matches = 0;
+	int total, trimmed;
+	cc_string msg; char msgBuffer[DRAWER2D_MAX_TEXT_LENGTH];
+	cc_string match;
+
+	if (!args->length) {
+		Chat_AddRaw("&e/client: &cNo text to search for given."); return;
+	}
+
+	/* Must search before adding any messages, as they would match too */
+	for (i = Chat_Log.count - 1; (i = Chat_FindInLog(args, i)) >= 0; i--)
+	{
+		match = StringsBuffer_UNSAFE_Get(&Chat_Log, i);
+		if (String_CaselessStarts(&match, &findPrefix)) continue;
+
+		if (count < FIND_MAX_RESULTS) results[count++] = i;
+		matches++;
+	}
+
+	total   = Chat_Log.count;
+	trimmed = Chat_LogTrimmed;
+	Chat_Add3("%s&f%i &emessages in chat history contain \"%s&e\"", &findPrefix, &matches, args);
+
+	/* Show most recent matches, oldest first */
+	for (i = count - 1; i >= 0; i--)
+	{
+		/* Adding messages may have removed oldest messages from chat history */
+		idx = results[i] - (Chat_LogTrimmed - trimmed);
+		if (idx < 0) continue;
+
+		String_InitArray(msg, msgBuffer);
+		ago   = total - results[i];
+		match = StringsBuffer_UNSAFE_Get(&Chat_Log, idx);
+
+		String_Format2(&msg, "%s&7(%i ago) &f", &findPrefix, &ago);
+		String_AppendString(&msg, &match);
+		Chat_Add(&msg);
+	}
+}
+
+static struct ChatCommand FindCommand = {
+	"Find", FindCommand_Execute,
+	COMMAND_FLAG_UNSPLIT_ARGS,
+	{
+		"&a/client find [text]",
+		"&eSearches chat history for messages containing the given text,",
+		"&eand displays the most recent of those messages.",
+	}
+};
+
+
+/*########################################################################################################################*
+*----------------------------------------------------Developer commands---------------------------------------------------*
+*#########################################################################################################################*/
+/* Statistics and benchmarks that are only useful when working on the client itself */
+/* Define CC_BUILD_DEVCOMMANDS when compiling to include these commands */
+#ifdef CC_BUILD_DEVCOMMANDS
+#ifndef CC_BUILD_GL11
+static void ChunkVbsCommand_Execute(const cc_string* args, int argsCount) {
+	int liveKB = (int)(ChunkVbArena.LiveVertices / 1024 * SIZEOF_VERTEX_TEXTURED);
+	int freeKB = (int)(ChunkVbArena.FreeVertices / 1024 * SIZEOF_VERTEX_TEXTURED);
+	int frag   = MapRenderer_ArenaFragmentation();
+
+	Chat_Add2("&eChunk vertex buffers: &f%i &ein use (%i KB)", &ChunkVbArena.LiveVbs, &liveKB);
+	Chat_Add2("&eFree vertex buffers: &f%i &e(%i KB)", &ChunkVbArena.FreeVbs, &freeKB);
+	Chat_Add3("&eCreated: &f%i&e, reused: &f%i&e, trimmed: &f%i", 
+		&ChunkVbArena.Created, &ChunkVbArena.Reused, &ChunkVbArena.Trimmed);
+	Chat_Add1("&eFragmentation: &f%i%%", &frag);
+}
+
+static struct ChatCommand ChunkVbsCommand = {
+	"ChunkVbs", ChunkVbsCommand_Execute,
+	COMMAND_FLAG_UNSPLIT_ARGS,
+	{
+		"&a/client chunkvbs",
+		"&eDisplays statistics about the vertex buffers used for chunks.",
+		"&eFragmentation is the percentage of allocated space not used by vertices."
+	}
+};
+#endif
+
+#define LOD_REPORT_DISTS 5
+/* Counting vertices is about as slow as building a chunk, so only count a sample of chunks */
+#define LOD_MAX_SAMPLES 1024
+static void LodCommand_Execute(const cc_string* args, int argsCount) {
+	int dists[LOD_REPORT_DISTS] = { 128, 256, 512, 1024 };
+	float full[LOD_REPORT_DISTS] = { 0 };
+	float lod[LOD_REPORT_DISTS]  = { 0 };
+	int x, y, z, i, dx, dy, dz, maxDist;
+	int distSqr, fullVerts, lodVerts, saved;
+	int chunkIndex = 0, step, fullTotal, lodTotal;
+	IVec3 pos;
+
+	if (!World.Loaded) {
+		Chat_AddRaw("&e/client: &cNo world loaded."); return;
+	}
+	/* A LOD distance of 0 means chunks are always built at full detail */
+	if (!MapRenderer_CalcLod(Int32_MaxValue)) {
+		Chat_AddRaw("&e/client: &cLower detail chunks are disabled, see gfx-loddistance option."); return;
+	}
+
+	dists[LOD_REPORT_DISTS - 1] = Game_ViewDistance;
+	maxDist = 0;
+	for (i = 0; i < LOD_REPORT_DISTS; i++) maxDist = max(maxDist, dists[i]);
+	step = (World.ChunksCount + LOD_MAX_SAMPLES - 1) / LOD_MAX_SAMPLES;
+	/* Distances are measured from centre of the chunk camera is in, like MapRenderer does */
+	IVec3_Floor(&pos, &Camera.CurrentPos);
+	pos.x = (pos.x & ~CHUNK_MASK) + HALF_CHUNK_SIZE;
+	pos.y = (pos.y & ~CHUNK_MASK) + HALF_CHUNK_SIZE;
+	pos.z = (pos.z & ~CHUNK_MASK) + HALF_CHUNK_SIZE;
+
+	for (y = 0; y < World.Height; y += CHUNK_SIZE) {
+		for (z = 0; z < World.Length; z += CHUNK_SIZE) {
+			for (x = 0; x < World.Width; x += CHUNK_SIZE) 
+			{
+				if ((chunkIndex++ % step) != 0) continue;
+				dx = x + HALF_CHUNK_SIZE - pos.x;
+				dy = y + HALF_CHUNK_SIZE - pos.y;
+				dz = z + HALF_CHUNK_SIZE - pos.z;
+				distSqr = dx * dx + dy * dy + dz * dz;
+				if (distSqr > maxDist * maxDist) continue;
+
+				fullVerts = Builder_CountVertices(x, y, z, 0);
+				i = MapRenderer_CalcLod(distSqr);
+				lodVerts  = i ? Builder_CountVertices(x, y, z, i) : fullVerts;
+
+				for (i = 0; i < LOD_REPORT_DISTS; i++) 
+				{
+					if (distSqr > dists[i] * dists[i]) continue;
+					full[i] += fullVerts;
+					lod[i]  += lodVerts;
+				}
+			}
+		}
+	}
+
+	for (i = 0; i < LOD_REPORT_DISTS; i++) 
+	{
+		/* Scale up the sampled counts to estimate counts for all chunks */
+		fullTotal = (int)(full[i] * step);
+		lodTotal  = (int)(lod[i]  * step);
+		saved = full[i] ? (int)(100 - lod[i] * 100 / full[i]) : 0;
+		Chat_Add4("&eView distance &f%i&e: &f%i &evertices, &f%i &ewith LOD (&f%i%% &esaved)", 
+			&dists[i], &fullTotal, &lodTotal, &saved);
+	}
+}
+
+static struct ChatCommand LodCommand = {
+	"Lod", LodCommand_Execute,
+	COMMAND_FLAG_UNSPLIT_ARGS,
+	{
+		"&a/client lod",
+		"&eDisplays how many vertices chunks within various view distances",
+		"&eneed at full detail, versus with lower detail for distant chunks.",
+		"&eOn large maps, the counts are estimated from a sample of chunks.",
+		"&eThe last line is for your current view distance.",
+	}
+};
+
+static void ParticlesCommand_Execute(const cc_string* args, int argsCount) {
+	static const cc_string stress = String_FromConst("stress");
+	Vec3 pos = Entities.CurPlayer->Base.Position;
+	RNGState rnd;
+	int i, count, max = Particles_MaxCount();
+	int simPerMs, drawPerMs;
+
+	if (argsCount && String_CaselessEquals(&args[0], &stress)) {
+		count = max;
+		if (argsCount > 1 && !Convert_ParseInt(&args[1], &count)) {
+			Chat_AddRaw("&e/client: &cParticles count must be an integer."); return;
+		}
+		Random_SeedFromCurrentTime(&rnd);
+
+		/* Rain effect spawns 2 particles at once */
+		for (i = 0; i < count; i += 2) {
+			Particles_RainSnowEffect(pos.x + Random_Float(&rnd) * 32 - 16, 
+				pos.y + 4 + Random_Float(&rnd) * 16, pos.z + Random_Float(&rnd) * 32 - 16);
+		}
+		Chat_Add1("&e/client: &fSpawned %i rain particles", &count);
+		return;
+	}
+
+	count     = Particles_Count();
+	simPerMs  = Particles_Stats.Simulated * 1000 / max(1, Particles_Stats.TickMicrosecs);
+	drawPerMs = Particles_Stats.Drawn     * 1000 / max(1, Particles_Stats.DrawMicrosecs);
+
+	Chat_Add2("&eActive particles: &f%i &e(max &f%i &eper type)", &count, &max);
+	Chat_Add3("&eLast tick: &f%i &esimulated in &f%i us &e(%i per ms)", 
+		&Particles_Stats.Simulated, &Particles_Stats.TickMicrosecs, &simPerMs);
+	Chat_Add3("&eLast frame: &f%i &edrawn in &f%i us &e(%i per ms)", 
+		&Particles_Stats.Drawn, &Particles_Stats.DrawMicrosecs, &drawPerMs);
+}
+
+static struct ChatCommand ParticlesCommand = {
+	"Particles", ParticlesCommand_Execute,
+	0,
+	{
+		"&a/client particles",
+		"&eDisplays how many particles were simulated and drawn per ms.",
+		"&a/client particles stress [count]",
+		"&eSpawns [count] rain particles around you, to stress test particles.",
+	}
+};
+
+static void AnimsCommand_Execute(const cc_string* args, int argsCount) {
+	int uploadedKB = Animations_Stats.UploadedBytes / 1024;
+
+	Chat_Add2("&eAnimated tiles changed: &f%i &eper second (&f%i &eskipped as unchanged)", 
+		&Animations_Stats.Tiles, &Animations_Stats.SkippedTiles);
+	Chat_Add2("&eTexture uploads: &f%i &eper second (&f%i KB&e)", 
+		&Animations_Stats.Uploads, &uploadedKB);
+}
+
+static struct ChatCommand AnimsCommand = {
+	"Anims", AnimsCommand_Execute,
+	COMMAND_FLAG_UNSPLIT_ARGS,
+	{
+		"&a/client anims",
+		"&eDisplays how many animated tiles were changed and uploaded",
+		"&eto the GPU over the last second.",
+	}
+};
+
+static void GuiStatsCommand_Execute(const cc_string* args, int argsCount) {
+	Chat_Add3("&e2D last frame: &f%i &edraw calls for &f%i &equads/ranges (&f%i &evertices)", 
+		&Gfx_2DStats.DrawCalls, &Gfx_2DStats.Requests, &Gfx_2DStats.Vertices);
+}
+
+static struct ChatCommand GuiStatsCommand = {
+	"GuiStats", GuiStatsCommand_Execute,
+	COMMAND_FLAG_UNSPLIT_ARGS,
+	{
+		"&a/client guistats",
+		"&eDisplays how many draw calls were used to draw the 2D GUI",
+		"&eover the last frame, after merging adjacent quads together.",
+	}
+};
+
+#define BENCH_ITERATIONS 10000
+static int Bench_PerSecond(cc_uint64 beg) {
+	cc_uint64 elapsed = Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+	return (int)((cc_uint64)BENCH_ITERATIONS * 1000000 / max(1, elapsed));
+}
+
+static void Bench_EntryList(void) {
+	cc_string key; char keyBuffer[STRING_SIZE];
+	static const cc_string value = String_FromConst("value");
+	struct EntryListIndex index;
+	struct StringsBuffer* list;
+	int i, inserts, sets, gets, scans;
+	cc_uint64 beg;
+
+	list = (struct StringsBuffer*)Mem_TryAllocCleared(1, sizeof(struct StringsBuffer));
+	if (!list) { Chat_AddRaw("&e/client: &cOut of memory."); return; }
+	EntryList_AddIndex(&index, list, '=');
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_ITERATIONS; i++) 
+	{
+		String_InitArray(key, keyBuffer);
+		String_Format1(&key, "key-%i", &i);
+		EntryList_Set(list, &key, &value, '=');
+	}
+	inserts = Bench_PerSecond(beg);
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_ITERATIONS; i++) 
+	{
+		String_InitArray(key, keyBuffer);
+		String_Format1(&key, "KEY-%i", &i);
+		EntryList_UNSAFE_Get(list, &key, '=');
+	}
+	gets = Bench_PerSecond(beg);
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_ITERATIONS; i++) 
+	{
+		String_InitArray(key, keyBuffer);
+		String_Format1(&key, "key-%i", &i);
+		EntryList_Set(list, &key, &value, '=');
+	}
+	sets = Bench_PerSecond(beg);
+
+	/* Same lookups again, but having to scan through every entry */
+	EntryList_RemoveIndex(&index);
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_ITERATIONS; i++) 
+	{
+		String_InitArray(key, keyBuffer);
+		String_Format1(&key, "KEY-%i", &i);
+		EntryList_UNSAFE_Get(list, &key, '=');
+	}
+	scans = Bench_PerSecond(beg);
+
+	StringsBuffer_Clear(list);
+	Mem_Free(list);
+
+	i = BENCH_ITERATIONS;
+	Chat_Add1("&eEntry list with &f%i &eentries:", &i);
+	Chat_Add2("&e  Inserts: &f%i&e, replacing sets: &f%i &eper second", &inserts, &sets);
+	Chat_Add2("&e  Lookups: &f%i &eper second (&f%i &ewithout index)", &gets, &scans);
+}
+
+static int png_images, png_failed;
+static cc_uint64 png_bytes, png_micros;
+
+static cc_bool Bench_SelectPng(const cc_string* path) {
+	static const cc_string png = String_FromConst(".png");
+	return String_CaselessEnds(path, &png);
+}
+
+static cc_result Bench_DecodePng(const cc_string* path, struct Stream* data, struct ZipEntry* entry) {
+	cc_uint32 size = entry->UncompressedSize;
+	struct Stream stream;
+	struct Bitmap bmp;
+	cc_uint8* buffer;
+	cc_uint64 beg;
+	cc_result res;
+
+	buffer = (cc_uint8*)Mem_TryAlloc(max(1, size), 1);
+	if (!buffer) return ERR_OUT_OF_MEMORY;
+	res = Stream_Read(data, buffer, size);
+
+	/* Only time decoding, not decompressing the entry from the .zip */
+	if (!res) {
+		Stream_ReadonlyMemory(&stream, buffer, size);
+		beg = Stopwatch_Measure();
+		res = Png_Decode(&bmp, &stream);
+		png_micros += Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+
+		if (res) { png_failed++; } 
+		else { png_images++; png_bytes += (cc_uint64)bmp.width * bmp.height * 4; }
+		Mem_Free(bmp.scan0);
+	}
+
+	Mem_Free(buffer);
+	return res == ERR_OUT_OF_MEMORY ? res : 0;
+}
+
+static void Bench_DecodePack(const cc_string* path, void* obj, int isDirectory) {
+	static const cc_string zip = String_FromConst(".zip");
+	static struct ZipEntry entries[512];
+	struct Stream stream;
+	cc_result res;
+
+	if (isDirectory) {
+		Directory_Enum(path, obj, Bench_DecodePack);
+		return;
+	}
+	if (!String_CaselessEnds(path, &zip)) return;
+
+	res = Stream_OpenFile(&stream, path);
+	if (res) { Logger_SysWarn2(res, "opening", path); return; }
+
+	res = Zip_Extract(&stream, Bench_SelectPng, Bench_DecodePng, entries, Array_Elems(entries));
+	if (res) Logger_SysWarn2(res, "extracting", path);
+	(void)stream.Close(&stream);
+}
+
+static void Bench_Png(void) {
+	static const cc_string path = String_FromConst("texpacks");
+	int mb, ms, mbPerSec;
+	png_images = 0; png_failed = 0;
+	png_bytes  = 0; png_micros = 0;
+
+	Directory_Enum(&path, NULL, Bench_DecodePack);
+	if (!png_images) {
+		Chat_AddRaw("&e/client: &cNo .png images found in .zip files in texpacks folder."); return;
+	}
+
+	mb = (int)(png_bytes  / (1024 * 1024));
+	ms = (int)(png_micros / 1000);
+	/* bytes per microsecond is the same as megabytes per second */
+	mbPerSec = (int)(png_bytes / max(1, png_micros));
+
+	Chat_Add3("&eDecoded &f%i &eimages (%i MB of pixels) in &f%i ms", &png_images, &mb, &ms);
+	Chat_Add2("&eThroughput: &f%i MB/s &e(%i images failed to decode)", &mbPerSec, &png_failed);
+}
+
+#ifndef CC_BUILD_WEB
+#define BENCH_JSON_CHUNK_SIZE 4096
+static int json_servers;
+
+static void Bench_CountServer(struct JsonContext* ctx) {
+	/* Servers list is in the form of { "servers" : [ { server1 }, { server2 }, ... ] } */
+	if (ctx->depth == 3) json_servers++;
+}
+
+static cc_uint64 Bench_ParseJson(char* data, cc_uint32 size, int chunkSize, cc_bool* success) {
+	struct JsonContext ctx;
+	cc_uint64 beg;
+	cc_uint32 i;
+	int len;
+
+	beg = Stopwatch_Measure();
+	Json_Init(&ctx, data, size);
+	ctx.OnNewObject = Bench_CountServer;
+	json_servers    = 0;
+
+	for (i = 0; i < size; i += len)
+	{
+		len = (int)min(size - i, (cc_uint32)chunkSize);
+		Json_Feed(&ctx, data + i, len);
+	}
+	*success = Json_Finish(&ctx);
+	return Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+}
+
+static void Bench_Json(const cc_string* args, int argsCount) {
+	static const cc_string defPath = String_FromConst("servers.json");
+	const cc_string* path = argsCount > 1 ? &args[1] : &defPath;
+	cc_uint64 wholeMicros, chunkMicros;
+	cc_bool wholeValid, chunkValid;
+	int kb, wholeRate, chunkRate;
+	struct Stream stream;
+	cc_uint32 size = 0;
+	char* data = NULL;
+	cc_result res;
+
+	res = Stream_OpenFile(&stream, path);
+	if (res) { Logger_SysWarn2(res, "opening", path); return; }
+
+	res = stream.Length(&stream, &size);
+	if (!res) {
+		data = (char*)Mem_TryAlloc(max(1, size), 1);
+		res  = data ? Stream_Read(&stream, (cc_uint8*)data, size) : ERR_OUT_OF_MEMORY;
+	}
+	(void)stream.Close(&stream);
+	if (res) { Logger_SysWarn2(res, "reading", path); Mem_Free(data); return; }
+
+	wholeMicros = Bench_ParseJson(data, size, size, &wholeValid);
+	chunkMicros = Bench_ParseJson(data, size, BENCH_JSON_CHUNK_SIZE, &chunkValid);
+	Mem_Free(data);
+
+	kb = (int)(size / 1024);
+	/* bytes per microsecond is the same as megabytes per second */
+	wholeRate = (int)(size / max(1, wholeMicros));
+	chunkRate = (int)(size / max(1, chunkMicros));
+
+	Chat_Add2("&eParsed &f%i KB &eof JSON with &f%i &eservers", &kb, &json_servers);
+	Chat_Add2("&eThroughput: &f%i MB/s &ewhole, &f%i MB/s &ein 4 KB chunks", &wholeRate, &chunkRate);
+	if (!wholeValid || !chunkValid) Chat_AddRaw("&cJSON was not valid");
+}
+#endif
+
+#define BENCH_2D_SIZE   512
+#define BENCH_2D_ROUNDS 20
+static int bench2D_mismatches;
+
+/* Straightforward one pixel at a time versions of the 2D drawing primitives, */
+/*  which the optimised versions in Drawer2D.c must produce identical output to */
+static void Bench_ClearScalar(struct Context2D* ctx, BitmapCol color, int x, int y, int width, int height) {
+	int xx, yy;
+	if (!Drawer2D_Clamp(ctx, &x, &y, &width, &height)) return;
+
+	for (yy = 0; yy < height; yy++)
+		for (xx = 0; xx < width; xx++) 
+		{
+			Bitmap_GetPixel(&ctx->bmp, x + xx, y + yy) = color;
+		}
+}
+
+static void Bench_CopyScalar(struct Context2D* ctx, int x, int y, struct Bitmap* src) {
+	int xx, yy, width = src->width, height = src->height;
+	if (!Drawer2D_Clamp(ctx, &x, &y, &width, &height)) return;
+
+	for (yy = 0; yy < height; yy++)
+		for (xx = 0; xx < width; xx++) 
+		{
+			Bitmap_GetPixel(&ctx->bmp, x + xx, y + yy) = Bitmap_GetPixel(src, xx, yy);
+		}
+}
+
+static void Bench_BlendScalar(struct Context2D* ctx, BitmapCol color, int blend) {
+	int R, G, B, xx, yy, inv = 255 - blend;
+	BitmapCol* dst;
+
+	for (yy = 0; yy < ctx->height; yy++)
+		for (xx = 0; xx < ctx->width; xx++) 
+		{
+			dst = &Bitmap_GetPixel(&ctx->bmp, xx, yy);
+			R = BitmapCol_R(color) * blend / 255 + BitmapCol_R(*dst) * inv / 255;
+			G = BitmapCol_G(color) * blend / 255 + BitmapCol_G(*dst) * inv / 255;
+			B = BitmapCol_B(color) * blend / 255 + BitmapCol_B(*dst) * inv / 255;
+			*dst = BitmapColor_RGB(R, G, B);
+		}
+}
+
+static BitmapCol Bench_RandomColor(RNGState* rnd) {
+	return BitmapCol_Make(Random_Next(rnd, 256), Random_Next(rnd, 256),
+						  Random_Next(rnd, 256), Random_Next(rnd, 256));
+}
+
+static void Bench_RandomPixels(struct Bitmap* bmp, RNGState* rnd) {
+	int i;
+	for (i = 0; i < bmp->width * bmp->height; i++) 
+	{
+		bmp->scan0[i] = Bench_RandomColor(rnd);
+	}
+}
+
+static void Bench_Compare2D(struct Context2D* a, struct Context2D* b) {
+	cc_uint32 size = (cc_uint32)a->bmp.width * a->bmp.height * BITMAPCOLOR_SIZE;
+	if (!Mem_Equal(a->bmp.scan0, b->bmp.scan0, size)) bench2D_mismatches++;
+	Mem_Copy(b->bmp.scan0, a->bmp.scan0, size);
+}
+
+/* Checks optimised and scalar primitives give the same output for random inputs */
+static void Bench_Check2D(struct Context2D* fast, struct Context2D* ref, struct Bitmap* src, RNGState* rnd) {
+	cc_uint32 size = (cc_uint32)ref->bmp.width * ref->bmp.height * BITMAPCOLOR_SIZE;
+	int i, x, y, w, h, blend;
+	BitmapCol color;
+
+	Bench_RandomPixels(&ref->bmp, rnd);
+	Mem_Copy(fast->bmp.scan0, ref->bmp.scan0, size);
+
+	for (i = 0; i < 256; i++) 
+	{
+		/* Rectangles partially or entirely outside the bitmap should be clipped */
+		x = Random_Range(rnd, -BENCH_2D_SIZE / 2, BENCH_2D_SIZE);
+		y = Random_Range(rnd, -BENCH_2D_SIZE / 2, BENCH_2D_SIZE);
+		w = Random_Next(rnd, BENCH_2D_SIZE);
+		h = Random_Next(rnd, BENCH_2D_SIZE);
+		color = Bench_RandomColor(rnd);
+
+		Context2D_Clear(fast, color, x, y, w, h);
+		Bench_ClearScalar(ref, color, x, y, w, h);
+		Bench_Compare2D(ref, fast);
+
+		Context2D_DrawPixels(fast, x, y, src);
+		Bench_CopyScalar(ref, x, y, src);
+		Bench_Compare2D(ref, fast);
+
+		/* Also covers the 0 and 255 edge cases */
+		blend = i < 256 - 2 ? Random_Next(rnd, 256) : (i & 1) * 255;
+		Gradient_Blend(fast, color, blend, 0, 0, BENCH_2D_SIZE, BENCH_2D_SIZE);
+		Bench_BlendScalar(ref, color, blend);
+		Bench_Compare2D(ref, fast);
+	}
+}
+
+/* Pixels per microsecond is the same as megapixels per second */
+static int Bench_MPixels(cc_uint64 beg) {
+	cc_uint64 elapsed = Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+	return (int)((cc_uint64)BENCH_2D_SIZE * BENCH_2D_SIZE * BENCH_2D_ROUNDS / max(1, elapsed));
+}
+
+static void Bench_2D(void) {
+	int i, clearFast, clearRef, copyFast, copyRef, blendFast, blendRef;
+	struct Context2D fast, ref, src;
+	cc_uint64 beg;
+	RNGState rnd;
+
+	Context2D_Alloc(&fast, BENCH_2D_SIZE, BENCH_2D_SIZE);
+	Context2D_Alloc(&ref,  BENCH_2D_SIZE, BENCH_2D_SIZE);
+	Context2D_Alloc(&src,  BENCH_2D_SIZE / 2, BENCH_2D_SIZE / 2);
+
+	Random_Seed(&rnd, 1234);
+	Bench_RandomPixels(&src.bmp, &rnd);
+	bench2D_mismatches = 0;
+	Bench_Check2D(&fast, &ref, &src.bmp, &rnd);
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_2D_ROUNDS; i++) Context2D_Clear(&fast, BITMAPCOLOR_WHITE, 0, 0, BENCH_2D_SIZE, BENCH_2D_SIZE);
+	clearFast = Bench_MPixels(beg);
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_2D_ROUNDS; i++) Bench_ClearScalar(&ref, BITMAPCOLOR_WHITE, 0, 0, BENCH_2D_SIZE, BENCH_2D_SIZE);
+	clearRef = Bench_MPixels(beg);
+
+	/* src is a quarter of the size, so draw 4 times to cover the same number of pixels */
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_2D_ROUNDS * 4; i++) Context2D_DrawPixels(&fast, 0, 0, &src.bmp);
+	copyFast = Bench_MPixels(beg);
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_2D_ROUNDS * 4; i++) Bench_CopyScalar(&ref, 0, 0, &src.bmp);
+	copyRef = Bench_MPixels(beg);
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_2D_ROUNDS; i++) Gradient_Blend(&fast, BITMAPCOLOR_BLACK, 100, 0, 0, BENCH_2D_SIZE, BENCH_2D_SIZE);
+	blendFast = Bench_MPixels(beg);
+
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_2D_ROUNDS; i++) Bench_BlendScalar(&ref, BITMAPCOLOR_BLACK, 100);
+	blendRef = Bench_MPixels(beg);
+
+	Context2D_Free(&fast);
+	Context2D_Free(&ref);
+	Context2D_Free(&src);
+
+	Chat_AddRaw("&e2D drawing throughput in megapixels per second (vs per pixel loop):");
+	Chat_Add4("&e  Clear: &f%i &e(%i), copy: &f%i &e(%i)", &clearFast, &clearRef, &copyFast, &copyRef);
+	Chat_Add2("&e  Blend: &f%i &e(%i)", &blendFast, &blendRef);
+
+	if (bench2D_mismatches) {
+		Chat_Add1("&c%i outputs differed from the per pixel loops", &bench2D_mismatches);
+	} else {
+		Chat_AddRaw("&aAll outputs identical to the per pixel loops");
+	}
+}
+
+#define BENCH_CUBOID_SIZE 64
+/* Replays the bulk block updates that a server sends for a /cuboid, */
+/*  either as 256 block batches or as one block at a time. Returns elapsed microseconds. */
+static int Bench_ReplayCuboid(const IVec3* p1, const IVec3* p2, const BlockID* src, BlockID fill, cc_bool batched) {
+	cc_int32 indices[256];
+	BlockID blocks[256];
+	int x, y, z, i = 0, count = 0;
+	cc_uint64 beg = Stopwatch_Measure();
+	BlockID block;
+
+	for (y = p1->y; y <= p2->y; y++)
+		for (z = p1->z; z <= p2->z; z++)
+			for (x = p1->x; x <= p2->x; x++)
+			{
+				block = src ? src[i++] : fill;
+
+				if (!batched) {
+					/* Unchanged blocks are skipped by Game_UpdateBlocks too */
+					if (World_GetBlock(x, y, z) != block) Game_UpdateBlock(x, y, z, block);
+					continue;
+				}
+
+				indices[count] = World_Pack(x, y, z);
+				blocks[count]  = block;
+				if (++count < 256) continue;
+
+				Game_UpdateBlocks(indices, blocks, count);
+				count = 0;
+			}
+
+	if (count) Game_UpdateBlocks(indices, blocks, count);
+	return (int)Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+}
+
+/* Fills a cuboid around the player with stone and then restores it, */
+/*  comparing batched block updates against updating one block at a time */
+static void Bench_Blocks(void) {
+	int batchFill, batchRestore, singleFill, singleRestore;
+	int x, y, z, i = 0, volume;
+	IVec3 pos, p1, p2;
+	BlockID* saved;
+
+	if (!World.Loaded) {
+		Chat_AddRaw("&e/client: &cNo map is loaded."); return;
+	}
+	IVec3_Floor(&pos, &Entities.CurPlayer->Base.Position);
+
+	p1.x = max(0, min(pos.x - BENCH_CUBOID_SIZE / 2, World.Width  - BENCH_CUBOID_SIZE));
+	p1.y = max(0, min(pos.y - BENCH_CUBOID_SIZE / 2, World.Height - BENCH_CUBOID_SIZE));
+	p1.z = max(0, min(pos.z - BENCH_CUBOID_SIZE / 2, World.Length - BENCH_CUBOID_SIZE));
+	p2.x = min(World.MaxX, p1.x + BENCH_CUBOID_SIZE - 1);
+	p2.y = min(World.MaxY, p1.y + BENCH_CUBOID_SIZE - 1);
+	p2.z = min(World.MaxZ, p1.z + BENCH_CUBOID_SIZE - 1);
+
+	volume = (p2.x - p1.x + 1) * (p2.y - p1.y + 1) * (p2.z - p1.z + 1);
+	saved  = (BlockID*)Mem_TryAlloc(volume, sizeof(BlockID));
+	if (!saved) { Chat_AddRaw("&e/client: &cOut of memory."); return; }
+
+	for (y = p1.y; y <= p2.y; y++)
+		for (z = p1.z; z <= p2.z; z++)
+			for (x = p1.x; x <= p2.x; x++)
+			{
+				saved[i++] = World_GetBlock(x, y, z);
+			}
+
+	batchFill     = Bench_ReplayCuboid(&p1, &p2, NULL,  BLOCK_STONE, true);
+	batchRestore  = Bench_ReplayCuboid(&p1, &p2, saved, BLOCK_AIR,   true);
+	singleFill    = Bench_ReplayCuboid(&p1, &p2, NULL,  BLOCK_STONE, false);
+	singleRestore = Bench_ReplayCuboid(&p1, &p2, saved, BLOCK_AIR,   false);
+	Mem_Free(saved);
+
+	Chat_Add1("&eReplayed filling and then restoring &f%i &eblocks (microseconds):", &volume);
+	Chat_Add2("&e  Batched: &f%i &efill, &f%i &erestore", &batchFill,  &batchRestore);
+	Chat_Add2("&e  Per block: &f%i &efill, &f%i &erestore", &singleFill, &singleRestore);
+}
+
+#ifdef CC_BUILD_NETWORKING
+static cc_bool bench_selections;
+static struct _SelectionsStats bench_selStats;
+
+/* Toggles showing the maximum 256 selection boxes around the player, */
+/*  then reports how often they had to be sorted and rebuilt while shown */
+static void Bench_Selections(void) {
+	int i, micros, frames, sorts, rebuilds;
+	IVec3 pos, p1, p2;
+	PackedCol color;
+	cc_uint64 beg;
+	RNGState rnd;
+
+	if (bench_selections) {
+		for (i = 0; i < 256; i++) Selections_Remove((cc_uint8)i);
+		bench_selections = false;
+
+		frames   = Selections_Stats.Frames   - bench_selStats.Frames;
+		sorts    = Selections_Stats.Sorts    - bench_selStats.Sorts;
+		rebuilds = Selections_Stats.Rebuilds - bench_selStats.Rebuilds;
+		Chat_Add3("&eOver &f%i &eframes, selections were sorted &f%i &etimes and rebuilt &f%i &etimes", 
+			&frames, &sorts, &rebuilds);
+		return;
+	}
+
+	/* Benchmark uses all 256 IDs, so would overwrite and then remove the server's boxes */
+	if (Selections_Count()) {
+		Chat_AddRaw("&cCan't benchmark while the server is showing selection boxes");
+		return;
+	}
+
+	IVec3_Floor(&pos, &Entities.CurPlayer->Base.Position);
+	Random_Seed(&rnd, 1234);
+	beg = Stopwatch_Measure();
+
+	/* Mix of boxes inside other boxes, intersecting boxes and separate boxes */
+	for (i = 0; i < 256; i++) 
+	{
+		p1.x = pos.x + Random_Range(&rnd, -32, 32); p2.x = p1.x + Random_Range(&rnd, 1, 16);
+		p1.y = pos.y + Random_Range(&rnd, -8,   8); p2.y = p1.y + Random_Range(&rnd, 1, 16);
+		p1.z = pos.z + Random_Range(&rnd, -32, 32); p2.z = p1.z + Random_Range(&rnd, 1, 16);
+
+		color = PackedCol_Make(Random_Next(&rnd, 256), Random_Next(&rnd, 256), 
+							Random_Next(&rnd, 256), Random_Range(&rnd, 32, 160));
+		Selections_Add((cc_uint8)i, &p1, &p2, color);
+	}
+
+	micros = (int)Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
+	bench_selStats   = Selections_Stats;
+	bench_selections = true;
+	Chat_Add1("&eAdded 256 selection boxes in &f%i &emicroseconds", &micros);
+	Chat_AddRaw("&eMove around, then run this command again to remove them");
+}
+#endif
+
+static void BenchCommand_Execute(const cc_string* args, int argsCount) {
+	struct Entity* e = &Entities.CurPlayer->Base;
+	Vec3 origin = Entity_GetEyePosition(e);
+	Vec3 oldVel = e->Velocity, dir;
+	struct AABB entityBB, extentBB;
+	struct RayTracer t;
+	int i, reach = 64, speed = 16;
+	int picks, sweeps;
+	cc_uint64 beg;
+	RNGState rnd;
+
+	if (argsCount > 0 && String_CaselessEqualsConst(&args[0], "options")) {
+		Bench_EntryList(); return;
+	}
+	if (argsCount > 0 && String_CaselessEqualsConst(&args[0], "png")) {
+		Bench_Png(); return;
+	}
+	if (argsCount > 0 && String_CaselessEqualsConst(&args[0], "2d")) {
+		Bench_2D(); return;
+	}
+	if (argsCount > 0 && String_CaselessEqualsConst(&args[0], "blocks")) {
+		Bench_Blocks(); return;
+	}
+#ifdef CC_BUILD_NETWORKING
+	if (argsCount > 0 && String_CaselessEqualsConst(&args[0], "selections")) {
+		Bench_Selections(); return;
+	}
+#endif
+#ifndef CC_BUILD_WEB
+	if (argsCount > 0 && String_CaselessEqualsConst(&args[0], "json")) {
+		Bench_Json(args, argsCount); return;
+	}
+#endif
+	if (argsCount > 0 && !Convert_ParseInt(&args[0], &reach)) {
+		Chat_AddRaw("&e/client: &cReach must be an integer."); return;
+	}
+	if (argsCount > 1 && !Convert_ParseInt(&args[1], &speed)) {
+		Chat_AddRaw("&e/client: &cSpeed must be an integer."); return;
+	}
+	/* Limit speed, as number of blocks searched grows with the cube of speed */
+	reach = max(1, min(reach, 1024));
+	speed = max(0, min(speed, 32));
+
+	Random_Seed(&rnd, 1234);
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_ITERATIONS; i++) 
+	{
+		dir = Vec3_GetDirVector(Random_Float(&rnd) * 2 * MATH_PI, (Random_Float(&rnd) - 0.5f) * MATH_PI);
+		Picking_CalcPickedBlock(&origin, &dir, (float)reach, &t);
+	}
+	picks = Bench_PerSecond(beg);
+
+	Random_Seed(&rnd, 1234);
+	beg = Stopwatch_Measure();
+	for (i = 0; i < BENCH_ITERATIONS; i++) 
+	{
+		dir = Vec3_GetDirVector(Random_Float(&rnd) * 2 * MATH_PI, (Random_Float(&rnd) - 0.5f) * MATH_PI);
+		Vec3_Mul1(&e->Velocity, &dir, (float)speed);
+		Searcher_FindReachableBlocks(e, &entityBB, &extentBB);
+	}
+	sweeps = Bench_PerSecond(beg);
+	e->Velocity = oldVel;
+
+	Chat_Add2("&eBlock picks: &f%i &eper second (reach %i)", &picks, &reach);
+	Chat_Add2("&eCollision searches: &f%i &eper second (speed %i)", &sweeps, &speed);
+}
+
+static struct ChatCommand BenchCommand = {
+	"Bench", BenchCommand_Execute,
+	0,
+	{
+		"&a/client bench [reach] [speed] &e- Measures block picks and collision searches.",
+		"&a/client bench blocks &e- Replays bulk block updates of a cuboid around you.",
+		"&a/client bench options/png &e- Measures an indexed entry list, or decoding texpacks/*.zip .pngs.",
+		"&a/client bench 2d &e- Checks and measures clearing, copying and blending 2D pixels.",
+		"&a/client bench json [file] &e- Parses servers.json. &a/client bench selections &e- Toggles 256 boxes.",
+	}
+};
+#endif
+
 /*#######################################################################################################################*
 *-------------------------------------------------------PlaceCommand-----------------------------------------------------*
 *########################################################################################################################*/
@@ -805,10 +1639,21 @@ static void OnInit(void) {
 	Commands_Register(&TeleportCommand);
 	Commands_Register(&ClearDeniedCommand);
 	Commands_Register(&MotdCommand);
+	Commands_Register(&FindCommand);
 	Commands_Register(&PlaceCommand);
 	Commands_Register(&BlockEditCommand);
 	Commands_Register(&CuboidCommand);
 	Commands_Register(&ReplaceCommand);
+#ifdef CC_BUILD_DEVCOMMANDS
+#ifndef CC_BUILD_GL11
+	Commands_Register(&ChunkVbsCommand);
+#endif
+	Commands_Register(&LodCommand);
+	Commands_Register(&ParticlesCommand);
+	Commands_Register(&AnimsCommand);
+	Commands_Register(&GuiStatsCommand);
+	Commands_Register(&BenchCommand);
+#endif
 }
 
 static void OnFree(void) {
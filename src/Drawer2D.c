@@ -147,6 +147,19 @@ cc_bool Drawer2D_Clamp(struct Context2D* ctx, int* x, int* y, int* width, int* h
 }
 #define Drawer2D_ClampPixel(p) p = (p < 0 ? 0 : (p > 255 ? 255 : p))
 
+/* Fills the first row, then copies that row into the remaining rows */
+/*  (memcpy is much faster than setting one pixel at a time on most platforms) */
+static void Drawer2D_FillRows(struct Bitmap* bmp, int x, int y, int width, int height, BitmapCol color) {
+	BitmapCol* first = Bitmap_GetRow(bmp, y) + x;
+	int xx, yy;
+
+	for (xx = 0; xx < width; xx++) { first[xx] = color; }
+
+	for (yy = 1; yy < height; yy++) {
+		Mem_Copy(Bitmap_GetRow(bmp, y + yy) + x, first, width * BITMAPCOLOR_SIZE);
+	}
+}
+
 void Context2D_Alloc(struct Context2D* ctx, int width, int height) {
 	ctx->width  = width;
 	ctx->height = height;
@@ -216,22 +229,20 @@ void Gradient_Noise(struct Context2D* ctx, BitmapCol color, int variation,
 void Gradient_Vertical(struct Context2D* ctx, BitmapCol a, BitmapCol b,
 					   int x, int y, int width, int height) {
 	struct Bitmap* bmp = (struct Bitmap*)ctx;
-	BitmapCol* row, color;
-	int xx, yy;
+	BitmapCol color;
+	int yy;
 	float t;
 	if (!Drawer2D_Clamp(ctx, &x, &y, &width, &height)) return;
 
 	for (yy = 0; yy < height; yy++) {
-		row = Bitmap_GetRow(bmp, y + yy) + x;
-		t   = (float)yy / (height - 1); /* so last row has color of b */
+		t = (float)yy / (height - 1); /* so last row has color of b */
 
 		color = BitmapCol_Make(
 			Math_Lerp(BitmapCol_R(a), BitmapCol_R(b), t),
 			Math_Lerp(BitmapCol_G(a), BitmapCol_G(b), t),
 			Math_Lerp(BitmapCol_B(a), BitmapCol_B(b), t),
 			255);
-
-		for (xx = 0; xx < width; xx++) { row[xx] = color; }
+		Drawer2D_FillRows(bmp, x, y + yy, width, 1, color);
 	}
 }
 
@@ -239,7 +250,7 @@ void Gradient_Blend(struct Context2D* ctx, BitmapCol color, int blend,
 					int x, int y, int width, int height) {
 	struct Bitmap* bmp = (struct Bitmap*)ctx;
 	BitmapCol* dst;
-	int R, G, B, xx, yy;
+	int xx, yy;
 	if (!Drawer2D_Clamp(ctx, &x, &y, &width, &height)) return;
 
 	/* Pre compute the alpha blended source color */
@@ -251,11 +262,34 @@ void Gradient_Blend(struct Context2D* ctx, BitmapCol color, int blend,
 		0);
 	blend = 255 - blend; /* inverse for existing pixels */
 
+#ifndef BITMAP_16BPP
+	/* Blends two 8 bit channels at once, with each channel in a 16 bit lane */
+	/*  (channel * blend is at most 65025, so never overflows into the other lane) */
+	{
+		cc_uint32 lo = color & 0x00FF00FF, hi = (color >> 8) & 0x00FF00FF;
+		cc_uint32 a, b, src;
+
+		for (yy = 0; yy < height; yy++) {
+			dst = Bitmap_GetRow(bmp, y + yy) + x;
+
+			for (xx = 0; xx < width; xx++, dst++) {
+				src = *dst & ~BITMAPCOLOR_A_MASK;
+				a = ( src       & 0x00FF00FF) * blend;
+				b = ((src >> 8) & 0x00FF00FF) * blend;
+				/* (v + 1 + (v >> 8)) >> 8 is exactly v / 255 for v <= 65025 */
+				a = ((a + 0x00010001 + ((a >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+				b = ((b + 0x00010001 + ((b >> 8) & 0x00FF00FF)) >> 8) & 0x00FF00FF;
+
+				*dst = (a + lo) | ((b + hi) << 8) | BITMAPCOLOR_A_MASK;
+			}
+		}
+	}
+#else
 	for (yy = 0; yy < height; yy++) {
 		dst = Bitmap_GetRow(bmp, y + yy) + x;
 
 		for (xx = 0; xx < width; xx++, dst++) {
-			/* TODO: Not shift when multiplying */
+			int R, G, B;
 			R = BitmapCol_R(color) + (BitmapCol_R(*dst) * blend) / 255;
 			G = BitmapCol_G(color) + (BitmapCol_G(*dst) * blend) / 255;
 			B = BitmapCol_B(color) + (BitmapCol_B(*dst) * blend) / 255;
@@ -263,35 +297,24 @@ void Gradient_Blend(struct Context2D* ctx, BitmapCol color, int blend,
 			*dst = BitmapColor_RGB(R, G, B);
 		}
 	}
+#endif
 }
 
 void Context2D_DrawPixels(struct Context2D* ctx, int x, int y, struct Bitmap* src) {
 	struct Bitmap* dst = (struct Bitmap*)ctx;
 	int width = src->width, height = src->height;
-	BitmapCol* dstRow;
-	BitmapCol* srcRow;
-	int xx, yy;
+	int yy;
 	if (!Drawer2D_Clamp(ctx, &x, &y, &width, &height)) return;
 
 	for (yy = 0; yy < height; yy++) {
-		srcRow = Bitmap_GetRow(src, yy);
-		dstRow = Bitmap_GetRow(dst, y + yy) + x;
-
-		for (xx = 0; xx < width; xx++) { dstRow[xx] = srcRow[xx]; }
+		Mem_Copy(Bitmap_GetRow(dst, y + yy) + x, Bitmap_GetRow(src, yy), width * BITMAPCOLOR_SIZE);
 	}
 }
 
 void Context2D_Clear(struct Context2D* ctx, BitmapCol color,
 					int x, int y, int width, int height) {
-	struct Bitmap* bmp = (struct Bitmap*)ctx;
-	BitmapCol* row;
-	int xx, yy;
 	if (!Drawer2D_Clamp(ctx, &x, &y, &width, &height)) return;
-
-	for (yy = 0; yy < height; yy++) {
-		row = Bitmap_GetRow(bmp, y + yy) + x;
-		for (xx = 0; xx < width; xx++) { row[xx] = color; }
-	}
+	Drawer2D_FillRows((struct Bitmap*)ctx, x, y, width, height, color);
 }
 
 
@@ -425,18 +448,13 @@ void Drawer2D_ReducePadding_Height(int* height, int point, int scale) {
 }
 
 void Drawer2D_Fill(struct Bitmap* bmp, int x, int y, int width, int height, BitmapCol color) {
-	BitmapCol* row;
-	int xx, yy;
-
-	for (yy = y; yy < y + height; yy++) {
-		if (yy >= bmp->height) return;
-		row = Bitmap_GetRow(bmp, yy);
+	if (x < 0) { width  += x; x = 0; }
+	if (y < 0) { height += y; y = 0; }
+	width  = min(x + width,  bmp->width)  - x;
+	height = min(y + height, bmp->height) - y;
+	if (width <= 0 || height <= 0) return;
 
-		for (xx = x; xx < x + width; xx++) {
-			if (xx >= bmp->width) break;
-			row[xx] = color;
-		}
-	}
+	Drawer2D_FillRows(bmp, x, y, width, height, color);
 }
 
 static void DrawBitmappedTextCore(struct Bitmap* bmp, struct DrawTextArgs* args, int x, int y, cc_bool shadow) {
@@ -449,6 +467,7 @@ static void DrawBitmappedTextCore(struct Bitmap* bmp, struct DrawTextArgs* args,
 	int fontX, fontY;
 	int srcWidth, dstWidth;
 	int dstHeight, begX, xx, yy;
+	int stepX, fracX, remX;
 	int cellY, underlineY, underlineHeight;
 
 	BitmapCol* srcRow, src;
@@ -497,14 +516,27 @@ static void DrawBitmappedTextCore(struct Bitmap* bmp, struct DrawTextArgs* args,
 			dstWidth = dstWidths[i];
 			color    = colors[i];
 
+			/* Steps fontX by srcWidth / dstWidth, instead of dividing for every pixel */
+			/*  (dstWidth is 0 for empty characters, in which case nothing is drawn) */
+			fontX = srcX; remX = 0;
+			stepX = dstWidth ? srcWidth / dstWidth : 0;
+			fracX = dstWidth ? srcWidth % dstWidth : 0;
+
 			for (xx = 0; xx < dstWidth; xx++) {
-				fontX = srcX + xx * srcWidth / dstWidth;
-				src   = srcRow[fontX];
-				if (!BitmapCol_A(src)) continue;
+				src = srcRow[fontX];
+				fontX += stepX; remX += fracX;
+				if (remX >= dstWidth) { fontX++; remX -= dstWidth; }
 
+				if (!BitmapCol_A(src)) continue;
 				dstX = x + xx;
 				if ((unsigned)dstX >= (unsigned)bmp->width) continue;
 
+				/* Font pixels are almost always white, which leaves color unchanged */
+				if ((src & ~BITMAPCOLOR_A_MASK) == (BITMAPCOLOR_WHITE & ~BITMAPCOLOR_A_MASK)) {
+					dstRow[dstX] = (color & ~BITMAPCOLOR_A_MASK) | (src & BITMAPCOLOR_A_MASK);
+					continue;
+				}
+
 				/* TODO: Transparent text by multiplying by col.A */
 				/* TODO: Not shift when multiplying */
 				/* TODO: avoid BitmapCol_A shift */
@@ -648,7 +680,7 @@ static void DefaultPngProcess(struct Stream* stream, const cc_string* name) {
 	struct Bitmap bmp;
 	cc_result res;
 
-	if ((res = Png_Decode(&bmp, stream))) {
+	if ((res = TexturePack_DecodePng(&bmp, stream))) {
 		Logger_SysWarn2(res, "decoding", name);
 		Mem_Free(bmp.scan0);
 	} else if (Font_SetBitmapAtlas(&bmp)) {
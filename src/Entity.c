@@ -489,6 +489,7 @@ void Entities_Remove(int id) {
 	if (!e) return;
 
 	Event_RaiseInt(&EntityEvents.Removed, id);
+	Event_RaiseIntBatch(&EntityEvents.RemovedBatch, id);
 	e->VTABLE->Despawn(e);
 	Entities.List[id] = NULL;
 
@@ -557,12 +558,14 @@ void TabList_Remove(EntityID id) {
 	TabList.NameOffsets[id] = 0;
 	TabList.GroupRanks[id]  = 0;
 	Event_RaiseInt(&TabListEvents.Removed, id);
+	Event_RaiseIntBatch(&TabListEvents.RemovedBatch, id);
 }
 
 void TabList_Set(EntityID id, const cc_string* player_, const cc_string* list, const cc_string* group, cc_uint8 rank) {
 	cc_string oldPlayer, oldList, oldGroup;
 	cc_uint8 oldRank;
 	struct Event_Int* events;
+	struct Event_IntBatch* batch;
 
 	/* Player name shouldn't have colour codes */
 	/*  (intended for e.g. tab autocomplete) */
@@ -581,8 +584,10 @@ void TabList_Set(EntityID id, const cc_string* player_, const cc_string* list, c
 			&& String_Equals(group, &oldGroup) && rank == oldRank) return;
 
 		events = &TabListEvents.Changed;
+		batch  = &TabListEvents.ChangedBatch;
 	} else {
 		events = &TabListEvents.Added;
+		batch  = &TabListEvents.AddedBatch;
 	}
 	TabList_Delete(id);
 
@@ -593,6 +598,7 @@ void TabList_Set(EntityID id, const cc_string* player_, const cc_string* list, c
 	TabList.NameOffsets[id] = TabList._buffer.count;
 	TabList.GroupRanks[id]  = rank;
 	Event_RaiseInt(events, id);
+	Event_RaiseIntBatch(batch, id);
 }
 
 static void Tablist_Init(void) {
@@ -1141,6 +1147,7 @@ static void Entities_Init(void) {
 	}
 	Entities.CurPlayer = &LocalPlayer_Instances[0];
 	LocalPlayer_HookBinds();
+	Searcher_Init();
 }
 
 static void Entities_Free(void) {
@@ -1150,6 +1157,7 @@ static void Entities_Free(void) {
 		Entities_Remove(i);
 	}
 	sources_head = NULL;
+	Searcher_Free();
 }
 
 struct IGameComponent Entities_Component = {
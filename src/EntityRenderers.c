@@ -32,6 +32,26 @@ struct ShadowData { float y; BlockID block; cc_uint8 alpha; };
 /* Circle shadows may be split across (x,z), (x,z+1), (x+1,z), (x+1,z+1) */
 #define SHADOW_MAX_VERTS 4 * SHADOW_MAX_PER_COLUMN
 
+/* Shadows of all entities are batched together, to minimise the number of draw calls */
+#define SHADOW_BATCH_VERTS (16 * SHADOW_MAX_VERTS)
+static struct VertexTextured shadows_vertices[SHADOW_BATCH_VERTS];
+static struct VertexTextured* shadows_ptr;
+
+/* Blocks within a column that shadows may be drawn on top of. The block at the top of */
+/*  the column may or may not have a shadow drawn on it, depending on entity's exact Y. */
+#define SHADOW_MAX_CANDIDATES (SHADOW_MAX_RANGE + 1)
+struct ShadowColumn { int count; BlockID blocks[SHADOW_MAX_CANDIDATES]; int ys[SHADOW_MAX_CANDIDATES]; };
+
+/* Results of searching the columns underneath an entity are cached, */
+/*  until either the entity moves into another block or a block in those columns changes */
+struct ShadowCache {
+	int epoch, x1, z1, x2, z2, y;
+	struct ShadowColumn columns[4];
+};
+static struct ShadowCache shadows_cache[ENTITIES_MAX_COUNT];
+/* Incremented to invalidate all cached columns (e.g. when block properties change) */
+static int shadows_epoch = 1;
+
 static cc_bool lequal(float a, float b) { return a < b || Math_AbsF(a - b) < 0.001f; }
 static void EntityShadow_DrawCoords(struct VertexTextured** vertices, struct Entity* e, struct ShadowData* data, float x1, float z1, float x2, float z2) {
 	PackedCol col;
@@ -115,20 +135,16 @@ static void EntityShadow_CalcAlpha(float playerY, struct ShadowData* data) {
 	else data->y += 1.0f / 4.0f;
 }
 
-static cc_bool EntityShadow_GetBlocks(struct Entity* e, int x, int y, int z, struct ShadowData* data) {
-	struct ShadowData zeroData = { 0 };
-	struct ShadowData* cur;
-	float posY, topY;
-	cc_bool outside;
-	BlockID block; cc_uint8 draw;
-	int i;
+/* Whether the casted shadow stops at the given block, instead of continuing on further down */
+#define EntityShadow_StopsAt(block) (Blocks.MinBB[block].x == 0.0f && Blocks.MaxBB[block].x == 1.0f && \
+									Blocks.MinBB[block].z == 0.0f && Blocks.MaxBB[block].z == 1.0f)
 
-	for (i = 0; i < 4; i++) { data[i] = zeroData; }
-	cur     = data;
-	posY    = e->Position.y;
-	outside = !World_ContainsXZ(x, z);
+static void EntityShadow_ProbeColumn(int x, int y, int z, struct ShadowColumn* col) {
+	cc_bool outside = !World_ContainsXZ(x, z);
+	BlockID block; cc_uint8 draw;
+	int startY = y;
 
-	for (i = 0; y >= 0 && i < 4; y--) 
+	for (col->count = 0; y >= 0 && col->count < SHADOW_MAX_CANDIDATES; y--) 
 	{
 		if (!outside) {
 			block = World_GetBlock(x, y, z);
@@ -142,16 +158,38 @@ static cc_bool EntityShadow_GetBlocks(struct Entity* e, int x, int y, int z, str
 
 		draw = Blocks.Draw[block];
 		if (draw == DRAW_GAS || draw == DRAW_SPRITE || Blocks.IsLiquid[block]) continue;
-		topY = y + Blocks.MaxBB[block].y;
+
+		col->blocks[col->count] = block;
+		col->ys[col->count]     = y;
+		col->count++;
+
+		/* Block at the top of the column might be skipped, so must keep searching past it */
+		if (y != startY && EntityShadow_StopsAt(block)) return;
+	}
+}
+
+static cc_bool EntityShadow_GetBlocks(struct Entity* e, struct ShadowColumn* col, struct ShadowData* data) {
+	struct ShadowData zeroData = { 0 };
+	struct ShadowData* cur;
+	float posY, topY;
+	BlockID block;
+	int i, j;
+
+	for (i = 0; i < 4; i++) { data[i] = zeroData; }
+	cur  = data;
+	posY = e->Position.y;
+
+	for (i = 0, j = 0; j < col->count && i < 4; j++) 
+	{
+		block = col->blocks[j];
+		topY  = col->ys[j] + Blocks.MaxBB[block].y;
 		if (topY >= posY + 0.01f) continue;
 
 		cur->block = block; cur->y = topY;
 		EntityShadow_CalcAlpha(posY, cur);
 		i++; cur++;
 
-		/* Check if the casted shadow will continue on further down. */
-		if (Blocks.MinBB[block].x == 0.0f && Blocks.MaxBB[block].x == 1.0f &&
-			Blocks.MinBB[block].z == 0.0f && Blocks.MaxBB[block].z == 1.0f) return true;
+		if (EntityShadow_StopsAt(block)) return true;
 	}
 
 	if (i < 4) {
@@ -162,13 +200,27 @@ static cc_bool EntityShadow_GetBlocks(struct Entity* e, int x, int y, int z, str
 	return true;
 }
 
-static void EntityShadow_Draw(struct Entity* e) {
-	struct VertexTextured vertices[128]; /* TODO this is less than maxVertes */
+static void EntityShadow_Flush(void) {
+	int count = (int)(shadows_ptr - shadows_vertices);
+	if (!count) return;
+
+	if (!shadows_boundTex) {
+		Gfx_BindTexture(shadows_tex);
+		shadows_boundTex = true;
+	}
+
+	Gfx_SetDynamicVbData(shadows_VB, shadows_vertices, count);
+	Gfx_DrawVb_IndexedTris(count);
+	shadows_ptr = shadows_vertices;
+}
+
+static void EntityShadow_Draw(struct Entity* e, int id) {
+	struct ShadowCache* cache = &shadows_cache[id];
 	struct VertexTextured* ptr;
 	struct ShadowData data[4];
 	Vec3 pos;
 	float radius;
-	int y, count;
+	int y;
 	int x1, z1, x2, z2;
 
 	pos = e->Position;
@@ -179,40 +231,47 @@ static void EntityShadow_Draw(struct Entity* e) {
 	shadow_radius  = radius / 16.0f;
 	shadow_uvScale = 16.0f / (radius * 2.0f);
 
-	ptr = vertices;
 	if (Entities.ShadowsMode == SHADOW_MODE_SNAP_TO_BLOCK) {
 		x1 = Math_Floor(pos.x); z1 = Math_Floor(pos.z);
-		if (!EntityShadow_GetBlocks(e, x1, y, z1, data)) return;
-
-		EntityShadow_DrawSquareShadow(&ptr, data[0].y, x1, z1);
+		x2 = x1;                z2 = z1;
 	} else {
 		x1 = Math_Floor(pos.x - shadow_radius); z1 = Math_Floor(pos.z - shadow_radius);
 		x2 = Math_Floor(pos.x + shadow_radius); z2 = Math_Floor(pos.z + shadow_radius);
+	}
+
+	if (cache->epoch != shadows_epoch || cache->y != y ||
+		cache->x1 != x1 || cache->z1 != z1 || cache->x2 != x2 || cache->z2 != z2) {
+		cache->epoch = shadows_epoch; cache->y = y;
+		cache->x1 = x1; cache->z1 = z1; cache->x2 = x2; cache->z2 = z2;
 
-		if (EntityShadow_GetBlocks(e, x1, y, z1, data) && data[0].alpha > 0) {
+		EntityShadow_ProbeColumn(x1, y, z1, &cache->columns[0]);
+		if (x1 != x2)             EntityShadow_ProbeColumn(x2, y, z1, &cache->columns[1]);
+		if (z1 != z2)             EntityShadow_ProbeColumn(x1, y, z2, &cache->columns[2]);
+		if (x1 != x2 && z1 != z2) EntityShadow_ProbeColumn(x2, y, z2, &cache->columns[3]);
+	}
+
+	if (shadows_ptr + SHADOW_MAX_VERTS > shadows_vertices + SHADOW_BATCH_VERTS) EntityShadow_Flush();
+	ptr = shadows_ptr;
+
+	if (Entities.ShadowsMode == SHADOW_MODE_SNAP_TO_BLOCK) {
+		if (!EntityShadow_GetBlocks(e, &cache->columns[0], data)) return;
+
+		EntityShadow_DrawSquareShadow(&ptr, data[0].y, x1, z1);
+	} else {
+		if (EntityShadow_GetBlocks(e, &cache->columns[0], data) && data[0].alpha > 0) {
 			EntityShadow_DrawCircle(&ptr, e, data, (float)x1, (float)z1);
 		}
-		if (x1 != x2 && EntityShadow_GetBlocks(e, x2, y, z1, data) && data[0].alpha > 0) {
+		if (x1 != x2 && EntityShadow_GetBlocks(e, &cache->columns[1], data) && data[0].alpha > 0) {
 			EntityShadow_DrawCircle(&ptr, e, data, (float)x2, (float)z1);
 		}
-		if (z1 != z2 && EntityShadow_GetBlocks(e, x1, y, z2, data) && data[0].alpha > 0) {
+		if (z1 != z2 && EntityShadow_GetBlocks(e, &cache->columns[2], data) && data[0].alpha > 0) {
 			EntityShadow_DrawCircle(&ptr, e, data, (float)x1, (float)z2);
 		}
-		if (x1 != x2 && z1 != z2 && EntityShadow_GetBlocks(e, x2, y, z2, data) && data[0].alpha > 0) {
+		if (x1 != x2 && z1 != z2 && EntityShadow_GetBlocks(e, &cache->columns[3], data) && data[0].alpha > 0) {
 			EntityShadow_DrawCircle(&ptr, e, data, (float)x2, (float)z2);
 		}
 	}
-
-	if (ptr == vertices) return;
-
-	if (!shadows_boundTex) {
-		Gfx_BindTexture(shadows_tex);
-		shadows_boundTex = true;
-	}
-
-	count = (int)(ptr - vertices);
-	Gfx_SetDynamicVbData(shadows_VB, vertices, count);
-	Gfx_DrawVb_IndexedTris(count);
+	shadows_ptr = ptr;
 }
 
 
@@ -251,23 +310,25 @@ void EntityShadows_Render(void) {
 	if (!shadows_tex) 
 		EntityShadows_MakeTexture();
 	if (!shadows_VB)
-		shadows_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, SHADOW_MAX_VERTS);
+		shadows_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, SHADOW_BATCH_VERTS);
 
 	Gfx_SetAlphaArgBlend(true);
 	Gfx_SetDepthWrite(false);
 	Gfx_SetAlphaBlending(true);
 
 	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	EntityShadow_Draw(&Entities.CurPlayer->Base);
+	shadows_ptr = shadows_vertices;
+	EntityShadow_Draw(&Entities.CurPlayer->Base, ENTITIES_SELF_ID);
 
 	if (Entities.ShadowsMode == SHADOW_MODE_CIRCLE_ALL) {	
 		for (i = 0; i < ENTITIES_MAX_COUNT; i++) 
 		{
 			e = Entities.List[i];
 			if (!e || !e->ShouldRender || e == &Entities.CurPlayer->Base) continue;
-			EntityShadow_Draw(e);
+			EntityShadow_Draw(e, i);
 		}
 	}
+	EntityShadow_Flush();
 
 	Gfx_SetAlphaArgBlend(false);
 	Gfx_SetDepthWrite(true);
@@ -464,9 +525,33 @@ static void EntityRenderers_ContextLost(void* obj) {
 	DeleteAllNameTextures();
 }
 
+static void EntityShadows_Invalidate(void* obj) { shadows_epoch++; }
+static void EntityShadows_EnvVarChanged(void* obj, int envVar) { shadows_epoch++; }
+
+void EntityShadows_OnBlocksChanged(const IVec3* min, const IVec3* max) {
+	struct ShadowCache* cache;
+	int i;
+
+	for (i = 0; i < ENTITIES_MAX_COUNT; i++) 
+	{
+		cache = &shadows_cache[i];
+		if (cache->epoch != shadows_epoch) continue; /* Already invalid */
+
+		/* Columns are only searched downwards from the entity's Y */
+		if (min->y > cache->y || max->x < cache->x1 || min->x > cache->x2 
+							  || max->z < cache->z1 || min->z > cache->z2) continue;
+		cache->epoch = 0;
+	}
+}
+
 static void EntityRenderers_Init(void) {
 	Event_Register_(&GfxEvents.ContextLost,  NULL, EntityRenderers_ContextLost);
 	Event_Register_(&ChatEvents.FontChanged, NULL, EntityNames_ChatFontChanged);
+
+	Event_Register_(&BlockEvents.BlockDefChanged, NULL, EntityShadows_Invalidate);
+	Event_Register_(&WorldEvents.EnvVarChanged,   NULL, EntityShadows_EnvVarChanged);
+	Event_Register_(&WorldEvents.NewMap,          NULL, EntityShadows_Invalidate);
+	Event_Register_(&WorldEvents.MapLoaded,       NULL, EntityShadows_Invalidate);
 }
 
 static void EntityRenderers_Free(void) {
@@ -1,6 +1,6 @@
 #ifndef CC_ENTITYRENDERERS_H
 #define CC_ENTITYRENDERERS_H
-#include "Core.h"
+#include "Vectors.h"
 CC_BEGIN_HEADER
 
 /* Renders supporting objects for entities (shadows and names)
@@ -12,6 +12,8 @@ struct Entity;
 
 /* Draws shadows under entities, depending on Entities.ShadowsMode */
 void EntityShadows_Render(void);
+/* Called after blocks within the given region changed, to invalidate cached shadows cast onto those blocks */
+void EntityShadows_OnBlocksChanged(const IVec3* min, const IVec3* max);
 
 /* Deletes the texture containing the entity's nametag */
 void EntityNames_Delete(struct Entity* e);
@@ -21,6 +21,12 @@
 #include "Entity.h"
 
 cc_bool EnvRenderer_Legacy, EnvRenderer_Minimal;
+int EnvRenderer_FarDistance;
+
+/* Returns the distance that fog and the environment around the map extend out to */
+static int CalcEnvDistance(void) {
+	return max(Game_ViewDistance, EnvRenderer_FarDistance);
+}
 
 static float CalcBlendFactor(float x) {
 	float blend = -0.13f + 0.28f * ((float)Math_Log2(x) * 0.17329f);
@@ -64,7 +70,7 @@ static void CalcFog(float* density, PackedCol* color) {
 	} else {
 		*density = 0.0f;
 		/* Blend fog and sky together */
-		blend    = CalcBlendFactor((float)Game_ViewDistance);
+		blend    = CalcBlendFactor((float)CalcEnvDistance());
 		*color   = PackedCol_Lerp(Env.FogCol, Env.SkyCol, blend);
 	}
 }
@@ -102,11 +108,11 @@ static void UpdateFogNormal(float fogDensity, PackedCol fogColor) {
 		  d = -ln(0.01)/(end*0.99) */
 		#define LOG_001 -4.60517018598809f
 
-		density = -LOG_001 / (Game_ViewDistance * 0.99f);
+		density = -LOG_001 / (CalcEnvDistance() * 0.99f);
 		Gfx_SetFogDensity(density);
 	} else {
 		Gfx_SetFogMode(FOG_LINEAR);
-		Gfx_SetFogEnd((float)Game_ViewDistance);
+		Gfx_SetFogEnd((float)CalcEnvDistance());
 	}
 	Gfx_SetFogCol(fogColor);
 	Game_SetViewDistance(Game_UserViewDistance);
@@ -185,7 +191,7 @@ static void UpdateClouds(void) {
 	if (!World.Loaded || Gfx.LostContext) return;
 	if (EnvRenderer_Minimal) return;
 
-	extent = Utils_AdjViewDist(Game_ViewDistance);
+	extent = Utils_AdjViewDist(CalcEnvDistance());
 	x1 = -extent; x2 = World.Width  + extent;
 	z1 = -extent; z2 = World.Length + extent;
 	clouds_vertices = CalcNumVertices(x2 - x1, z2 - z1);
@@ -257,7 +263,7 @@ static void UpdateSky(void) {
 	if (!World.Loaded || Gfx.LostContext) return;
 	if (EnvRenderer_Minimal) return;
 
-	extent = Utils_AdjViewDist(Game_ViewDistance);
+	extent = Utils_AdjViewDist(CalcEnvDistance());
 	x1 = -extent; x2 = World.Width  + extent;
 	z1 = -extent; z2 = World.Length + extent;
 	sky_vertices = CalcNumVertices(x2 - x1, z2 - z1);
@@ -352,121 +358,280 @@ static IVec3 lastPos;
 
 #define WEATHER_VERTS_COUNT WEATHER_RANGE * WEATHER_RANGE * WEATHER_VERTS
 #define Weather_Pack(x, z) ((x) * World.Length + (z))
+#define Weather_StopsRain(block) (Blocks.Draw[block] != DRAW_GAS && Blocks.Draw[block] != DRAW_SPRITE)
+
+/* Each column is split into (at most) 32 vertical segments, with a bit per segment */
+/*  that is set when the segment contains any blocks which stop rain. This way, changing */
+/*  blocks only requires rescanning their segments and the topmost segment instead of the entire column. */
+static cc_uint32* weather_segments;
+static int weather_segShift;
+/* Whether the cached weather geometry needs to be rebuilt */
+static cc_bool weather_dirty;
 
 static void InitWeatherHeightmap(void) {
 	int i;
 	Weather_Heightmap = (cc_int16*)Mem_Alloc(World.Width * World.Length, 2, "weather heightmap");
+	weather_segments  = (cc_uint32*)Mem_Alloc(World.Width * World.Length, 4, "weather segments");
 	
 	for (i = 0; i < World.Width * World.Length; i++) {
 		Weather_Heightmap[i] = Int16_MaxValue;
 	}
+
+	weather_segShift = 0;
+	while (((World.Height - 1) >> weather_segShift) >= 32) weather_segShift++;
+	weather_dirty = true;
 }
 
-#define RainCalcBody(get_block)\
-for (y = maxY; y >= 0; y--, i -= World.OneY) {\
-	draw = Blocks.Draw[get_block];\
-\
-	if (!(draw == DRAW_GAS || draw == DRAW_SPRITE)) {\
-		Weather_Heightmap[hIndex] = y;\
-		return y;\
-	}\
+static void FreeWeatherHeightmap(void) {
+	Mem_Free(Weather_Heightmap);
+	Mem_Free(weather_segments);
+	Weather_Heightmap = NULL;
+	weather_segments  = NULL;
 }
 
-static int CalcRainHeightAt(int x, int maxY, int z, int hIndex) {
-	int i = World_Pack(x, maxY, z), y;
-	cc_uint8 draw;
+/* Scans the entire column, returning the topmost y that stops rain (or -1 if none) */
+static int CalcRainHeightAt(int x, int z, cc_uint32* segments) {
+	int i = World_Pack(x, World.MaxY, z), y, top = -1;
+	int segBeg, shift = weather_segShift;
+	cc_uint32 mask = 0;
+	BlockID block;
 
-#ifndef EXTENDED_BLOCKS
-	RainCalcBody(World.Blocks[i]);
-#else
-	if (World.IDMask <= 0xFF) {
-		RainCalcBody(World.Blocks[i]);
-	} else {
-		RainCalcBody(World.Blocks[i] | (World.Blocks2[i] << 8));
+	for (y = World.MaxY; y >= 0; y--, i -= World.OneY)
+	{
+		block = World_GetRawBlock(i);
+		if (!Weather_StopsRain(block)) continue;
+
+		if (top == -1) top = y;
+		mask  |= 1U << (y >> shift);
+
+		/* Rest of this segment doesn't need to be checked */
+		segBeg = (y >> shift) << shift;
+		i -= (y - segBeg) * World.OneY;
+		y  = segBeg;
 	}
-#endif
 
-	Weather_Heightmap[hIndex] = -1;
+	*segments = mask;
+	return top;
+}
+
+/* Returns the topmost y within the given segment of the column that stops rain (or -1 if none) */
+static int CalcRainSegmentTop(int x, int seg, int z) {
+	int minY = seg << weather_segShift;
+	int y    = min(World.MaxY, minY + (1 << weather_segShift) - 1);
+	int i    = World_Pack(x, y, z);
+
+	for (; y >= minY; y--, i -= World.OneY)
+	{
+		if (Weather_StopsRain(World_GetRawBlock(i))) return y;
+	}
 	return -1;
 }
 
+/* Returns the topmost y of the given column that stops rain (or -1 if none) */
+static int GetRainTop(int x, int z) {
+	int hIndex = Weather_Pack(x, z);
+	int height = Weather_Heightmap[hIndex];
+
+	if (height == Int16_MaxValue) {
+		height = CalcRainHeightAt(x, z, &weather_segments[hIndex]);
+		Weather_Heightmap[hIndex] = height;
+	}
+	return height;
+}
+
 static float GetRainHeight(int x, int z) {
-	int hIndex, height;
 	int y;
 	if (!World_ContainsXZ(x, z)) return (float)Env.EdgeHeight;
 
-	hIndex = Weather_Pack(x, z);
-	height = Weather_Heightmap[hIndex];
-
-	y = height == Int16_MaxValue ? CalcRainHeightAt(x, World.MaxY, z, hIndex) : height;
+	y = GetRainTop(x, z);
 	return y == -1 ? 0 : y + Blocks.MaxBB[World_GetBlock(x, y, z)].y;
 }
 
-void EnvRenderer_OnBlockChanged(int x, int y, int z, BlockID oldBlock, BlockID newBlock) {
-	cc_bool didBlock = !(Blocks.Draw[oldBlock] == DRAW_GAS || Blocks.Draw[oldBlock] == DRAW_SPRITE);
-	cc_bool nowBlock = !(Blocks.Draw[newBlock] == DRAW_GAS || Blocks.Draw[newBlock] == DRAW_SPRITE);
-	int hIndex, height;
-	if (didBlock == nowBlock) return;
+/* Rain heights of the entire world are calculated on a background thread after a map loads, */
+/*  so that columns don't need to be lazily scanned on the main thread during gameplay. */
+#ifndef CC_BUILD_COOPTHREADED
+static void* prefill_thread;
+static cc_int16*  prefill_heights;
+static cc_uint32* prefill_segments;
+static volatile cc_bool prefill_done, prefill_stop;
+static cc_bool prefill_finished;
+static int prefill_idMask;
+
+static void Weather_PrefillWorker(void) {
+	int count = World.Width * World.Length, shift = weather_segShift;
+	int i, x, y, z, hIndex;
+	BlockID block;
 
-	hIndex = Weather_Pack(x, z);
-	height = Weather_Heightmap[hIndex];
-	/* Two cases can be skipped here: */
-	/* a) rain height was not calculated to begin with (height is short.MaxValue) */
-	/* b) changed y is below current calculated rain height */
-	if (y < height) return;
+	for (i = 0; i < count; i++) 
+	{
+		prefill_heights[i]  = -1;
+		prefill_segments[i] = 0;
+	}
 
-	if (nowBlock) {
-		/* Simple case: Rest of column below is now not visible to rain. */
-		Weather_Heightmap[hIndex] = y;
-	} else {
-		/* Part of the column is now visible to rain, we don't know how exactly how high it should be though. */
-		/* However, we know that if the old block was above or equal to rain height, then the new rain height must be <= old block.y */
-		CalcRainHeightAt(x, y, z, hIndex);
+	/* Sweep through the map one layer at a time, as that accesses memory sequentially */
+	for (y = World.MaxY; y >= 0 && !prefill_stop; y--) 
+	{
+		i = World_Pack(0, y, 0);
+
+		for (z = 0; z < World.Length; z++) 
+		{
+			for (x = 0; x < World.Width; x++, i++) 
+			{
+				block = World_GetRawBlock(i);
+				if (!Weather_StopsRain(block)) continue;
+
+				hIndex = Weather_Pack(x, z);
+				if (prefill_heights[hIndex] == -1) prefill_heights[hIndex] = y;
+				prefill_segments[hIndex] |= 1U << (y >> shift);
+			}
+		}
 	}
+	prefill_done = true;
 }
 
-static float CalcRainAlphaAt(float x) {
-	/* Wolfram Alpha: fit {0,178},{1,169},{4,147},{9,114},{16,59},{25,9} */
-	float falloff = 0.05f * x * x - 7 * x;
-	return 178 + falloff * Env.WeatherFade;
+static void Weather_StartPrefill(void) {
+	int count = World.Width * World.Length;
+	if (prefill_thread || prefill_finished || !World.Loaded || !count) return;
+	if (!Weather_Heightmap) InitWeatherHeightmap();
+
+	prefill_heights  = (cc_int16*) Mem_TryAlloc(count, 2);
+	prefill_segments = (cc_uint32*)Mem_TryAlloc(count, 4);
+	/* Not enough memory, just fallback to lazily calculating columns */
+	if (!prefill_heights || !prefill_segments) {
+		Mem_Free(prefill_heights);  prefill_heights  = NULL;
+		Mem_Free(prefill_segments); prefill_segments = NULL;
+		return;
+	}
+
+	prefill_done   = false;
+	prefill_stop   = false;
+	prefill_idMask = World.IDMask;
+	Thread_Run(&prefill_thread, Weather_PrefillWorker, 64 * 1024, "Weather prefill");
 }
 
-struct RainCoord { int dx, dz; float y; };
-static RNGState snowDirRng;
+static void Weather_EndPrefill(cc_bool apply) {
+	int i, count = World.Width * World.Length;
+	if (!prefill_thread) return;
+
+	Thread_Join(prefill_thread);
+	prefill_thread   = NULL;
+	prefill_finished = true;
+
+	/* Blocks may have changed while the worker was scanning, which means its result */
+	/*  may be outdated for those columns. However, any column changed since the map */
+	/*  loaded has already been calculated on the main thread, so just keep those. */
+	/* Worker's results are also unusable if the map had its upper block IDs array created. */
+	if (apply && World.IDMask == prefill_idMask) {
+		for (i = 0; i < count; i++)
+		{
+			if (Weather_Heightmap[i] != Int16_MaxValue) continue;
+			Weather_Heightmap[i] = prefill_heights[i];
+			weather_segments[i]  = prefill_segments[i];
+		}
+		weather_dirty = true;
+	}
 
-void EnvRenderer_RenderWeather(float delta) {
-	struct RainCoord coords[WEATHER_RANGE * WEATHER_RANGE];
-	int i, weather, numCoords = 0;
-	struct VertexTextured* v;
-	cc_bool moved, particles;
-	float speed, vOffsetBase, vOffset;
-	IVec3 pos;
+	Mem_Free(prefill_heights);  prefill_heights  = NULL;
+	Mem_Free(prefill_segments); prefill_segments = NULL;
+}
 
-	PackedCol color;
-	int dist, dx, dz, x, z;
-	float alpha, y, height;
-	float uOffset1, uOffset2, uSpeed;
-	float worldV, v1, v2, vPlane1Offset;
-	float x1,y1,z1, x2,y2,z2;
+static void Weather_CheckPrefill(void) {
+	if (prefill_thread && prefill_done) Weather_EndPrefill(true);
+}
 
-	weather = Env.Weather;
-	if (weather == WEATHER_SUNNY) return;
+void EnvRenderer_StopWeatherPrefill(void) {
+	prefill_stop = true;
+	Weather_EndPrefill(false);
+	prefill_finished = false;
+}
+#else
+static void Weather_StartPrefill(void) { }
+static void Weather_CheckPrefill(void) { }
+void EnvRenderer_StopWeatherPrefill(void) { }
+#endif
 
-	if (!Weather_Heightmap) 
-		InitWeatherHeightmap();
-	if (!weather_vb)
-		weather_vb = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, WEATHER_VERTS_COUNT);
+static void MarkWeatherDirty(int x, int z) {
+	if (Math_AbsI(x - lastPos.x) <= WEATHER_EXTENT && Math_AbsI(z - lastPos.z) <= WEATHER_EXTENT) {
+		weather_dirty = true;
+	}
+}
 
-	IVec3_Floor(&pos, &Camera.CurrentPos);
-	moved   = pos.x != lastPos.x || pos.y != lastPos.y || pos.z != lastPos.z;
-	lastPos = pos;
+/* Recalculates rain heights of all columns, as which blocks stop rain may have changed */
+static void ResetWeatherHeightmap(void) {
+	int i;
+	if (!Weather_Heightmap) return;
+	EnvRenderer_StopWeatherPrefill();
 
-	/* Rain should extend up by 64 blocks, or to the top of the world. */
-	pos.y += 64;
-	pos.y = max(World.Height, pos.y);
+	for (i = 0; i < World.Width * World.Length; i++) {
+		Weather_Heightmap[i] = Int16_MaxValue;
+	}
+	weather_dirty = true;
+	if (Env.Weather != WEATHER_SUNNY) Weather_StartPrefill();
+}
 
-	weather_accumulator += delta;
-	particles = weather == WEATHER_RAINY && (weather_accumulator >= 0.25f || moved);
+static void UpdateRainHeight(int x, int z, int minY, int maxY) {
+	int hIndex = Weather_Pack(x, z);
+	int height = Weather_Heightmap[hIndex];
+	int seg, maxSeg = maxY >> weather_segShift;
+
+	if (height == Int16_MaxValue) {
+#ifndef CC_BUILD_COOPTHREADED
+		/* Prefill worker may have already scanned this column, so its result can't be used */
+		if (prefill_thread) {
+			Weather_Heightmap[hIndex] = CalcRainHeightAt(x, z, &weather_segments[hIndex]);
+		}
+#endif
+		/* Otherwise column gets scanned by GetRainHeight when next needed */
+		return;
+	}
+
+	for (seg = minY >> weather_segShift; seg <= maxSeg; seg++)
+	{
+		if (CalcRainSegmentTop(x, seg, z) == -1) {
+			weather_segments[hIndex] &= ~(1U << seg);
+		} else {
+			weather_segments[hIndex] |=  (1U << seg);
+		}
+	}
+	/* Changes below the topmost block that stops rain have no effect */
+	/*  (but the topmost block itself may have been replaced with a block of different height) */
+	if (maxY < height) return;
+
+	/* Find the highest remaining segment which contains a block that stops rain */
+	height = -1;
+	for (seg = 31; seg >= 0 && height == -1; seg--)
+	{
+		if (!(weather_segments[hIndex] & (1U << seg))) continue;
+		height = CalcRainSegmentTop(x, seg, z);
+	}
+	Weather_Heightmap[hIndex] = height;
+	MarkWeatherDirty(x, z);
+}
+
+static void FarTerrain_OnColumnChanged(int x, int z, int maxY);
+
+void EnvRenderer_OnColumnChanged(int x, int z, int minY, int maxY) {
+	UpdateRainHeight(x, z, minY, maxY);
+	FarTerrain_OnColumnChanged(x, z, maxY);
+}
+
+static float CalcRainAlphaAt(float x) {
+	/* Wolfram Alpha: fit {0,178},{1,169},{4,147},{9,114},{16,59},{25,9} */
+	float falloff = 0.05f * x * x - 7 * x;
+	return 178 + falloff * Env.WeatherFade;
+}
+
+struct RainCoord { int dx, dz; float y; };
+static RNGState snowDirRng;
+static struct RainCoord weather_coords[WEATHER_RANGE * WEATHER_RANGE];
+static int weather_numCoords, weather_lastType;
+static PackedCol weather_lastCol;
+static float weather_lastFade;
+
+static void CalcWeatherCoords(IVec3 pos) {
+	int dx, dz, x, z;
+	float y;
+	weather_numCoords = 0;
 
 	for (dx = -WEATHER_EXTENT; dx <= WEATHER_EXTENT; dx++) {
 		for (dz = -WEATHER_EXTENT; dz <= WEATHER_EXTENT; dz++) {
@@ -474,38 +639,35 @@ void EnvRenderer_RenderWeather(float delta) {
 
 			y = GetRainHeight(x, z);
 			if (pos.y <= y) continue;
-			if (particles) Particles_RainSnowEffect((float)x, y, (float)z);
 
-			coords[numCoords].dx = dx;
-			coords[numCoords].y  = y;
-			coords[numCoords].dz = dz;
-			numCoords++;
+			weather_coords[weather_numCoords].dx = dx;
+			weather_coords[weather_numCoords].y  = y;
+			weather_coords[weather_numCoords].dz = dz;
+			weather_numCoords++;
 		}
 	}
+}
 
-	Gfx_BindTexture(weather == WEATHER_RAINY ? rain_tex : snow_tex);
-	if (particles) weather_accumulator = 0;
-	if (!numCoords) return;
-
-	Gfx_SetAlphaTest(false);
-	Gfx_SetDepthWrite(false);
-	Gfx_SetAlphaArgBlend(true);
+static void BuildWeatherMesh(IVec3 pos, int weather, float vOffsetBase) {
+	struct VertexTextured* v;
+	PackedCol color;
+	int i, dist, dx, dz, x, z;
+	float alpha, y, height, vOffset;
+	float uOffset1, uOffset2, uSpeed;
+	float worldV, v1, v2, vPlane1Offset;
+	float x1,y1,z1, x2,y2,z2;
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
 	v = (struct VertexTextured*)Gfx_LockDynamicVb(weather_vb, 
-										VERTEX_FORMAT_TEXTURED, numCoords * WEATHER_VERTS);
+										VERTEX_FORMAT_TEXTURED, weather_numCoords * WEATHER_VERTS);
 
 	color = Env.SunCol;
-	speed = (weather == WEATHER_RAINY ? 1.0f : 0.2f) * Env.WeatherSpeed;
-
-	vOffsetBase   = (float)Game.Time * speed;
 	vPlane1Offset = weather == WEATHER_RAINY  ? 0 : 0.25f; /* Offset v on 1 plane while snowing to avoid the unnatural mirrored texture effect */
 
-	for (i = 0; i < numCoords; i++)
+	for (i = 0; i < weather_numCoords; i++)
 	{
-		dx = coords[i].dx;
-		y  = coords[i].y;
-		dz = coords[i].dz;
+		dx = weather_coords[i].dx;
+		y  = weather_coords[i].y;
+		dz = weather_coords[i].dz;
 
 		height = pos.y - y;
 
@@ -549,9 +711,83 @@ void EnvRenderer_RenderWeather(float delta) {
 		v->x = x1; v->y = y2; v->z = z2; v->Col = color; v->U = uOffset2;        v->V = v2; v++;
 		v->x = x1; v->y = y1; v->z = z2; v->Col = color; v->U = uOffset2;        v->V = v1; v++;
 	}
-
 	Gfx_UnlockDynamicVb(weather_vb);
-	Gfx_DrawVb_IndexedTris(numCoords * WEATHER_VERTS);
+}
+
+void EnvRenderer_RenderWeather(float delta) {
+	int i, weather;
+	cc_bool moved, particles;
+	float speed, vOffsetBase;
+	IVec3 pos;
+
+	Weather_CheckPrefill();
+	weather = Env.Weather;
+	if (weather == WEATHER_SUNNY) return;
+
+	if (!Weather_Heightmap) 
+		InitWeatherHeightmap();
+	if (!weather_vb) {
+		weather_vb    = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, WEATHER_VERTS_COUNT);
+		weather_dirty = true;
+	}
+
+	IVec3_Floor(&pos, &Camera.CurrentPos);
+	moved   = pos.x != lastPos.x || pos.y != lastPos.y || pos.z != lastPos.z;
+	lastPos = pos;
+
+	/* Rain should extend up by 64 blocks, or to the top of the world. */
+	pos.y += 64;
+	pos.y = max(World.Height, pos.y);
+
+	weather_accumulator += delta;
+	particles = weather == WEATHER_RAINY && (weather_accumulator >= 0.25f || moved);
+
+	/* Rain heights and geometry only change when moving to a different block, or when blocks nearby change */
+	if (moved || weather_dirty) CalcWeatherCoords(pos);
+	if (moved || weather != weather_lastType || Env.SunCol != weather_lastCol || Env.WeatherFade != weather_lastFade) {
+		weather_dirty = true;
+	}
+
+	if (particles) {
+		for (i = 0; i < weather_numCoords; i++)
+		{
+			Particles_RainSnowEffect((float)(pos.x + weather_coords[i].dx), weather_coords[i].y, 
+									(float)(pos.z + weather_coords[i].dz));
+		}
+	}
+
+	Gfx_BindTexture(weather == WEATHER_RAINY ? rain_tex : snow_tex);
+	if (particles) weather_accumulator = 0;
+	if (!weather_numCoords) return;
+
+	Gfx_SetAlphaTest(false);
+	Gfx_SetDepthWrite(false);
+	Gfx_SetAlphaArgBlend(true);
+	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
+
+	speed       = (weather == WEATHER_RAINY ? 1.0f : 0.2f) * Env.WeatherSpeed;
+	vOffsetBase = (float)Game.Time * speed;
+
+	if (weather == WEATHER_RAINY && !Gfx.NoTextureOffset) {
+		/* Rain falls at the same speed everywhere, so the mesh only needs to be rebuilt */
+		/*  when it changes, with falling being done by offsetting the texture instead. */
+		if (weather_dirty) BuildWeatherMesh(pos, weather, 0);
+		Gfx_BindDynamicVb(weather_vb);
+
+		Gfx_EnableTextureOffset(0, vOffsetBase - Math_Floor(vOffsetBase));
+		Gfx_DrawVb_IndexedTris(weather_numCoords * WEATHER_VERTS);
+		Gfx_DisableTextureOffset();
+	} else {
+		/* Each snow column falls at a different speed, and some backends can't offset */
+		/*  textures, so the falling is instead baked into a mesh rebuilt every frame */
+		BuildWeatherMesh(pos, weather, vOffsetBase);
+		Gfx_DrawVb_IndexedTris(weather_numCoords * WEATHER_VERTS);
+	}
+
+	weather_dirty    = false;
+	weather_lastType = weather;
+	weather_lastCol  = Env.SunCol;
+	weather_lastFade = Env.WeatherFade;
 
 	Gfx_SetAlphaArgBlend(false);
 	Gfx_SetDepthWrite(true);
@@ -610,7 +846,7 @@ static Rect2D EnvRenderer_Rect(int x, int y, int width, int height) {
 }
 
 static void CalcBorderRects(Rect2D* rects) {
-	int extent = Utils_AdjViewDist(Game_ViewDistance);
+	int extent = Utils_AdjViewDist(CalcEnvDistance());
 	rects[0] = EnvRenderer_Rect(-extent, -extent,      extent + World.Width + extent, extent);
 	rects[1] = EnvRenderer_Rect(-extent, World.Length, extent + World.Width + extent, extent);
 
@@ -784,6 +1020,372 @@ static void UpdateMapEdges(void) {
 }
 
 
+/*########################################################################################################################*
+*-------------------------------------------------------Far terrain-------------------------------------------------------*
+*#########################################################################################################################*/
+/* Parts of the map past the view distance are drawn as a coarse grid of cells, where each cell */
+/*  is a single flat coloured column as tall as the average height of the blocks within that cell. */
+/* Column heights come from the weather heightmap, which is calculated on a background thread. */
+#if !defined CC_BUILD_COOPTHREADED && !defined CC_BUILD_LOW_VRAM
+#define FAR_MAX_CELLS    256 /* Max number of cells along each axis of the map */
+#define FAR_REGION_CELLS 16  /* Number of cells along each axis of a region */
+#define FAR_MAX_REGIONS  (FAR_MAX_CELLS / FAR_REGION_CELLS)
+/* Max distance far terrain extends out to, since the far plane of the projection matrix */
+/*  is moved out to this distance too, and depth buffer precision gets poor past it */
+#define FAR_MAX_DISTANCE 4096
+/* Cells are slightly lowered, so they are drawn underneath any chunks that overlap them */
+#define FAR_SINK 0.5f
+
+/* Each region of cells is a separate mesh, so changes only require rebuilding part of the terrain */
+struct FarRegion { GfxResourceID vb; int count, skipped; cc_bool dirty; };
+static struct FarRegion far_regions[FAR_MAX_REGIONS * FAR_MAX_REGIONS];
+
+static cc_int16 far_heights[FAR_MAX_CELLS * FAR_MAX_CELLS];
+static BlockID  far_blocks[FAR_MAX_CELLS * FAR_MAX_CELLS];
+static PackedCol far_texCols[ATLAS2D_MAX_TILES];
+static int far_cellSize, far_cellsX, far_cellsZ, far_regionsX, far_regionsZ;
+static cc_bool far_ready;
+static IVec3 far_lastCell;
+
+/* Calculates the average colour of the non-transparent pixels in the given tile */
+static PackedCol FarTerrain_CalcTexColor(TextureLoc loc) {
+	int size = Atlas2D.TileSize, count = 0;
+	int baseX = Atlas2D_TileX(loc) * size, baseY = Atlas2D_TileY(loc) * size;
+	int x, y, r = 0, g = 0, b = 0;
+	BitmapCol color;
+
+	if (!Atlas2D.Bmp.scan0 || baseY + size > Atlas2D.Bmp.height) return PACKEDCOL_WHITE;
+
+	for (y = baseY; y < baseY + size; y++) {
+		for (x = baseX; x < baseX + size; x++) 
+		{
+			color = Bitmap_GetPixel(&Atlas2D.Bmp, x, y);
+			if (BitmapCol_A(color) < 127) continue;
+
+			r += BitmapCol_R(color); g += BitmapCol_G(color); b += BitmapCol_B(color);
+			count++;
+		}
+	}
+
+	if (!count) return PACKEDCOL_WHITE;
+	return PackedCol_Make(r / count, g / count, b / count, 255);
+}
+
+static PackedCol FarTerrain_GetColor(BlockID block, Face face, PackedCol light) {
+	TextureLoc loc = Block_Tex(block, face);
+	PackedCol color;
+
+	/* Texture colours are lazily calculated, since most tiles are never needed */
+	if (loc >= ATLAS2D_MAX_TILES) {
+		color = PACKEDCOL_WHITE;
+	} else {
+		if (!far_texCols[loc]) far_texCols[loc] = FarTerrain_CalcTexColor(loc);
+		color = far_texCols[loc];
+	}
+
+	Block_Tint(color, block)
+	return Blocks.Brightness[block] ? color : PackedCol_Tint(color, light);
+}
+
+static void FarTerrain_CalcCell(int cx, int cz) {
+	int x1 = cx * far_cellSize, x2 = min(x1 + far_cellSize, World.Width);
+	int z1 = cz * far_cellSize, z2 = min(z1 + far_cellSize, World.Length);
+	int x, z, y, sum = 0, count = 0, top = -1;
+	int dist, bestDist = Int32_MaxValue, bestX = 0, bestZ = 0;
+
+	for (z = z1; z < z2; z++) {
+		for (x = x1; x < x2; x++) 
+		{
+			y = GetRainTop(x, z);
+			if (y == -1) continue;
+			sum += y; count++;
+		}
+	}
+
+	/* Using the average instead of highest height stops e.g. a single tall tower */
+	/*  from turning the whole cell into a giant slab. Mostly empty cells are left empty. */
+	if (count * 2 >= (x2 - x1) * (z2 - z1)) top = sum / count;
+
+	/* Colour cell using the top block of the column closest to the average height */
+	for (z = z1; z < z2 && top != -1; z++) {
+		for (x = x1; x < x2; x++) 
+		{
+			y = GetRainTop(x, z);
+			if (y == -1) continue;
+
+			dist = Math_AbsI(y - top);
+			if (dist >= bestDist) continue;
+			bestDist = dist; bestX = x; bestZ = z;
+		}
+	}
+
+	far_heights[cz * FAR_MAX_CELLS + cx] = top;
+	far_blocks[cz * FAR_MAX_CELLS + cx]  = top == -1 ? BLOCK_AIR : World_GetBlock(bestX, GetRainTop(bestX, bestZ), bestZ);
+}
+
+/* Returns the y coordinate of the top of the given cell */
+static float FarTerrain_CellTop(int cx, int cz) {
+	int i;
+	if (cx < 0 || cz < 0 || cx >= far_cellsX || cz >= far_cellsZ) return (float)max(0, Env_SidesHeight);
+
+	i = cz * FAR_MAX_CELLS + cx;
+	if (far_heights[i] == -1) return 0;
+	return far_heights[i] + Blocks.MaxBB[far_blocks[i]].y - FAR_SINK;
+}
+
+static void FarTerrain_DrawTop(float x1, float z1, float x2, float z2, float y, PackedCol col, struct VertexColoured** vertices) {
+	struct VertexColoured* v = *vertices;
+	v->x = x1; v->y = y; v->z = z1; v->Col = col; v++;
+	v->x = x1; v->y = y; v->z = z2; v->Col = col; v++;
+	v->x = x2; v->y = y; v->z = z2; v->Col = col; v++;
+	v->x = x2; v->y = y; v->z = z1; v->Col = col; v++;
+	*vertices = v;
+}
+
+static void FarTerrain_DrawSide(float x1, float z1, float x2, float z2, float y1, float y2, PackedCol col, struct VertexColoured** vertices) {
+	struct VertexColoured* v = *vertices;
+	v->x = x1; v->y = y1; v->z = z1; v->Col = col; v++;
+	v->x = x1; v->y = y2; v->z = z1; v->Col = col; v++;
+	v->x = x2; v->y = y2; v->z = z2; v->Col = col; v++;
+	v->x = x2; v->y = y1; v->z = z2; v->Col = col; v++;
+	*vertices = v;
+}
+
+/* Whether the given cell is close enough to the camera that chunks are drawn there instead */
+static cc_bool FarTerrain_IsCellNear(int cx, int cz, float top, float nearDistSqr) {
+	float dx = (cx + 0.5f) * far_cellSize - Camera.CurrentPos.x;
+	float dy = top                         - Camera.CurrentPos.y;
+	float dz = (cz + 0.5f) * far_cellSize - Camera.CurrentPos.z;
+	return dx * dx + dy * dy + dz * dz < nearDistSqr;
+}
+
+/* Returns the squared distance within which cells overlap chunks that may be drawn */
+static float FarTerrain_CalcNearDistSqr(void) {
+	/* Chunks are drawn when their centre is within view distance + 24, */
+	/*  so a cell must be at least one cell further away than the edge of the furthest chunks */
+	float dist = (float)(Utils_AdjViewDist(Game_ViewDistance) + 24 + HALF_CHUNK_SIZE + far_cellSize);
+	return dist * dist;
+}
+
+/* Draws (or just counts if vertices is NULL) the vertices of all the cells in the given region */
+static int FarTerrain_MakeRegion(int rx, int rz, struct VertexColoured* v, int* skipped) {
+	int cx1 = rx * FAR_REGION_CELLS, cx2 = min(cx1 + FAR_REGION_CELLS, far_cellsX);
+	int cz1 = rz * FAR_REGION_CELLS, cz2 = min(cz1 + FAR_REGION_CELLS, far_cellsZ);
+	float nearDistSqr = FarTerrain_CalcNearDistSqr();
+	float x1, z1, x2, z2, top, other;
+	int cx, cz, count = 0;
+	BlockID block;
+
+	*skipped = 0;
+	for (cz = cz1; cz < cz2; cz++) {
+		for (cx = cx1; cx < cx2; cx++) 
+		{
+			if (far_heights[cz * FAR_MAX_CELLS + cx] == -1) continue;
+			top = FarTerrain_CellTop(cx, cz);
+			if (FarTerrain_IsCellNear(cx, cz, top, nearDistSqr)) { (*skipped)++; continue; }
+
+			block = far_blocks[cz * FAR_MAX_CELLS + cx];
+			x1 = (float)(cx * far_cellSize); x2 = (float)min((cx + 1) * far_cellSize, World.Width);
+			z1 = (float)(cz * far_cellSize); z2 = (float)min((cz + 1) * far_cellSize, World.Length);
+
+			count += 4;
+			if (v) FarTerrain_DrawTop(x1, z1, x2, z2, top, FarTerrain_GetColor(block, FACE_YMAX, Env.SunCol), &v);
+
+			/* Sides are only needed where the neighbouring cell is lower */
+			if ((other = FarTerrain_CellTop(cx - 1, cz)) < top) {
+				count += 4;
+				if (v) FarTerrain_DrawSide(x1, z1, x1, z2, other, top, FarTerrain_GetColor(block, FACE_XMIN, Env.SunXSide), &v);
+			}
+			if ((other = FarTerrain_CellTop(cx + 1, cz)) < top) {
+				count += 4;
+				if (v) FarTerrain_DrawSide(x2, z1, x2, z2, other, top, FarTerrain_GetColor(block, FACE_XMAX, Env.SunXSide), &v);
+			}
+			if ((other = FarTerrain_CellTop(cx, cz - 1)) < top) {
+				count += 4;
+				if (v) FarTerrain_DrawSide(x1, z1, x2, z1, other, top, FarTerrain_GetColor(block, FACE_ZMIN, Env.SunZSide), &v);
+			}
+			if ((other = FarTerrain_CellTop(cx, cz + 1)) < top) {
+				count += 4;
+				if (v) FarTerrain_DrawSide(x1, z2, x2, z2, other, top, FarTerrain_GetColor(block, FACE_ZMAX, Env.SunZSide), &v);
+			}
+		}
+	}
+	return count;
+}
+
+static void FarTerrain_BuildRegion(int rx, int rz) {
+	struct FarRegion* region = &far_regions[rz * FAR_MAX_REGIONS + rx];
+	struct VertexColoured* data;
+	int skipped;
+
+	region->dirty = false;
+	Gfx_DeleteVb(&region->vb);
+	region->count = FarTerrain_MakeRegion(rx, rz, NULL, &region->skipped);
+	if (!region->count) return;
+
+	data = (struct VertexColoured*)Gfx_RecreateAndLockVb(&region->vb,
+										VERTEX_FORMAT_COLOURED, region->count);
+	FarTerrain_MakeRegion(rx, rz, data, &skipped);
+	Gfx_UnlockVb(region->vb);
+}
+
+static void FarTerrain_MarkAllDirty(void) {
+	int i;
+	for (i = 0; i < Array_Elems(far_regions); i++) far_regions[i].dirty = true;
+}
+
+static void FarTerrain_Init(void) {
+	int cx, cz;
+	far_cellSize = 4;
+	while (Math_CeilDiv(max(World.Width, World.Length), far_cellSize) > FAR_MAX_CELLS) far_cellSize *= 2;
+
+	far_cellsX   = Math_CeilDiv(World.Width,  far_cellSize);
+	far_cellsZ   = Math_CeilDiv(World.Length, far_cellSize);
+	far_regionsX = Math_CeilDiv(far_cellsX, FAR_REGION_CELLS);
+	far_regionsZ = Math_CeilDiv(far_cellsZ, FAR_REGION_CELLS);
+
+	for (cz = 0; cz < far_cellsZ; cz++) {
+		for (cx = 0; cx < far_cellsX; cx++) FarTerrain_CalcCell(cx, cz);
+	}
+	FarTerrain_MarkAllDirty();
+	far_lastCell = IVec3_MaxValue();
+	far_ready    = true;
+}
+
+/* Marks regions whose cells may have switched between being drawn as chunks or as far terrain */
+static void FarTerrain_CheckCamera(void) {
+	float nearDistSqr = FarTerrain_CalcNearDistSqr();
+	struct FarRegion* region;
+	float dx, dz, minDistSqr, maxDistSqr, size;
+	int rx, rz, cells;
+	IVec3 cell;
+
+	cell.x = Math_Floor(Camera.CurrentPos.x / far_cellSize);
+	cell.y = Math_Floor(Camera.CurrentPos.y / far_cellSize);
+	cell.z = Math_Floor(Camera.CurrentPos.z / far_cellSize);
+
+	if (cell.x == far_lastCell.x && cell.y == far_lastCell.y && cell.z == far_lastCell.z) return;
+	far_lastCell = cell;
+
+	size = (float)(FAR_REGION_CELLS * far_cellSize);
+	for (rz = 0; rz < far_regionsZ; rz++) {
+		for (rx = 0; rx < far_regionsX; rx++) 
+		{
+			region = &far_regions[rz * FAR_MAX_REGIONS + rx];
+			cells  = FAR_REGION_CELLS * FAR_REGION_CELLS;
+
+			/* Horizontal distance from camera to nearest and furthest point of the region */
+			dx = Math_AbsF(Camera.CurrentPos.x - (rx + 0.5f) * size);
+			dz = Math_AbsF(Camera.CurrentPos.z - (rz + 0.5f) * size);
+			maxDistSqr = (dx + size * 0.5f) * (dx + size * 0.5f) + (dz + size * 0.5f) * (dz + size * 0.5f);
+			dx = max(0.0f, dx - size * 0.5f);
+			dz = max(0.0f, dz - size * 0.5f);
+			minDistSqr = dx * dx + dz * dz;
+
+			/* Region was and still is entirely drawn as chunks */
+			if (region->skipped == cells && maxDistSqr < nearDistSqr) continue;
+			if (region->skipped || minDistSqr < nearDistSqr) region->dirty = true;
+		}
+	}
+}
+
+void EnvRenderer_RenderFarTerrain(void) {
+	struct FarRegion* region;
+	float size, half;
+	int rx, rz;
+
+	if (!EnvRenderer_FarDistance || EnvRenderer_FarDistance <= Game_ViewDistance) return;
+	if (!far_ready) {
+		/* Wait until the weather heightmap has been calculated on the background thread */
+		Weather_CheckPrefill();
+		if (prefill_thread) return;
+		if (!Weather_Heightmap) InitWeatherHeightmap();
+		FarTerrain_Init();
+	}
+	FarTerrain_CheckCamera();
+
+	size = (float)(FAR_REGION_CELLS * far_cellSize);
+	half = size * 0.5f;
+	Gfx_SetVertexFormat(VERTEX_FORMAT_COLOURED);
+
+	for (rz = 0; rz < far_regionsZ; rz++) {
+		for (rx = 0; rx < far_regionsX; rx++) 
+		{
+			region = &far_regions[rz * FAR_MAX_REGIONS + rx];
+			if (region->dirty) FarTerrain_BuildRegion(rx, rz);
+			if (!region->vb) continue;
+
+			/* sqrt(2) * half ~ 0.71 * half, plus half the world height */
+			if (!FrustumCulling_SphereInFrustum(rx * size + half, World.Height * 0.5f, rz * size + half,
+				half * 1.42f + World.Height * 0.5f)) continue;
+
+			Gfx_BindVb(region->vb);
+			Gfx_DrawVb_IndexedTris(region->count);
+		}
+	}
+}
+
+static void FarTerrain_OnColumnChanged(int x, int z, int maxY) {
+	int cx, cz, rx, rz;
+	if (!far_ready) return;
+
+	cx = x / far_cellSize; cz = z / far_cellSize;
+	/* Changes below the top of the column have no effect */
+	if (maxY < GetRainTop(x, z)) return;
+
+	FarTerrain_CalcCell(cx, cz);
+	rx = cx / FAR_REGION_CELLS; rz = cz / FAR_REGION_CELLS;
+	far_regions[rz * FAR_MAX_REGIONS + rx].dirty = true;
+
+	/* Neighbouring cells in other regions may need sides added or removed */
+	if (cx % FAR_REGION_CELLS == 0 && rx > 0) 
+		far_regions[rz * FAR_MAX_REGIONS + rx - 1].dirty = true;
+	if (cx % FAR_REGION_CELLS == FAR_REGION_CELLS - 1 && rx < far_regionsX - 1)
+		far_regions[rz * FAR_MAX_REGIONS + rx + 1].dirty = true;
+	if (cz % FAR_REGION_CELLS == 0 && rz > 0) 
+		far_regions[(rz - 1) * FAR_MAX_REGIONS + rx].dirty = true;
+	if (cz % FAR_REGION_CELLS == FAR_REGION_CELLS - 1 && rz < far_regionsZ - 1)
+		far_regions[(rz + 1) * FAR_MAX_REGIONS + rx].dirty = true;
+}
+
+static void FarTerrain_DeleteVbs(void) {
+	int i;
+	for (i = 0; i < Array_Elems(far_regions); i++) 
+	{
+		Gfx_DeleteVb(&far_regions[i].vb);
+		far_regions[i].dirty = true;
+	}
+}
+
+static void FarTerrain_Reset(void) {
+	FarTerrain_DeleteVbs();
+	far_ready = false;
+}
+
+static void FarTerrain_Refresh(void) {
+	Mem_Set(far_texCols, 0, sizeof(far_texCols));
+	FarTerrain_MarkAllDirty();
+}
+
+static void FarTerrain_OnNewMapLoaded(void) {
+	/* Column heights must be known for the entire map */
+	if (EnvRenderer_FarDistance) Weather_StartPrefill();
+}
+
+static void FarTerrain_LoadOptions(void) {
+	EnvRenderer_FarDistance = Options_GetInt(OPT_FAR_TERRAIN_DISTANCE, 0, FAR_MAX_DISTANCE, 0);
+}
+#else
+void EnvRenderer_RenderFarTerrain(void) { }
+static void FarTerrain_OnColumnChanged(int x, int z, int maxY) { }
+static void FarTerrain_DeleteVbs(void) { }
+static void FarTerrain_Reset(void) { }
+static void FarTerrain_Refresh(void) { }
+static void FarTerrain_OnNewMapLoaded(void) { }
+static void FarTerrain_LoadOptions(void) { }
+#endif
+
+
 /*########################################################################################################################*
 *---------------------------------------------------------General---------------------------------------------------------*
 *#########################################################################################################################*/
@@ -815,6 +1417,7 @@ static void DeleteVbs(void) {
 	Gfx_DeleteVb(&sides_vb);
 	Gfx_DeleteVb(&edges_vb);
 	Gfx_DeleteDynamicVb(&weather_vb);
+	FarTerrain_DeleteVbs();
 }
 
 static void OnContextLost(void* obj) {
@@ -836,6 +1439,7 @@ static void UpdateAll(void) {
 	UpdateSky();
 	Gfx_DeleteVb(&skybox_vb);
 	EnvRenderer_UpdateFog();
+	FarTerrain_Refresh();
 
 	Gfx_DeleteDynamicVb(&weather_vb);
 	/* TODO: Unnecessary to delete the weather VB? */
@@ -871,7 +1475,14 @@ static void OnTexturePackChanged(void* obj) {
 	/* TODO: Find better way, really should delete them all here */
 	Gfx_DeleteTexture(&skybox_tex);
 }
-static void OnTerrainAtlasChanged(void* obj) { UpdateBorderTextures(); }
+static void OnTerrainAtlasChanged(void* obj) { 
+	UpdateBorderTextures();
+	FarTerrain_Refresh();
+}
+static void OnBlockDefChanged(void* obj) { 
+	ResetWeatherHeightmap();
+	FarTerrain_Refresh();
+}
 static void OnViewDistanceChanged(void* obj) { UpdateAll(); }
 
 static void OnEnvVariableChanged(void* obj, int envVar) {
@@ -884,8 +1495,13 @@ static void OnEnvVariableChanged(void* obj, int envVar) {
 	} else if (envVar == ENV_VAR_EDGE_HEIGHT || envVar == ENV_VAR_SIDES_OFFSET) {
 		UpdateMapEdges();
 		UpdateMapSides();
+		FarTerrain_Refresh();
+		weather_dirty = true;
+	} else if (envVar == ENV_VAR_WEATHER) {
+		if (Env.Weather != WEATHER_SUNNY) Weather_StartPrefill();
 	} else if (envVar == ENV_VAR_SUN_COLOR) {
 		UpdateMapEdges();
+		FarTerrain_Refresh();
 	} else if (envVar == ENV_VAR_SHADOW_COLOR) {
 		UpdateMapSides();
 	} else if (envVar == ENV_VAR_SKY_COLOR) {
@@ -915,6 +1531,7 @@ static void OnInit(void) {
 	if (flags == -1) flags = 0;
 	EnvRenderer_Legacy  = flags & ENV_LEGACY;
 	EnvRenderer_Minimal = flags & ENV_MINIMAL;
+	FarTerrain_LoadOptions();
 
 #ifndef CC_BUILD_LOW_VRAM
 	TextureEntry_Register(&clouds_entry);
@@ -925,6 +1542,7 @@ static void OnInit(void) {
 
 	Event_Register_(&TextureEvents.PackChanged,  NULL, OnTexturePackChanged);
 	Event_Register_(&TextureEvents.AtlasChanged, NULL, OnTerrainAtlasChanged);
+	Event_Register_(&BlockEvents.BlockDefChanged, NULL, OnBlockDefChanged);
 
 	Event_Register_(&GfxEvents.ViewDistanceChanged, NULL, OnViewDistanceChanged);
 	Event_Register_(&WorldEvents.EnvVarChanged,     NULL, OnEnvVariableChanged);
@@ -932,24 +1550,31 @@ static void OnInit(void) {
 	Event_Register_(&GfxEvents.ContextRecreated,    NULL, OnContextRecreated);
 
 	Game_SetViewDistance(Game_UserViewDistance);
+	/* Projection needs to include far terrain */
+	if (EnvRenderer_FarDistance) Camera_UpdateProjection();
 }
 
 static void OnFree(void) {
 	OnContextLost(NULL);
-	Mem_Free(Weather_Heightmap);
-	Weather_Heightmap = NULL;
+	EnvRenderer_StopWeatherPrefill();
+	FreeWeatherHeightmap();
 }
 
 static void OnReset(void) {
 	Gfx_SetFog(false);
 	DeleteVbs();
 
-	Mem_Free(Weather_Heightmap);
-	Weather_Heightmap = NULL;
+	EnvRenderer_StopWeatherPrefill();
+	FreeWeatherHeightmap();
+	FarTerrain_Reset();
 	lastPos = IVec3_MaxValue();
 }
 
-static void OnNewMapLoaded(void) { OnContextRecreated(NULL); }
+static void OnNewMapLoaded(void) { 
+	OnContextRecreated(NULL);
+	if (Env.Weather != WEATHER_SUNNY) Weather_StartPrefill();
+	FarTerrain_OnNewMapLoaded();
+}
 
 struct IGameComponent EnvRenderer_Component = {
 	OnInit,  /* Init  */
@@ -24,14 +24,22 @@ void EnvRenderer_UpdateFog(void);
 void EnvRenderer_RenderMapSides(void);
 /* Renders flat horizon surrounding map. */
 void EnvRenderer_RenderMapEdges(void);
+/* Renders coarse terrain for the parts of the map past the view distance. */
+void EnvRenderer_RenderFarTerrain(void);
+/* Distance up to which far terrain is rendered. (0 if far terrain is disabled) */
+/* NOTE: Fog and the projection matrix also extend out to this distance. */
+extern int EnvRenderer_FarDistance;
 /* Renders a skybox around the player. */
 void EnvRenderer_RenderSkybox(void);
 /* Whether a skybox should be rendered. */
 cc_bool EnvRenderer_ShouldRenderSkybox(void);
 
 extern cc_int16* Weather_Heightmap;
-/* Called when a block is changed to update internal weather state. */
-void EnvRenderer_OnBlockChanged(int x, int y, int z, BlockID oldBlock, BlockID newBlock);
+/* Called after blocks between minY and maxY in the given column changed, to update internal weather state. */
+void EnvRenderer_OnColumnChanged(int x, int z, int minY, int maxY);
+/* Stops calculating rain heights on the background thread, if currently doing so. */
+/* NOTE: Must be called before the world's blocks are freed. */
+void EnvRenderer_StopWeatherPrefill(void);
 /* Renders rainfall/snowfall weather. */
 void EnvRenderer_RenderWeather(float delta);
 
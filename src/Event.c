@@ -1,7 +1,8 @@
 #include "Event.h"
 #include "Platform.h"
+#include "Funcs.h"
 
-int EventAPIVersion = 4;
+int EventAPIVersion = 5;
 struct _EntityEventsList        EntityEvents;
 struct _TabListEventsList       TabListEvents;
 struct _TextureEventsList       TextureEvents;
@@ -16,6 +17,12 @@ struct _PointerEventsList       PointerEvents;
 struct _ControllerEventsList    ControllerEvents;
 struct _NetEventsList           NetEvents;
 
+/* Batched events, in the order that their handlers are called in by Event_FlushBatched */
+static struct Event_IntBatch* const batchedEvents[] = {
+	&EntityEvents.AddedBatch,  &EntityEvents.RemovedBatch,
+	&TabListEvents.AddedBatch, &TabListEvents.ChangedBatch, &TabListEvents.RemovedBatch
+};
+
 void Event_Register(struct Event_Void* handlers, void* obj, Event_Void_Callback handler) {
 	int i;
 	for (i = 0; i < handlers->Count; i++) {
@@ -53,7 +60,13 @@ void Event_Unregister(struct Event_Void* handlers, void* obj, Event_Void_Callbac
 }
 
 void Event_UnregisterAll(void) {
+	int i;
 	/* NOTE: This MUST be kept in sync with Event.h list of events */
+	for (i = 0; i < Array_Elems(batchedEvents); i++) {
+		batchedEvents[i]->Count   = 0;
+		batchedEvents[i]->NumArgs = 0;
+	}
+
 	EntityEvents.Added.Count   = 0;
 	EntityEvents.Removed.Count = 0;
 
@@ -201,3 +214,41 @@ void Event_RaiseLightingMode(struct Event_LightingMode* handlers, cc_uint8 oldMo
 		handlers->Handlers[i](handlers->Objs[i], oldMode, fromServer);
 	}
 }
+
+
+/*########################################################################################################################*
+*-----------------------------------------------------Batched events------------------------------------------------------*
+*#########################################################################################################################*/
+static void Event_FlushIntBatch(struct Event_IntBatch* handlers) {
+	int args[EVENT_MAX_BATCHED];
+	int i, count = handlers->NumArgs;
+	if (!count) return;
+
+	/* Handlers might raise the event again, so need to copy the args */
+	Mem_Copy(args, handlers->Args, count * sizeof(int));
+	handlers->NumArgs = 0;
+
+	for (i = 0; i < handlers->Count; i++) {
+		handlers->Handlers[i](handlers->Objs[i], args, count);
+	}
+}
+
+void Event_RaiseIntBatch(struct Event_IntBatch* handlers, int arg) {
+	int i;
+	if (!handlers->Count) return;
+
+	for (i = 0; i < handlers->NumArgs; i++) {
+		if (handlers->Args[i] == arg) return;
+	}
+
+	/* Call handlers early, rather than dropping the argument */
+	if (handlers->NumArgs == EVENT_MAX_BATCHED) Event_FlushIntBatch(handlers);
+	handlers->Args[handlers->NumArgs++] = arg;
+}
+
+void Event_FlushBatched(void) {
+	int i;
+	for (i = 0; i < Array_Elems(batchedEvents); i++) {
+		Event_FlushIntBatch(batchedEvents[i]);
+	}
+}
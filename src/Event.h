@@ -85,6 +85,19 @@ struct Event_LightingMode {
 	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
 };
 
+/* Max distinct arguments a batched event collects before its handlers are called early */
+#define EVENT_MAX_BATCHED 256
+/* Instead of being called every time the event is raised, handlers of a batched event are called */
+/*  once per frame with all the distinct arguments the event was raised with during that frame */
+/* NOTE: By the time handlers are called, state may have changed again since the event was raised */
+/*  (e.g. an entity may be added then removed), so handlers should check the current state */
+typedef void (*Event_IntBatch_Callback)(void* obj, const int* args, int count);
+struct Event_IntBatch {
+	Event_IntBatch_Callback Handlers[EVENT_MAX_CALLBACKS];
+	void* Objs[EVENT_MAX_CALLBACKS]; int Count;
+	int Args[EVENT_MAX_BATCHED]; int NumArgs;
+};
+
 /* Registers a callback function for the given event. */
 /* NOTE: Trying to register a callback twice or over EVENT_MAX_CALLBACKS callbacks will terminate the game. */
 CC_API void Event_Register(struct Event_Void* handlers,   void* obj, Event_Void_Callback handler);
@@ -123,6 +136,13 @@ void Event_RaisePluginMessage(struct Event_PluginMessage* handlers, cc_uint8 cha
 /* Calls all registered callbacks for an event called when the Lighting_LightingMode is changed */
 void Event_RaiseLightingMode(struct Event_LightingMode* handlers, cc_uint8 oldMode, cc_bool fromServer);
 
+/* Adds an argument for the handlers of a batched event to be called with on the next Event_FlushBatched. */
+/* NOTE: Does nothing if there are no handlers, or the argument was already added since the last flush */
+CC_API void Event_RaiseIntBatch(struct Event_IntBatch* handlers, int arg);
+/* Calls the handlers of all batched events with the arguments they were raised with since the last flush. */
+/* NOTE: This is called once per frame, after network packets and scheduled tasks are processed */
+void Event_FlushBatched(void);
+
 void Event_UnregisterAll(void);
 /* NOTE: Event_UnregisterAll MUST be updated when events lists are changed */
 
@@ -131,6 +151,7 @@ void Event_UnregisterAll(void);
 /*  Version 2 - Added WindowEvents.Redrawing */
 /*  Version 3 - Changed InputEvent.Press from code page 437 to unicode character */
 /*  Version 4 - Added InputEvents.Down2 and InputEvents.Up2 */
+/*  Version 5 - Added batched versions of EntityEvents and TabListEvents */
 /* You MUST CHECK the event API version before attempting to use the events listed above, */
 /*  as otherwise if the player is using an older client that lacks some of the above events, */
 /*  you will be calling Event_Register on random data instead of the expected EventsList struct */
@@ -139,12 +160,17 @@ CC_VAR extern int EventAPIVersion;
 CC_VAR extern struct _EntityEventsList {
 	struct Event_Int Added;    /* Entity is spawned in the current world */
 	struct Event_Int Removed;  /* Entity is despawned from the current world */
+	struct Event_IntBatch AddedBatch;   /* Batched version of Added (Args are entity IDs) */
+	struct Event_IntBatch RemovedBatch; /* Batched version of Removed (Args are entity IDs) */
 } EntityEvents;
 
 CC_VAR extern struct _TabListEventsList {
 	struct Event_Int Added;   /* Tab list entry is created */
 	struct Event_Int Changed; /* Tab list entry is modified */
 	struct Event_Int Removed; /* Tab list entry is removed */
+	struct Event_IntBatch AddedBatch;   /* Batched version of Added (Args are entity IDs) */
+	struct Event_IntBatch ChangedBatch; /* Batched version of Changed (Args are entity IDs) */
+	struct Event_IntBatch RemovedBatch; /* Batched version of Removed (Args are entity IDs) */
 } TabListEvents;
 
 CC_VAR extern struct _TextureEventsList {
@@ -551,6 +551,8 @@ static void LightHint(int startX, int startY, int startZ) {
 
 void FancyLighting_SetActive(void) {
 	Lighting.OnBlockChanged = OnBlockChanged;
+	/* Light propagation must see every block change, in the order they happen */
+	Lighting.OnColumnChanged = NULL;
 	Lighting.Refresh = Refresh;
 	Lighting.IsLit = IsLit;
 	Lighting.Color = Color;
@@ -16,6 +16,7 @@
 #include "Chat.h"
 #include "TexturePack.h"
 #include "Utils.h"
+#include "Options.h"
 
 #ifdef CC_BUILD_FILESYSTEM
 static struct LocationUpdate* spawn_point;
@@ -1856,6 +1857,339 @@ cc_result Dat_Save(struct Stream* stream) {
 }
 
 
+/*########################################################################################################################*
+*--------------------------------------------------------Map saving-------------------------------------------------------*
+*#########################################################################################################################*/
+MapExportFunc MapExporter_Find(const cc_string* path) {
+	static const cc_string schematic = String_FromConst(".schematic");
+	static const cc_string mine      = String_FromConst(".mine");
+
+	if (String_CaselessEnds(path, &schematic)) return Schematic_Save;
+	if (String_CaselessEnds(path, &mine))      return Dat_Save;
+	return Cw_Save;
+}
+
+/* The world is first exported uncompressed into memory, which is just a copy of the blocks array */
+/* plus a few KB of metadata. Compressing and writing the file is then done on a background thread */
+/* NOTE: The map is written to a temp file first, then renamed to replace the destination file */
+struct MapSaveJob {
+	struct MapSaveJob* next;
+	cc_uint8* data;
+	cc_uint32 length, fileSize;
+	cc_uint64 beg;
+	int elapsedMS;
+	cc_result res;
+	const char* failedAction;
+	cc_bool autosave;
+	int mapGeneration;
+	cc_string path; char pathBuffer[FILENAME_SIZE];
+};
+/* Incremented whenever a new map starts loading, so completed saves of an older world can be detected */
+static int mapGeneration;
+
+static cc_result GrowableMem_Write(struct Stream* s, const cc_uint8* data, cc_uint32 count, cc_uint32* modified) {
+	cc_uint32 used = s->meta.mem.length - s->meta.mem.left;
+	cc_uint32 size;
+	cc_uint8* ptr;
+
+	if (count > s->meta.mem.left) {
+		size = max(s->meta.mem.length * 2, used + count);
+		ptr  = (cc_uint8*)Mem_TryRealloc(s->meta.mem.base, size, 1);
+		if (!ptr) return ERR_OUT_OF_MEMORY;
+
+		s->meta.mem.base   = ptr;
+		s->meta.mem.cur    = ptr + used;
+		s->meta.mem.left   = size - used;
+		s->meta.mem.length = size;
+	}
+
+	Mem_Copy(s->meta.mem.cur, data, count);
+	s->meta.mem.cur  += count;
+	s->meta.mem.left -= count;
+	*modified = count;
+	return 0;
+}
+
+static cc_result MapSave_Snapshot(struct MapSaveJob* job) {
+	struct Stream stream;
+	cc_uint32 size = World.Volume + 64 * 1024;
+	cc_result res;
+#ifdef EXTENDED_BLOCKS
+	/* Upper 8 bits of block IDs are also saved when using more than 256 blocks */
+	if (World.Blocks != World.Blocks2) size += World.Volume;
+#endif
+
+	Stream_Init(&stream);
+	stream.Write = GrowableMem_Write;
+	stream.meta.mem.base = (cc_uint8*)Mem_TryAlloc(size, 1);
+	if (!stream.meta.mem.base) return ERR_OUT_OF_MEMORY;
+
+	stream.meta.mem.cur    = stream.meta.mem.base;
+	stream.meta.mem.left   = size;
+	stream.meta.mem.length = size;
+
+	res = MapExporter_Find(&job->path)(&stream);
+	if (res) { Mem_Free(stream.meta.mem.base); return res; }
+
+	job->data   = stream.meta.mem.base;
+	job->length = stream.meta.mem.length - stream.meta.mem.left;
+	return 0;
+}
+
+static void MapSave_Write(struct MapSaveJob* job) {
+	cc_string tmp; char tmpBuffer[FILENAME_SIZE];
+	struct Stream stream, compStream;
+	struct GZipState* state;
+	cc_result res;
+#ifdef CC_BUILD_FILE_RENAME
+	cc_filepath src, dst;
+
+	String_InitArray(tmp, tmpBuffer);
+	String_Format1(&tmp, "%s.tmp", &job->path);
+#else
+	tmp = job->path;
+#endif
+
+	state = (struct GZipState*)Mem_TryAlloc(1, sizeof(struct GZipState));
+	if (!state) { job->res = ERR_OUT_OF_MEMORY; job->failedAction = "allocating temp memory for"; return; }
+
+	res = Stream_CreateFile(&stream, &tmp);
+	if (res) { job->res = res; job->failedAction = "creating"; Mem_Free(state); return; }
+	GZip_MakeStream(&compStream, state, &stream);
+
+	if ((res = Stream_Write(&compStream, job->data, job->length))) {
+		job->failedAction = "encoding";
+	} else if ((res = compStream.Close(&compStream))) {
+		job->failedAction = "closing";
+	}
+	Mem_Free(state);
+
+	if (res) { job->res = res; stream.Close(&stream); return; }
+	stream.Length(&stream, &job->fileSize);
+
+	res = stream.Close(&stream);
+	if (res) { job->res = res; job->failedAction = "closing"; return; }
+
+#ifdef CC_BUILD_FILE_RENAME
+	Platform_EncodePath(&src, &tmp);
+	Platform_EncodePath(&dst, &job->path);
+	res = File_Rename(&src, &dst);
+	if (res) { job->res = res; job->failedAction = "replacing"; }
+#endif
+}
+
+static void MapSave_Finish(struct MapSaveJob* job) {
+	Mem_Free(job->data);
+	job->data      = NULL;
+	job->elapsedMS = Stopwatch_ElapsedMS(job->beg, Stopwatch_Measure());
+}
+
+static void MapSave_Report(struct MapSaveJob* job) {
+	int sizeKB = (int)(job->fileSize / 1024);
+
+	if (job->res) {
+		Logger_SysWarn2(job->res, job->failedAction, &job->path);
+	} else if (job->autosave) {
+		Chat_Add3("&eAutosaved map to: %s &7(%i KB, took %i ms)", &job->path, &sizeKB, &job->elapsedMS);
+	} else {
+		Chat_Add3("&eSaved map to: %s &7(%i KB, took %i ms)", &job->path, &sizeKB, &job->elapsedMS);
+		/* Only counts as saved once the file has actually been written, */
+		/*  and only if it is still the same world that was saved */
+		if (job->mapGeneration == mapGeneration) World.LastSave = Game.Time;
+	}
+	Mem_Free(job);
+}
+
+#ifndef CC_BUILD_COOPTHREADED
+static void* saveThread;
+static void* saveMutex;
+static void* saveWaitable;
+static struct MapSaveJob* savePendingHead;
+static struct MapSaveJob* savePendingTail;
+static struct MapSaveJob* saveDoneHead;
+static struct MapSaveJob* saveDoneTail;
+static int saveActive;
+static cc_bool saveStopping;
+
+static void MapSave_WorkerLoop(void) {
+	struct MapSaveJob* job;
+	cc_bool stopping;
+
+	for (;;) {
+		Mutex_Lock(saveMutex);
+		{
+			job      = savePendingHead;
+			stopping = saveStopping;
+			if (job) {
+				savePendingHead = job->next;
+				if (!savePendingHead) savePendingTail = NULL;
+			}
+		}
+		Mutex_Unlock(saveMutex);
+
+		if (job) {
+			MapSave_Write(job);
+			MapSave_Finish(job);
+			job->next = NULL;
+
+			Mutex_Lock(saveMutex);
+			{
+				LinkedList_Append(job, saveDoneHead, saveDoneTail);
+			}
+			Mutex_Unlock(saveMutex);
+		} else if (stopping) {
+			return;
+		} else {
+			/* Block until main thread submits another map to save */
+			Waitable_Wait(saveWaitable);
+		}
+	}
+}
+
+static void MapSave_Submit(struct MapSaveJob* job) {
+	if (!saveThread) {
+		saveMutex    = Mutex_Create("Map save jobs");
+		saveWaitable = Waitable_Create("Map save wakeup");
+		Thread_Run(&saveThread, MapSave_WorkerLoop, 64 * 1024, "Map saving");
+	}
+
+	Mutex_Lock(saveMutex);
+	{
+		LinkedList_Append(job, savePendingHead, savePendingTail);
+	}
+	Mutex_Unlock(saveMutex);
+
+	saveActive++;
+	Waitable_Signal(saveWaitable);
+}
+
+static struct MapSaveJob* MapSave_TakeDone(void) {
+	struct MapSaveJob* job;
+
+	Mutex_Lock(saveMutex);
+	{
+		job          = saveDoneHead;
+		saveDoneHead = NULL;
+		saveDoneTail = NULL;
+	}
+	Mutex_Unlock(saveMutex);
+	return job;
+}
+
+static void MapSave_Tick(struct ScheduledTask* task) {
+	struct MapSaveJob* job;
+	struct MapSaveJob* next;
+	if (!saveActive) return;
+
+	for (job = MapSave_TakeDone(); job; job = next)
+	{
+		next = job->next;
+		saveActive--;
+		MapSave_Report(job);
+	}
+}
+
+/* Waits for any maps still being written, then stops the background thread */
+static void MapSave_Free(void) {
+	struct MapSaveJob* job;
+	struct MapSaveJob* next;
+	if (!saveThread) return;
+
+	Mutex_Lock(saveMutex);
+	{
+		saveStopping = true;
+	}
+	Mutex_Unlock(saveMutex);
+
+	Waitable_Signal(saveWaitable);
+	Thread_Join(saveThread);
+
+	/* Chat is no longer usable at this point, so only report failures */
+	for (job = MapSave_TakeDone(); job; job = next)
+	{
+		next = job->next;
+		if (job->res) Logger_SysWarn2(job->res, job->failedAction, &job->path);
+		Mem_Free(job);
+	}
+
+	Mutex_Free(saveMutex);
+	Waitable_Free(saveWaitable);
+	saveThread   = NULL;
+	saveActive   = 0;
+	saveStopping = false;
+}
+#else
+static int saveActive;
+
+static void MapSave_Submit(struct MapSaveJob* job) {
+	/* No background threads, so just have to save on the main thread */
+	MapSave_Write(job);
+	MapSave_Finish(job);
+	MapSave_Report(job);
+}
+static void MapSave_Tick(struct ScheduledTask* task) { }
+static void MapSave_Free(void) { }
+#endif
+
+static cc_result MapSave_Create(const cc_string* path, cc_bool autosave, struct MapSaveJob** result) {
+	struct MapSaveJob* job;
+	cc_result res;
+
+	job = (struct MapSaveJob*)Mem_TryAllocCleared(1, sizeof(struct MapSaveJob));
+	if (!job) { 
+		res = ERR_OUT_OF_MEMORY;
+		Logger_SysWarn(res, "allocating temp memory"); return res; 
+	}
+
+	String_InitArray(job->path, job->pathBuffer);
+	String_Copy(&job->path, path);
+	job->autosave      = autosave;
+	job->mapGeneration = mapGeneration;
+	job->beg           = Stopwatch_Measure();
+
+	res = MapSave_Snapshot(job);
+	if (res) { 
+		Logger_SysWarn2(res, "encoding", path); 
+		Mem_Free(job); return res; 
+	}
+
+	*result = job;
+	return 0;
+}
+
+cc_result Map_SaveAsync(const cc_string* path, cc_bool autosave) {
+	struct MapSaveJob* job;
+	cc_result res = MapSave_Create(path, autosave, &job);
+	if (res) return res;
+
+	MapSave_Submit(job);
+	return 0;
+}
+
+cc_result Map_Save(const cc_string* path) {
+	struct MapSaveJob* job;
+	cc_result res = MapSave_Create(path, false, &job);
+	if (res) return res;
+
+	MapSave_Write(job);
+	MapSave_Finish(job);
+	res = job->res;
+
+	MapSave_Report(job);
+	return res;
+}
+
+static void Autosave_Tick(struct ScheduledTask* task) {
+	static const cc_string path = String_FromConst("maps/autosave.cw");
+	if (!Server.IsSinglePlayer || !World.Loaded) return;
+	/* Don't queue up autosaves if writing the previous one is really slow */
+	if (saveActive) return;
+
+	if (!Utils_EnsureDirectory("maps")) return;
+	Map_SaveAsync(&path, true);
+}
+
+
 /*########################################################################################################################*
 *-------------------------------------------------------Formats component-------------------------------------------------*
 *#########################################################################################################################*/
@@ -1867,6 +2201,10 @@ static struct MapImporter fcm_imp   = { ".fcm",     Fcm_Load };
 static struct MapImporter mclvl_imp = { ".mclevel", MCLevel_Load };
 
 static void OnInit(void) {
+	int autosaveMins = Options_GetInt(OPT_AUTOSAVE_INTERVAL, 0, 1440, 0);
+	ScheduledTask_Add(GAME_DEF_TICKS, MapSave_Tick);
+	if (autosaveMins) ScheduledTask_Add(autosaveMins * 60, Autosave_Tick);
+
 	MapImporter_Register(&cw_imp);
 	MapImporter_Register(&dat_imp);
 	MapImporter_Register(&lvl_imp);
@@ -1875,8 +2213,11 @@ static void OnInit(void) {
 	MapImporter_Register(&mclvl_imp);
 }
 
+static void OnNewMap(void) { mapGeneration++; }
+
 static void OnFree(void) {
 	imp_head = NULL;
+	MapSave_Free();
 }
 #else
 /* No point including map format code when can't save/load maps anyways */
@@ -1887,11 +2228,18 @@ cc_result Cw_Save(struct Stream* stream)  { return ERR_NOT_SUPPORTED; }
 cc_result Dat_Save(struct Stream* stream) { return ERR_NOT_SUPPORTED; }
 cc_result Schematic_Save(struct Stream* stream) { return ERR_NOT_SUPPORTED; }
 
+MapExportFunc MapExporter_Find(const cc_string* path) { return Cw_Save; }
+cc_result Map_SaveAsync(const cc_string* path, cc_bool autosave) { return ERR_NOT_SUPPORTED; }
+cc_result Map_Save(const cc_string* path) { return ERR_NOT_SUPPORTED; }
+
 static void OnInit(void) { }
 static void OnFree(void) { }
+static void OnNewMap(void) { }
 #endif
 
 struct IGameComponent Formats_Component = {
-	OnInit, /* Init  */
-	OnFree  /* Free  */
+	OnInit,  /* Init  */
+	OnFree,  /* Free  */
+	NULL,    /* Reset */
+	OnNewMap /* OnNewMap */
 };
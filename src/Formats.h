@@ -39,5 +39,17 @@ cc_result Schematic_Save(struct Stream* stream);
 /* Used by MineCraft Classic */
 cc_result Dat_Save(struct Stream* stream);
 
+/* Exports a world encoded in a particular map file format */
+typedef cc_result (*MapExportFunc)(struct Stream* stream);
+/* Returns the exporter for the map format matching the filename */
+/* Returns Cw_Save if no match found */
+MapExportFunc MapExporter_Find(const cc_string* path);
+/* Saves the world to the given file, using MapExporter_Find to decide the format */
+/* The world is copied immediately, then compressed and written on a background thread */
+/* NOTE: Once the file has been written, the result is reported in chat */
+cc_result Map_SaveAsync(const cc_string* path, cc_bool autosave);
+/* Same as Map_SaveAsync, except that the file is written before this returns */
+cc_result Map_Save(const cc_string* path);
+
 CC_END_HEADER
 #endif
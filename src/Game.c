@@ -41,6 +41,7 @@
 #include "SystemFonts.h"
 #include "Formats.h"
 #include "EntityRenderers.h"
+#include "Errors.h"
 
 struct _GameData Game;
 static cc_uint64 frameStart;
@@ -196,15 +197,178 @@ void Game_Reset(void) {
 	}
 }
 
+/* Block changes are processed in batches. The blocks are all changed first, and then */
+/*  the lighting and rain heights of each changed column and each affected chunk are */
+/*  only updated once, instead of once for every changed block. */
+#define BATCH_MAX_BLOCKS 256
+/* Changed blocks may also affect neighbouring chunks, if on the edge of a chunk */
+#define BATCH_MAX_CHUNKS (BATCH_MAX_BLOCKS * 4)
+/* Hash tables have at least twice as many slots as the maximum number of entries */
+#define BATCH_HASH_BITS  11
+#define BATCH_HASH_SIZE  (1 << BATCH_HASH_BITS)
+
+struct BatchColumn { int key, slot, x, z, minY, maxY; };
+struct BatchChunk  { int key, slot, cx, cy, cz; cc_bool allAir; };
+
+static struct BatchColumn batch_columns[BATCH_MAX_BLOCKS];
+static struct BatchChunk  batch_chunks[BATCH_MAX_CHUNKS];
+static int batch_numBlocks, batch_numColumns, batch_numChunks;
+/* Hash tables of 1 + index of the entry for a key (0 means empty slot) */
+static cc_uint16 batch_columnSlots[BATCH_HASH_SIZE];
+static cc_uint16 batch_chunkSlots[BATCH_HASH_SIZE];
+static IVec3 batch_min, batch_max;
+
+/* Returns the slot of the entry with the given key, or an empty slot to insert it in */
+#define Batch_FindSlot(slots, entries, key, slot) \
+	slot = (int)(((cc_uint32)(key) * 2654435761U) >> (32 - BATCH_HASH_BITS)); \
+	while (slots[slot] && entries[slots[slot] - 1].key != (key)) { slot = (slot + 1) & (BATCH_HASH_SIZE - 1); }
+
+static void Batch_AddColumn(int x, int y, int z) {
+	struct BatchColumn* col;
+	int key = x + z * World.Width, slot;
+	Batch_FindSlot(batch_columnSlots, batch_columns, key, slot);
+
+	if (batch_columnSlots[slot]) {
+		col = &batch_columns[batch_columnSlots[slot] - 1];
+		col->minY = min(col->minY, y);
+		col->maxY = max(col->maxY, y);
+		return;
+	}
+
+	col = &batch_columns[batch_numColumns++];
+	col->key  = key;  col->slot = slot;
+	col->x    = x;    col->z    = z;
+	col->minY = y;    col->maxY = y;
+	batch_columnSlots[slot] = batch_numColumns;
+}
+
+static void Batch_AddChunk(int cx, int cy, int cz, cc_bool allAir) {
+	struct BatchChunk* chunk;
+	int key = World_ChunkPack(cx, cy, cz), slot;
+	Batch_FindSlot(batch_chunkSlots, batch_chunks, key, slot);
+
+	if (batch_chunkSlots[slot]) {
+		batch_chunks[batch_chunkSlots[slot] - 1].allAir &= allAir;
+		return;
+	}
+
+	chunk = &batch_chunks[batch_numChunks++];
+	chunk->key = key; chunk->slot = slot;
+	chunk->cx  = cx;  chunk->cy   = cy; chunk->cz = cz;
+	chunk->allAir = allAir;
+	batch_chunkSlots[slot] = batch_numChunks;
+}
+
+/* Whether a change to the given block may affect how the neighbouring block is drawn */
+/*  (only the case where neither does is an opaque block next to an invisible block) */
+#define Batch_AffectsNeighbour(block, other) (Blocks.Draw[block] != DRAW_OPAQUE || Blocks.Draw[other] != DRAW_GAS)
+
+/* Records that the block at the given coordinates was changed from old to now */
+static void Batch_AddBlock(int x, int y, int z, BlockID old, BlockID now) {
+	int cx = x >> CHUNK_SHIFT, bX = x & CHUNK_MASK;
+	int cy = y >> CHUNK_SHIFT, bY = y & CHUNK_MASK;
+	int cz = z >> CHUNK_SHIFT, bZ = z & CHUNK_MASK;
+
+	/* Lighting engine may need to see the world as it was straight after this change */
+	if (!Lighting.OnColumnChanged) Lighting.OnBlockChanged(x, y, z, old, now);
+	Batch_AddColumn(x, y, z);
+	Batch_AddChunk(cx, cy, cz, Blocks.Draw[now] == DRAW_GAS);
+
+	/* Faces of blocks in neighbouring chunks may need to be shown or hidden */
+	if (bX == 0  && x > 0           && Batch_AffectsNeighbour(now, World_GetBlock(x - 1, y, z)))
+		Batch_AddChunk(cx - 1, cy, cz, true);
+	if (bX == 15 && x < World.MaxX  && Batch_AffectsNeighbour(now, World_GetBlock(x + 1, y, z)))
+		Batch_AddChunk(cx + 1, cy, cz, true);
+	if (bY == 0  && y > 0           && Batch_AffectsNeighbour(now, World_GetBlock(x, y - 1, z)))
+		Batch_AddChunk(cx, cy - 1, cz, true);
+	if (bY == 15 && y < World.MaxY  && Batch_AffectsNeighbour(now, World_GetBlock(x, y + 1, z)))
+		Batch_AddChunk(cx, cy + 1, cz, true);
+	if (bZ == 0  && z > 0           && Batch_AffectsNeighbour(now, World_GetBlock(x, y, z - 1)))
+		Batch_AddChunk(cx, cy, cz - 1, true);
+	if (bZ == 15 && z < World.MaxZ  && Batch_AffectsNeighbour(now, World_GetBlock(x, y, z + 1)))
+		Batch_AddChunk(cx, cy, cz + 1, true);
+
+	if (!batch_numBlocks) {
+		batch_min.x = x; batch_min.y = y; batch_min.z = z;
+		batch_max = batch_min;
+	} else {
+		batch_min.x = min(batch_min.x, x); batch_max.x = max(batch_max.x, x);
+		batch_min.y = min(batch_min.y, y); batch_max.y = max(batch_max.y, y);
+		batch_min.z = min(batch_min.z, z); batch_max.z = max(batch_max.z, z);
+	}
+	batch_numBlocks++;
+}
+
+/* Updates state associated with all of the blocks changed in the batch */
+static void Batch_Flush(void) {
+	struct BatchColumn* col;
+	struct BatchChunk* chunk;
+	int i;
+	if (!batch_numBlocks) return;
+
+	for (i = 0; i < batch_numColumns; i++) 
+	{
+		col = &batch_columns[i];
+		batch_columnSlots[col->slot] = 0;
+
+		if (Lighting.OnColumnChanged) {
+			Lighting.OnColumnChanged(col->x, col->z, col->minY, col->maxY);
+		}
+		if (Weather_Heightmap) {
+			EnvRenderer_OnColumnChanged(col->x, col->z, col->minY, col->maxY);
+		}
+	}
+
+	for (i = 0; i < batch_numChunks; i++) 
+	{
+		chunk = &batch_chunks[i];
+		batch_chunkSlots[chunk->slot] = 0;
+		MapRenderer_OnChunkChanged(chunk->cx, chunk->cy, chunk->cz, chunk->allAir);
+	}
+
+	EntityShadows_OnBlocksChanged(&batch_min, &batch_max);
+	Searcher_OnBlocksChanged(&batch_min, &batch_max);
+	batch_numBlocks  = 0;
+	batch_numColumns = 0;
+	batch_numChunks  = 0;
+}
+
 void Game_UpdateBlock(int x, int y, int z, BlockID block) {
 	BlockID old = World_GetBlock(x, y, z);
 	World_SetBlock(x, y, z, block);
 
-	if (Weather_Heightmap) {
-		EnvRenderer_OnBlockChanged(x, y, z, old, block);
+	Batch_AddBlock(x, y, z, old, block);
+	Batch_Flush();
+}
+
+void Game_UpdateBlocks(const cc_int32* indices, const BlockID* blocks, int count) {
+	int i, index, last = -2;
+	int x = 0, y = 0, z = 0;
+	BlockID old, block;
+
+	for (i = 0; i < count; i++) 
+	{
+		index = indices[i];
+		if (index < 0 || index >= World.Volume) continue;
+
+		/* Bulk updates are often runs of consecutive indices (e.g. /cuboid), */
+		/*  so avoid the divisions in World_Unpack for those */
+		if (index == last + 1 && x < World.MaxX) {
+			x++;
+		} else {
+			World_Unpack(index, x, y, z);
+		}
+		last = index;
+
+		block = blocks[i];
+		old   = World_GetBlock(x, y, z);
+		if (old == block) continue;
+		World_SetBlock(x, y, z, block);
+
+		Batch_AddBlock(x, y, z, old, block);
+		if (batch_numBlocks == BATCH_MAX_BLOCKS) Batch_Flush();
 	}
-	Lighting.OnBlockChanged(x, y, z, old, block);
-	MapRenderer_OnBlockChanged(x, y, z, block);
+	Batch_Flush();
 }
 
 void Game_ChangeBlock(int x, int y, int z, BlockID block) {
@@ -225,7 +389,7 @@ cc_bool Game_UpdateTexture(GfxResourceID* texId, struct Stream* src, const cc_st
 	cc_bool success;
 	cc_result res;
 	
-	res = Png_Decode(&bmp, src);
+	res = TexturePack_DecodePng(&bmp, src);
 	if (res) { Logger_SysWarn2(res, "decoding", file); }
 	
 	/* E.g. gui.png only need top half of the texture loaded */
@@ -526,6 +690,7 @@ static void Render3DFrame(float delta, float t) {
 	EnvRenderer_RenderClouds();
 
 	MapRenderer_Update(delta);
+	EnvRenderer_RenderFarTerrain();
 	MapRenderer_RenderNormal(delta);
 	EnvRenderer_RenderMapSides();
 
@@ -583,22 +748,215 @@ static void PerformScheduledTasks(double time) {
 	}
 }
 
-void Game_TakeScreenshot(void) {
-	cc_string filename; char fileBuffer[STRING_SIZE];
-	cc_string path;     char pathBuffer[FILENAME_SIZE];
+/*########################################################################################################################*
+*--------------------------------------------------------Screenshots------------------------------------------------------*
+*#########################################################################################################################*/
+static void Screenshot_MakeName(cc_string* filename) {
+	static char lastBuffer[STRING_SIZE];
+	static cc_string lastName = String_FromArray(lastBuffer);
+	static int burstIndex;
 	struct cc_datetime now;
+	DateTime_CurrentLocal(&now);
+
+	String_Format3(filename, "screenshot_%p4-%p2-%p2", &now.year, &now.month, &now.day);
+	String_Format3(filename, "-%p2-%p2-%p2", &now.hour, &now.minute, &now.second);
+
+	/* Avoid overwriting earlier screenshots taken within the same second */
+	if (String_Equals(filename, &lastName)) {
+		burstIndex++;
+		String_Format1(filename, "_%i", &burstIndex);
+	} else {
+		burstIndex = 1;
+		String_Copy(&lastName, filename);
+	}
+	String_AppendConst(filename, ".png");
+}
+
+static void Screenshot_Finished(const cc_string* filename) {
+	Chat_Add1("&eTaken screenshot as: %s", filename);
+#ifdef CC_BUILD_MOBILE
+	Platform_ShareScreenshot(filename);
+#endif
+}
+
+#if defined CC_BUILD_GFX_READBACK && !defined CC_BUILD_COOPTHREADED && !defined CC_BUILD_WEB
+#define CC_BUILD_ASYNC_SCREENSHOTS
+/* Only the framebuffer readback happens on the main thread */
+/* PNG filtering/compression and writing the file is done on a background thread */
+struct ScreenshotJob {
+	struct ScreenshotJob* next;
+	struct Bitmap bmp;
+	cc_bool bottomUp;
 	cc_result res;
+	const char* failedAction;
+	cc_string path;     char pathBuffer[FILENAME_SIZE];
+	cc_string filename; char fileBuffer[STRING_SIZE];
+};
+
+static void* ssThread;
+static void* ssMutex;
+static void* ssWaitable;
+static struct ScreenshotJob* ssPendingHead;
+static struct ScreenshotJob* ssPendingTail;
+static struct ScreenshotJob* ssDoneHead;
+static struct ScreenshotJob* ssDoneTail;
+static int ssActive;
+static cc_bool ssStopping;
+
+static BitmapCol* Screenshot_GetRow(struct Bitmap* bmp, int y, void* ctx) {
+	struct ScreenshotJob* job = (struct ScreenshotJob*)ctx;
+	if (job->bottomUp) y = (bmp->height - 1) - y;
+	return Bitmap_GetRow(bmp, y);
+}
+
+static void Screenshot_Encode(struct ScreenshotJob* job) {
+	struct Stream stream;
+	cc_result res;
+
+	res = Stream_CreateFile(&stream, &job->path);
+	if (res) { job->res = res; job->failedAction = "creating"; return; }
+
+	res = Png_Encode(&job->bmp, &stream, Screenshot_GetRow, false, job);
+	if (res) { 
+		job->res = res; job->failedAction = "saving to"; 
+		stream.Close(&stream); return; 
+	}
+
+	res = stream.Close(&stream);
+	if (res) { job->res = res; job->failedAction = "closing"; }
+}
+
+static void Screenshot_WorkerLoop(void) {
+	struct ScreenshotJob* job;
+	cc_bool stopping;
+
+	for (;;) {
+		Mutex_Lock(ssMutex);
+		{
+			job      = ssPendingHead;
+			stopping = ssStopping;
+			if (job) {
+				ssPendingHead = job->next;
+				if (!ssPendingHead) ssPendingTail = NULL;
+			}
+		}
+		Mutex_Unlock(ssMutex);
+
+		if (job) {
+			Screenshot_Encode(job);
+			Mem_Free(job->bmp.scan0);
+			job->bmp.scan0 = NULL;
+			job->next      = NULL;
+
+			Mutex_Lock(ssMutex);
+			{
+				LinkedList_Append(job, ssDoneHead, ssDoneTail);
+			}
+			Mutex_Unlock(ssMutex);
+		} else if (stopping) {
+			return;
+		} else {
+			/* Block until main thread submits another screenshot */
+			Waitable_Wait(ssWaitable);
+		}
+	}
+}
+
+/* Reports the results of screenshots which the background thread has finished saving */
+static void Screenshot_ProcessDone(void) {
+	struct ScreenshotJob* job;
+	struct ScreenshotJob* next;
+
+	Mutex_Lock(ssMutex);
+	{
+		job        = ssDoneHead;
+		ssDoneHead = NULL;
+		ssDoneTail = NULL;
+	}
+	Mutex_Unlock(ssMutex);
+
+	for (; job; job = next)
+	{
+		next = job->next;
+		ssActive--;
+
+		if (job->res) {
+			Logger_SysWarn2(job->res, job->failedAction, &job->path);
+		} else {
+			Screenshot_Finished(&job->filename);
+		}
+		Mem_Free(job);
+	}
+}
+
+static void Screenshot_Submit(const cc_string* filename, const cc_string* path) {
+	struct ScreenshotJob* job;
+	cc_result res;
+
+	job = (struct ScreenshotJob*)Mem_TryAllocCleared(1, sizeof(struct ScreenshotJob));
+	if (!job) { Logger_SysWarn2(ERR_OUT_OF_MEMORY, "saving to", path); return; }
+
+	res = Gfx_ReadFramebuffer(&job->bmp, &job->bottomUp);
+	if (res) { Logger_SysWarn2(res, "saving to", path); Mem_Free(job); return; }
+
+	String_InitArray(job->path,     job->pathBuffer);
+	String_InitArray(job->filename, job->fileBuffer);
+	String_Copy(&job->path,     path);
+	String_Copy(&job->filename, filename);
+
+	if (!ssThread) {
+		ssMutex    = Mutex_Create("Screenshot jobs");
+		ssWaitable = Waitable_Create("Screenshot wakeup");
+		Thread_Run(&ssThread, Screenshot_WorkerLoop, 64 * 1024, "Screenshots");
+	}
+
+	Mutex_Lock(ssMutex);
+	{
+		LinkedList_Append(job, ssPendingHead, ssPendingTail);
+	}
+	Mutex_Unlock(ssMutex);
+
+	ssActive++;
+	Waitable_Signal(ssWaitable);
+}
+
+/* Waits for any screenshots still being saved, then stops the background thread */
+static void Screenshot_Free(void) {
+	if (!ssThread) return;
+
+	Mutex_Lock(ssMutex);
+	{
+		ssStopping = true;
+	}
+	Mutex_Unlock(ssMutex);
+
+	Waitable_Signal(ssWaitable);
+	Thread_Join(ssThread);
+	Screenshot_ProcessDone();
+
+	Mutex_Free(ssMutex);
+	Waitable_Free(ssWaitable);
+	ssThread = NULL;
+	ssStopping = false;
+}
+#else
+static void Screenshot_Free(void) { }
+#endif
+
+void Game_TakeScreenshot(void) {
+	cc_string filename; char fileBuffer[STRING_SIZE];
 #ifdef CC_BUILD_WEB
 	cc_filepath str;
 #else
+	cc_string path;     char pathBuffer[FILENAME_SIZE];
+#ifndef CC_BUILD_ASYNC_SCREENSHOTS
 	struct Stream stream;
+	cc_result res;
+#endif
 #endif
 	Game_ScreenshotRequested = false;
-	DateTime_CurrentLocal(&now);
-
 	String_InitArray(filename, fileBuffer);
-	String_Format3(&filename, "screenshot_%p4-%p2-%p2", &now.year, &now.month, &now.day);
-	String_Format3(&filename, "-%p2-%p2-%p2.png", &now.hour, &now.minute, &now.second);
+	Screenshot_MakeName(&filename);
 
 #ifdef CC_BUILD_WEB
 	extern void interop_TakeScreenshot(const char* path);
@@ -609,6 +967,9 @@ void Game_TakeScreenshot(void) {
 	String_InitArray(path, pathBuffer);
 	String_Format1(&path, "screenshots/%s", &filename);
 
+#ifdef CC_BUILD_ASYNC_SCREENSHOTS
+	Screenshot_Submit(&filename, &path);
+#else
 	res = Stream_CreateFile(&stream, &path);
 	if (res) { Logger_SysWarn2(res, "creating", &path); return; }
 
@@ -619,10 +980,7 @@ void Game_TakeScreenshot(void) {
 
 	res = stream.Close(&stream);
 	if (res) { Logger_SysWarn2(res, "closing", &path); return; }
-	Chat_Add1("&eTaken screenshot as: %s", &filename);
-
-#ifdef CC_BUILD_MOBILE
-	Platform_ShareScreenshot(&filename);
+	Screenshot_Finished(&filename);
 #endif
 #endif
 }
@@ -692,7 +1050,10 @@ static CC_INLINE void Game_DrawFrame(float delta, float t) {
 	Gui_RenderGui(delta);
 	for (i = 0; i < Array_Elems(Game.Draw2DHooks); i++)
 	{
-		if (Game.Draw2DHooks[i]) Game.Draw2DHooks[i](delta);
+		if (!Game.Draw2DHooks[i]) continue;
+		/* Hooks may draw directly instead of through the 2D batch */
+		Gfx_Flush2D();
+		Game.Draw2DHooks[i](delta);
 	}
 
 /* TODO find a better solution than this */
@@ -787,6 +1148,7 @@ static CC_INLINE void Game_RenderFrame(void) {
 	}
 
 	PerformScheduledTasks(deltaD);
+	Event_FlushBatched();
 	entTask = tasks[entTaskI];
 	t = (float)(entTask.accumulator / entTask.interval);
 	LocalPlayer_SetInterpPosition(Entities.CurPlayer, t);
@@ -825,6 +1187,9 @@ static CC_INLINE void Game_RenderFrame(void) {
 #endif
 
 	if (Game_ScreenshotRequested) Game_TakeScreenshot();
+#ifdef CC_BUILD_ASYNC_SCREENSHOTS
+	if (ssActive) Screenshot_ProcessDone();
+#endif
 	Gfx_EndFrame();
 	if (gfx_minFrameMs) LimitFPS();
 }
@@ -832,6 +1197,7 @@ static CC_INLINE void Game_RenderFrame(void) {
 
 static void Game_Free(void) {
 	struct IGameComponent* comp;
+	Screenshot_Free();
 	/* Most components will call OnContextLost in their Free functions */
 	/* Set to false so components will always free managed textures too */
 	Gfx.ManagedTextures = false;
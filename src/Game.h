@@ -103,6 +103,11 @@ void Game_Reset(void);
 /* (updating state means recalculating light, redrawing chunk block is in, etc) */
 /* NOTE: This does NOT notify the server, use Game_ChangeBlock for that. */
 CC_API void Game_UpdateBlock(int x, int y, int z, BlockID block);
+/* Sets multiple blocks in the map (given as packed indices), then updates state associated with them. */
+/* Indices outside the map are ignored, and blocks that are unchanged do not update any state. */
+/* NOTE: Lighting, rain heights and chunks are only updated once for each changed column or chunk, */
+/*  rather than once for each changed block like when calling Game_UpdateBlock for each block. */
+void Game_UpdateBlocks(const cc_int32* indices, const BlockID* blocks, int count);
 /* Calls Game_UpdateBlock, then informs server connection of the block change. */
 /* In multiplayer this is sent to the server, in singleplayer just activates physics. */
 CC_API void Game_ChangeBlock(int x, int y, int z, BlockID block);
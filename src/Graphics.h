@@ -84,6 +84,8 @@ CC_VAR extern struct _GfxData {
 	cc_uint8 ReducedPerfModeCooldown;
 	/* Default index buffer for a triangle list representing quads */
 	GfxResourceID DefaultIb;
+	/* Whether Gfx_EnableTextureOffset is unimplemented (i.e. does nothing) */
+	cc_bool NoTextureOffset;
 } Gfx;
 
 extern const cc_string Gfx_LowPerfMessage;
@@ -294,6 +296,7 @@ CC_API void Gfx_BindVb(GfxResourceID vb);
 /* Deletes the given vertex buffer, then sets it to 0 */
 CC_API void Gfx_DeleteVb(GfxResourceID* vb);
 /* Acquires temp memory for changing the contents of a vertex buffer */
+/* NOTE: count can be less than, but must not be more than, the count the buffer was created with */
 CC_API void* Gfx_LockVb(GfxResourceID vb, VertexFormat fmt, int count);
 /* Submits the changed contents of a vertex buffer */
 CC_API void  Gfx_UnlockVb(GfxResourceID vb);
@@ -412,6 +415,13 @@ CC_API void Gfx_SetScissor (int x, int y, int w, int h);
 *#########################################################################################################################*/
 /* Outputs a .png screenshot of the backbuffer */
 cc_result Gfx_TakeScreenshot(struct Stream* output);
+#if CC_GFX_BACKEND_IS_GL() || CC_GFX_BACKEND == CC_GFX_BACKEND_D3D9 || CC_GFX_BACKEND == CC_GFX_BACKEND_D3D11
+#define CC_BUILD_GFX_READBACK
+/* Copies the pixels of the backbuffer into a newly allocated bitmap */
+/* bottomUp is set to whether rows are stored from bottom to top */
+/* NOTE: You must free bmp->scan0 using Mem_Free once done with it */
+cc_result Gfx_ReadFramebuffer(struct Bitmap* bmp, cc_bool* bottomUp);
+#endif
 /* Warns in chat if the graphics backend has problems with the user's GPU */
 /* Returns whether legacy rendering mode for borders/sky/clouds is needed */
 cc_bool Gfx_WarnIfNecessary(void);
@@ -450,8 +460,23 @@ void Gfx_RestoreAlphaState(cc_uint8 draw);
 void Gfx_Draw2DFlat(int x, int y, int width, int height, PackedCol color);
 /* Renders a 2D flat vertical gradient rectangle */
 void Gfx_Draw2DGradient(int x, int y, int width, int height, PackedCol top, PackedCol bottom);
-/* Renders a 2D coloured texture */
+/* Renders the given texture as a 2D quad tinted by the given colour */
 void Gfx_Draw2DTexture(const struct Texture* tex, PackedCol color);
+/* Sets the textured dynamic vertex buffer that Gfx_Draw2DRange draws from */
+void Gfx_Bind2DVb(GfxResourceID vb);
+/* Renders a range of vertices from the buffer set by Gfx_Bind2DVb, using the given texture */
+void Gfx_Draw2DRange(GfxResourceID texId, int verticesCount, int startVertex);
+/* Draws any 2D quads/ranges that are still pending in the 2D batch */
+/* NOTE: 2D drawing functions above are deferred while in 2D mode, so that adjacent */
+/*  quads using the same texture can be merged together into a single draw call. */
+/*  Hence this must be called before directly issuing draw calls while in 2D mode. */
+void Gfx_Flush2D(void);
+
+/* Statistics about 2D rendering over the most recent frame */
+extern struct _Gfx2DStats {
+	int Requests;            /* Quads/ranges submitted to the 2D drawing functions above */
+	int DrawCalls, Vertices; /* Draw calls actually issued after merging, and vertices drawn by them */
+} Gfx_2DStats;
 /* Fills out the vertices for rendering a 2D coloured texture */
 void Gfx_Make2DQuad(const struct Texture* tex, PackedCol color, struct VertexTextured** vertices);
 
@@ -472,9 +497,9 @@ void Gfx_End2D(void);
 /* Useful to only draw a sub-region of the texture's pixels */
 #define Tex_SetUV(tex, U1,V1, U2,V2) tex.uv.u1 = U1; tex.uv.v1 = V1; tex.uv.u2 = U2; tex.uv.v2 = V2;
 
-/* Binds then renders the given texture */
+/* Renders the given texture */
 void Texture_Render(const struct Texture* tex);
-/* Binds then renders the given texture */
+/* Renders the given texture tinted by the given colour */
 void Texture_RenderShaded(const struct Texture* tex, PackedCol shadeColor);
 
 CC_END_HEADER
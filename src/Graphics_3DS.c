@@ -212,6 +212,7 @@ void Gfx_FreeState(void) {
 }
 
 void Gfx_3DS_SetRenderScreen(enum Screen3DS screen) {
+	Gfx_Flush2D();
 	C3D_FrameDrawOn(screen == TOP_SCREEN ? topTarget : &bottomTarget);
 }
 
@@ -260,6 +261,7 @@ void Gfx_End3D(struct Matrix* proj, struct Matrix* view) {
 }
 
 void Gfx_SetTopRight(void) {
+	Gfx_Flush2D();
 	topTarget = &topTargetRight;
 	C3D_FrameDrawOn(topTarget);
 }
@@ -1001,6 +1003,7 @@ void Gfx_DrawIndexedTris_T2fC4b(int verticesCount, int startVertex) {
 // TODO: TEMP HACK !!
 void Gfx_Draw2DFlat(int x, int y, int width, int height, PackedCol color) {
 	struct VertexColoured v1, v2, v3, v4;
+	Gfx_Flush2D();
 	v1.x = (float)x;           v1.y = (float)y;
 	v2.x = (float)(x + width); v2.y = (float)y;
 	v3.x = (float)(x + width); v3.y = (float)(y + height);
@@ -1024,6 +1027,7 @@ void Gfx_Draw2DFlat(int x, int y, int width, int height, PackedCol color) {
 
 void Gfx_Draw2DGradient(int x, int y, int width, int height, PackedCol top, PackedCol bottom) {
 	struct VertexColoured v1, v2, v3, v4;
+	Gfx_Flush2D();
 	v1.x = (float)x;           v1.y = (float)y;
 	v2.x = (float)(x + width); v2.y = (float)y;
 	v3.x = (float)(x + width); v3.y = (float)(y + height);
@@ -1048,6 +1052,8 @@ void Gfx_Draw2DGradient(int x, int y, int width, int height, PackedCol top, Pack
 void Gfx_Draw2DTexture(const struct Texture* tex, PackedCol color) {
 	struct VertexTextured v[4];
 	struct VertexTextured* ptr = v;
+	Gfx_Flush2D();
+	Gfx_BindTexture(tex->ID);
 	Gfx_Make2DQuad(tex, color, &ptr);
 	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
 	C3D_ImmDrawBegin(GPU_TRIANGLES);
@@ -429,14 +429,22 @@ void Gfx_DeleteVb(GfxResourceID* vb) {
 }
 
 static void* tmp;
+static int tmpSize;
 void* Gfx_LockVb(GfxResourceID vb, VertexFormat fmt, int count) {
-	tmp = Mem_TryAlloc(count, strideSizes[fmt]);
+	tmpSize = count * strideSizes[fmt];
+	tmp     = Mem_TryAlloc(count, strideSizes[fmt]);
 	return tmp;
 }
 
 void Gfx_UnlockVb(GfxResourceID vb) {
 	ID3D11Buffer* buffer = (ID3D11Buffer*)vb;
-	ID3D11DeviceContext_UpdateSubresource(context, buffer, 0, NULL, tmp, 0, 0);
+	D3D11_BOX box;
+	/* Only the locked vertices are updated, as the buffer may be larger than them */
+	box.left  = 0; box.right  = tmpSize;
+	box.top   = 0; box.bottom = 1;
+	box.front = 0; box.back   = 1;
+
+	ID3D11DeviceContext_UpdateSubresource(context, buffer, 0, &box, tmp, 0, 0);
 	Mem_Free(tmp);
 	tmp = NULL;
 }
@@ -1156,16 +1164,10 @@ void Gfx_DepthOnlyRendering(cc_bool depthOnly) {
 /*########################################################################################################################*
 *-----------------------------------------------------------Misc----------------------------------------------------------*
 *#########################################################################################################################*/
-static BitmapCol* D3D11_GetRow(struct Bitmap* bmp, int y, void* ctx) {
-	D3D11_MAPPED_SUBRESOURCE* buffer = (D3D11_MAPPED_SUBRESOURCE*)ctx;
-	char* row = (char*)buffer->pData + y * buffer->RowPitch;
-	return (BitmapCol*)row;
-}
-
-cc_result Gfx_TakeScreenshot(struct Stream* output) {
+cc_result Gfx_ReadFramebuffer(struct Bitmap* bmp, cc_bool* bottomUp) {
 	ID3D11Texture2D* tmp = NULL;
-	struct Bitmap bmp;
 	HRESULT hr;
+	int y;
 
 	ID3D11Resource* backbuffer_res;
 	D3D11_RENDER_TARGET_VIEW_DESC backbuffer_desc;
@@ -1183,6 +1185,8 @@ cc_result Gfx_TakeScreenshot(struct Stream* output) {
 	desc.Usage     = D3D11_USAGE_STAGING;
 	desc.CPUAccessFlags = D3D11_CPU_ACCESS_READ;
 
+	bmp->scan0 = NULL;
+	*bottomUp  = false;
 	hr = ID3D11Device_CreateTexture2D(device, &desc, NULL, &tmp);
 	if (hr) goto finished;
 	ID3D11DeviceContext_CopyResource(context, tmp, backbuffer_res);
@@ -1190,8 +1194,18 @@ cc_result Gfx_TakeScreenshot(struct Stream* output) {
 	hr = ID3D11DeviceContext_Map(context, tmp, 0, D3D11_MAP_READ, 0, &buffer);
 	if (hr) goto finished;
 	{
-		Bitmap_Init(bmp, desc.Width, desc.Height, NULL);
-		hr = Png_Encode(&bmp, output, D3D11_GetRow, false, &buffer);
+		bmp->width  = desc.Width;
+		bmp->height = desc.Height;
+		bmp->scan0  = (BitmapCol*)Mem_TryAlloc(bmp->width * bmp->height, BITMAPCOLOR_SIZE);
+
+		if (!bmp->scan0) {
+			hr = ERR_OUT_OF_MEMORY;
+		} else {
+			for (y = 0; y < bmp->height; y++)
+			{
+				Mem_Copy(Bitmap_GetRow(bmp, y), (char*)buffer.pData + y * buffer.RowPitch, bmp->width * BITMAPCOLOR_SIZE);
+			}
+		}
 	}
 	ID3D11DeviceContext_Unmap(context, tmp, 0);
 
@@ -1201,6 +1215,19 @@ finished:
 	return hr;
 }
 
+cc_result Gfx_TakeScreenshot(struct Stream* output) {
+	struct Bitmap bmp;
+	cc_bool bottomUp;
+	cc_result res;
+
+	res = Gfx_ReadFramebuffer(&bmp, &bottomUp);
+	if (res) return res;
+
+	res = Png_Encode(&bmp, output, NULL, false, NULL);
+	Mem_Free(bmp.scan0);
+	return res;
+}
+
 void Gfx_SetVSync(cc_bool vsync) {
 	gfx_vsync = vsync;
 }
@@ -782,14 +782,16 @@ void Gfx_CalcPerspectiveMatrix(struct Matrix* matrix, float fov, float aspect, f
 /*########################################################################################################################*
 *-----------------------------------------------------------Misc----------------------------------------------------------*
 *#########################################################################################################################*/
-cc_result Gfx_TakeScreenshot(struct Stream* output) {
+cc_result Gfx_ReadFramebuffer(struct Bitmap* bmp, cc_bool* bottomUp) {
 	IDirect3DSurface9* backbuffer = NULL;
 	IDirect3DSurface9* temp = NULL;
 	D3DSURFACE_DESC desc;
 	D3DLOCKED_RECT rect;
-	struct Bitmap bmp;
 	cc_result res;
+	int y;
 
+	bmp->scan0 = NULL;
+	*bottomUp  = false;
 	res = IDirect3DDevice9_GetBackBuffer(device, 0, 0, D3DBACKBUFFER_TYPE_MONO, &backbuffer);
 	if (res) goto finished;
 	res = IDirect3DSurface9_GetDesc(backbuffer, &desc);
@@ -803,16 +805,35 @@ cc_result Gfx_TakeScreenshot(struct Stream* output) {
 	res = IDirect3DSurface9_LockRect(temp, &rect, NULL, D3DLOCK_READONLY | D3DLOCK_NO_DIRTY_UPDATE);
 	if (res) goto finished;
 	{
-		Bitmap_Init(bmp, desc.Width, desc.Height, (BitmapCol*)rect.pBits);
-		res = Png_Encode(&bmp, output, NULL, false, NULL);
-		if (res) { IDirect3DSurface9_UnlockRect(temp); goto finished; }
+		bmp->width  = desc.Width;
+		bmp->height = desc.Height;
+		bmp->scan0  = (BitmapCol*)Mem_TryAlloc(bmp->width * bmp->height, BITMAPCOLOR_SIZE);
+
+		if (!bmp->scan0) { IDirect3DSurface9_UnlockRect(temp); res = ERR_OUT_OF_MEMORY; goto finished; }
+		for (y = 0; y < bmp->height; y++) 
+		{
+			Mem_Copy(Bitmap_GetRow(bmp, y), (char*)rect.pBits + y * rect.Pitch, bmp->width * BITMAPCOLOR_SIZE);
+		}
 	}
 	res = IDirect3DSurface9_UnlockRect(temp);
-	if (res) goto finished;
 
 finished:
 	D3D9_FreeResource(backbuffer);
 	D3D9_FreeResource(temp);
+	if (res && bmp->scan0) { Mem_Free(bmp->scan0); bmp->scan0 = NULL; }
+	return res;
+}
+
+cc_result Gfx_TakeScreenshot(struct Stream* output) {
+	struct Bitmap bmp;
+	cc_bool bottomUp;
+	cc_result res;
+
+	res = Gfx_ReadFramebuffer(&bmp, &bottomUp);
+	if (res) return res;
+
+	res = Png_Encode(&bmp, output, NULL, false, NULL);
+	Mem_Free(bmp.scan0);
 	return res;
 }
 
@@ -141,8 +141,11 @@ void Gfx_DeleteIb(GfxResourceID* ib) { }
 #ifndef CC_BUILD_GL11
 static GfxResourceID Gfx_AllocStaticVb(VertexFormat fmt, int count) {
 	GfxResourceID id = NULL;
+	cc_uint32 size   = count * strideSizes[fmt];
+
 	_glGenBuffers(1, (GLuint*)&id);
 	_glBindBuffer(GL_ARRAY_BUFFER, id);
+	_glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STATIC_DRAW);
 	return id;
 }
 
@@ -161,7 +164,9 @@ void* Gfx_LockVb(GfxResourceID vb, VertexFormat fmt, int count) {
 }
 
 void Gfx_UnlockVb(GfxResourceID vb) {
-	_glBufferData(GL_ARRAY_BUFFER, tmpSize, tmpData, GL_STATIC_DRAW);
+	/* Storage was allocated when the buffer was created, so can be reused by e.g. chunks */
+	_glBindBuffer(GL_ARRAY_BUFFER, vb);
+	_glBufferSubData(GL_ARRAY_BUFFER, 0, tmpSize, tmpData);
 }
 #else
 static GfxResourceID Gfx_AllocStaticVb(VertexFormat fmt, int count) { 
@@ -89,7 +89,10 @@ void Gfx_DeleteIb(GfxResourceID* ib) {
 *------------------------------------------------------Vertex buffers-----------------------------------------------------*
 *#########################################################################################################################*/
 static GfxResourceID Gfx_AllocStaticVb(VertexFormat fmt, int count) {
-	GLuint id = GL_GenAndBind(GL_ARRAY_BUFFER);
+	GLuint id      = GL_GenAndBind(GL_ARRAY_BUFFER);
+	cc_uint32 size = count * strideSizes[fmt];
+
+	glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STATIC_DRAW);
 	return uint_to_ptr(id);
 }
 
@@ -108,7 +111,9 @@ void* Gfx_LockVb(GfxResourceID vb, VertexFormat fmt, int count) {
 }
 
 void Gfx_UnlockVb(GfxResourceID vb) {
-	glBufferData(GL_ARRAY_BUFFER, tmpSize, tmpData, GL_STATIC_DRAW);
+	/* Storage was allocated when the buffer was created, so can be reused by e.g. chunks */
+	glBindBuffer(GL_ARRAY_BUFFER, ptr_to_uint(vb));
+	glBufferSubData(GL_ARRAY_BUFFER, 0, tmpSize, tmpData);
 }
 
 
@@ -100,6 +100,7 @@ void Gfx_Create(void) {
 	Gfx.MaxTexWidth  = 128;
 	Gfx.MaxTexHeight = 256;
 	Gfx.Created      = true;
+	Gfx.NoTextureOffset = true;
 	
 	Gfx_RestoreState();
 
@@ -1003,9 +1004,11 @@ cc_bool Gfx_TryRestoreContext(void) { return true; }
 void Gfx_Begin2D(int width, int height) {
 	gfx_rendering2D = true;
 	Gfx_SetAlphaBlending(true);
+	Mem_Set(&Gfx_2DStats, 0, sizeof(Gfx_2DStats));
 }
 
 void Gfx_End2D(void) {
+	Gfx_Flush2D();
 	gfx_rendering2D = false;
 	Gfx_SetAlphaBlending(false);
 }
@@ -147,6 +147,7 @@ void Gfx_Create(void) {
 	Gfx.MaxTexHeight = 1024;
 	Gfx.MaxTexSize   = 512 * 512;
 	Gfx.Created      = true;
+	Gfx.NoTextureOffset = true;
 	
 	Gfx_RestoreState();
 }
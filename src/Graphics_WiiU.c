@@ -49,6 +49,7 @@ void Gfx_Create(void) {
 	if (!Gfx.Created) InitGfx();
 	
 	Gfx.Created      = true;
+	Gfx.NoTextureOffset = true;
 	Gfx.MaxTexWidth  = 1024;
 	Gfx.MaxTexHeight = 1024;
 }
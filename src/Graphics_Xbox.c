@@ -111,6 +111,7 @@ void Gfx_Create(void) {
 	Gfx.MaxTexWidth  = 512;
 	Gfx.MaxTexHeight = 512; // TODO: 1024?
 	Gfx.Created      = true;
+	Gfx.NoTextureOffset = true;
 
 	InitDefaultResources();	
 	pb_init();
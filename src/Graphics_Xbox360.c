@@ -60,6 +60,7 @@ void Gfx_Create(void) {
 		CreateShaders();	
 	}
 	Gfx.Created = true;
+	Gfx.NoTextureOffset = true;
 	Gfx_SetVertexFormat(VERTEX_FORMAT_COLOURED);
 	
 	Gfx.MaxTexWidth  = 1024;
@@ -494,8 +494,7 @@ void Screen_Render2Widgets(void* screen, float delta) {
 	struct Widget** widgets = s->widgets;
 	int i, offset = 0;
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	Gfx_BindDynamicVb(s->vb);
+	Gfx_Bind2DVb(s->vb);
 
 	for (i = 0; i < s->numWidgets; i++) 
 	{
@@ -158,8 +158,7 @@ void IsometricDrawer_Render(int count, int offset, int* state) {
 		if (state[i] == curIdx) continue;
 
 		/* Flush previous batch */
-		Atlas1D_Bind(curIdx);
-		Gfx_DrawVb_IndexedTris_Range(batchLen, batchBeg);
+		Gfx_Draw2DRange(Atlas1D_Texture(curIdx), batchLen, batchBeg);
 
 		/* Reset for next batch */
 		curIdx   = state[i];
@@ -167,6 +166,5 @@ void IsometricDrawer_Render(int count, int offset, int* state) {
 		batchLen = 0;
 	}
 
-	Atlas1D_Bind(curIdx);
-	Gfx_DrawVb_IndexedTris_Range(batchLen, batchBeg);
+	Gfx_Draw2DRange(Atlas1D_Texture(curIdx), batchLen, batchBeg);
 }
@@ -31,9 +31,12 @@
 struct FontDesc titleFont, textFont, hintFont, logoFont, rowFont;
 /* Contains the pixels that are drawn to the window */
 static struct Context2D framebuffer;
-/* The area/region of the window that needs to be redrawn and presented to the screen. */
-/* If width is 0, means no area needs to be redrawn. */
-static Rect2D dirty_rect;
+/* The areas/regions of the window that need to be redrawn and presented to the screen. */
+#define MAX_DIRTY_RECTS 8
+static Rect2D dirty_rects[MAX_DIRTY_RECTS];
+static int dirty_count;
+/* Estimated fixed cost of presenting a separate area, in number of pixels */
+#define DIRTY_RECT_OVERHEAD (64 * 64)
 static int pendingFullDraws;
 
 LBackend_DrawHook LBackend_Hooks[4];
@@ -188,28 +191,43 @@ void LBackend_NeedsRedraw(void* widget) {
 }
 
 void LBackend_MarkAllDirty(void) {
-	dirty_rect.x = 0; dirty_rect.width  = framebuffer.width;
-	dirty_rect.y = 0; dirty_rect.height = framebuffer.height;
+	dirty_rects[0].x = 0; dirty_rects[0].width  = framebuffer.width;
+	dirty_rects[0].y = 0; dirty_rects[0].height = framebuffer.height;
+	dirty_count = 1;
 }
 
+static Rect2D DirtyRect_Union(const Rect2D* a, const Rect2D* b) {
+	Rect2D r;
+	r.x = min(a->x, b->x); r.width  = max(a->x + a->width,  b->x + b->width)  - r.x;
+	r.y = min(a->y, b->y); r.height = max(a->y + a->height, b->y + b->height) - r.y;
+	return r;
+}
+#define DirtyRect_Area(r) ((r).width * (r).height)
+
 void LBackend_MarkAreaDirty(int x, int y, int width, int height) {
-	int x1, y1, x2, y2;
+	int i, cost, best, bestCost;
+	Rect2D r, merged;
 	if (!Drawer2D_Clamp(&framebuffer, &x, &y, &width, &height)) return;
+	r.x = x; r.width  = width;
+	r.y = y; r.height = height;
+
+	/* Merge with existing dirty areas while that's cheaper than presenting them separately */
+	/*  (i.e. when the extra pixels presented cost less than presenting another area) */
+	while (dirty_count) {
+		best = 0; bestCost = Int32_MaxValue;
+
+		for (i = 0; i < dirty_count; i++) {
+			merged = DirtyRect_Union(&r, &dirty_rects[i]);
+			cost   = DirtyRect_Area(merged) - DirtyRect_Area(r) - DirtyRect_Area(dirty_rects[i]);
+			if (cost < bestCost) { best = i; bestCost = cost; }
+		}
 
-	/* union with existing dirty area */
-	if (dirty_rect.width) {
-		x1 = min(x, dirty_rect.x);
-		y1 = min(y, dirty_rect.y);
-
-		x2 = max(x +  width, dirty_rect.x + dirty_rect.width);
-		y2 = max(y + height, dirty_rect.y + dirty_rect.height);
-
-		x = x1; width  = x2 - x1;
-		y = y1; height = y2 - y1;
+		/* When out of slots, have to merge with the cheapest area anyways */
+		if (bestCost > DIRTY_RECT_OVERHEAD && dirty_count < MAX_DIRTY_RECTS) break;
+		r = DirtyRect_Union(&r, &dirty_rects[best]);
+		dirty_rects[best] = dirty_rects[--dirty_count];
 	}
-
-	dirty_rect.x = x; dirty_rect.width  = width;
-	dirty_rect.y = y; dirty_rect.height = height;
+	dirty_rects[dirty_count++] = r;
 }
 
 void LBackend_InitFramebuffer(void) {
@@ -253,6 +271,8 @@ static CC_NOINLINE void DrawWidget(struct LWidget* w) {
 
 	w->dirty = false;
 	w->VTABLE->Draw(w);
+	/* Table only marks the parts that were actually redrawn as dirty */
+	if (w->type == LWIDGET_TABLE) return;
 	LBackend_MarkAreaDirty(w->x, w->y, w->width, w->height);
 }
 
@@ -262,6 +282,9 @@ static CC_NOINLINE void RedrawAll(void) {
 	s->DrawBackground(s, &framebuffer);
 	
 	for (i = 0; i < s->numWidgets; i++) {
+		/* Background behind the whole table was just cleared */
+		if (s->widgets[i]->type == LWIDGET_TABLE) 
+			((struct LTable*)s->widgets[i])->_redrawAllRows = true;
 		DrawWidget(s->widgets[i]);
 	}
 	LBackend_MarkAllDirty();
@@ -313,16 +336,18 @@ void LBackend_Tick(void) {
 		pendingFullDraws--;
 		LBackend_MarkAllDirty();
 	}
-	if (!dirty_rect.width) return;
+	if (!dirty_count) return;
 
 	for (i = 0; i < Array_Elems(LBackend_Hooks); i++)
 	{
 		if (LBackend_Hooks[i]) LBackend_Hooks[i](&framebuffer);
 	}
-	Window_DrawFramebuffer(dirty_rect, &framebuffer.bmp);
 
-	dirty_rect.x = 0; dirty_rect.width   = 0;
-	dirty_rect.y = 0; dirty_rect.height  = 0;
+	for (i = 0; i < dirty_count; i++)
+	{
+		Window_DrawFramebuffer(dirty_rects[i], &framebuffer.bmp);
+	}
+	dirty_count = 0;
 }
 
 void LBackend_AddDirtyFrames(int frames) {
@@ -936,6 +961,7 @@ void LBackend_TableUpdate(struct LTable* w) { }
 void LBackend_TableReposition(struct LTable* w) {
 	int rowsHeight;
 	InitRowFont();
+	w->_redrawAllRows = true;
 	w->hdrHeight = Font_CalcHeight(&textFont, true) + hdrYPadding;
 	w->rowHeight = Font_CalcHeight(&rowFont,  true) + rowYPadding;
 
@@ -949,6 +975,7 @@ void LBackend_TableReposition(struct LTable* w) {
 
 void LBackend_TableFlagAdded(struct LTable* w) {
 	/* TODO: Only redraw flags */
+	w->_redrawAllRows = true;
 	LBackend_NeedsRedraw(w);
 }
 
@@ -973,6 +1000,17 @@ static BitmapCol LBackend_TableRowColor(struct LTable* w, int row) {
 	return LTable_RowColor(row, selected, featured);
 }
 
+/* Draws background behind each row in the table */
+static void LTable_DrawRowBackground(struct LTable* w, BitmapCol color, int y, int height) {
+	if (color) {
+		Context2D_Clear(&framebuffer, color,
+						w->x, y, w->width, height);
+	} else {
+		Launcher_DrawBackground(&framebuffer, 
+						w->x, y, w->width, height);
+	}
+}
+
 /* Draws background behind each row in the table */
 static void LTable_DrawRowsBackground(struct LTable* w) {
 	int y, height, row;
@@ -986,36 +1024,33 @@ static void LTable_DrawRowsBackground(struct LTable* w) {
 		height = min(y + w->rowHeight, w->rowsEndY) - y;
 		/* hit the end of the table */
 		if (height < 0) break;
-
-		if (color) {
-			Context2D_Clear(&framebuffer, color,
-							w->x, y, w->width, height);
-		} else {
-			Launcher_DrawBackground(&framebuffer, 
-							w->x, y, w->width, height);
-		}
+		LTable_DrawRowBackground(w, color, y, height);
 	}
 }
 
-/* Draws a gridline below column headers and gridlines after each column */
-static void LTable_DrawGridlines(struct LTable* w) {
-	int i, x;
-	if (Launcher_Theme.ClassicBackground) return;
-
-	x = w->x;
-	Context2D_Clear(&framebuffer, Launcher_Theme.BackgroundColor,
-				   x, w->y + w->hdrHeight, w->width, gridlineHeight);
+/* Draws gridlines after each column, between the given Y coordinates */
+static void LTable_DrawColumnGridlines(struct LTable* w, int y, int height) {
+	int i, x = w->x;
 
 	for (i = 0; i < w->numColumns; i++) {
 		x += w->columns[i].width;
 		if (!w->columns[i].hasGridline) continue;
 			
 		Context2D_Clear(&framebuffer, Launcher_Theme.BackgroundColor,
-					   x, w->y, gridlineWidth, w->height);
+					   x, y, gridlineWidth, height);
 		x += gridlineWidth;
 	}
 }
 
+/* Draws a gridline below column headers and gridlines after each column */
+static void LTable_DrawGridlines(struct LTable* w) {
+	if (Launcher_Theme.ClassicBackground) return;
+
+	Context2D_Clear(&framebuffer, Launcher_Theme.BackgroundColor,
+				   w->x, w->y + w->hdrHeight, w->width, gridlineHeight);
+	LTable_DrawColumnGridlines(w, w->y, w->height);
+}
+
 /* Draws the entire background of the table */
 static void LTable_DrawBackground(struct LTable* w) {
 	LTable_DrawHeaderBackground(w);
@@ -1042,42 +1077,90 @@ static void LTable_DrawHeaders(struct LTable* w) {
 	}
 }
 
-/* Draws contents of the currently visible rows in the table */
-static void LTable_DrawRows(struct LTable* w) {
+/* Draws contents of each column for the given row */
+static void LTable_DrawRow(struct LTable* w, struct ServerInfo* entry, int y) {
 	cc_string str; char strBuffer[STRING_SIZE];
-	struct ServerInfo* entry;
 	struct DrawTextArgs args;
 	struct LTableCell cell;
-	int i, x, y, row, end;
+	int i, x = w->x;
 
-	InitRowFont();
 	String_InitArray(str, strBuffer);
 	DrawTextArgs_Make(&args, &str, &rowFont, true);
 	cell.table = w;
+
+	for (i = 0; i < w->numColumns; i++) {
+		args.text  = str; cell.x = x; cell.y = y;
+		cell.width = w->columns[i].width;
+		w->columns[i].DrawRow(entry, &args, &cell, &framebuffer);
+
+		if (args.text.length) {
+			Drawer2D_DrawClippedText(&framebuffer, &args, 
+									x + cellXOffset, y + rowYOffset, 
+									cell.width - cellXPadding);
+		}
+
+		x += w->columns[i].width;
+		if (w->columns[i].hasGridline) x += gridlineWidth;
+	}
+}
+
+/* Draws contents of the currently visible rows in the table */
+static void LTable_DrawRows(struct LTable* w) {
+	int y, row, end;
+
+	InitRowFont();
 	y   = w->rowsBegY;
 	end = w->topRow + w->visibleRows;
 
 	for (row = w->topRow; row < end; row++, y += w->rowHeight) {
-		x = w->x;
-
 		if (row >= w->rowsCount)            break;
 		if (y + w->rowHeight > w->rowsEndY) break;
-		entry = LTable_Get(row);
+		LTable_DrawRow(w, LTable_Get(row), y);
+	}
+}
+
+/* Server and background color of each row, when the rows were last drawn */
+#define TABLE_MAX_CACHED_ROWS 256
+static struct LTableRowCache {
+	struct ServerInfo* entry;
+	BitmapCol color;
+} tableRows[TABLE_MAX_CACHED_ROWS];
+
+static void LTable_CacheRows(struct LTable* w) {
+	int i, row;
+	for (i = 0, row = w->topRow; i < TABLE_MAX_CACHED_ROWS; i++, row++) 
+	{
+		tableRows[i].entry = row < w->rowsCount ? LTable_Get(row) : NULL;
+		tableRows[i].color = LBackend_TableRowColor(w, row);
+	}
+}
+
+/* Redraws only the rows whose server or background color changed since they were last drawn */
+/*  (e.g. when typing in the search box, or when the selected server changes) */
+static void LTable_DrawChangedRows(struct LTable* w) {
+	struct ServerInfo* entry;
+	int i, y, height, row;
+	BitmapCol color;
+
+	InitRowFont();
+	y = w->rowsBegY;
+	for (i = 0, row = w->topRow; i < TABLE_MAX_CACHED_ROWS; i++, row++, y += w->rowHeight) {
+		/* last row may get chopped off */
+		height = min(y + w->rowHeight, w->rowsEndY) - y;
+		/* hit the end of the table */
+		if (height < 0) break;
 
-		for (i = 0; i < w->numColumns; i++) {
-			args.text  = str; cell.x = x; cell.y = y;
-			cell.width = w->columns[i].width;
-			w->columns[i].DrawRow(entry, &args, &cell, &framebuffer);
+		entry = row < w->rowsCount ? LTable_Get(row) : NULL;
+		color = LBackend_TableRowColor(w, row);
+		if (entry == tableRows[i].entry && color == tableRows[i].color) continue;
 
-			if (args.text.length) {
-				Drawer2D_DrawClippedText(&framebuffer, &args, 
-										x + cellXOffset, y + rowYOffset, 
-										cell.width - cellXPadding);
-			}
+		tableRows[i].entry = entry;
+		tableRows[i].color = color;
+		LTable_DrawRowBackground(w, color, y, height);
+		if (!Launcher_Theme.ClassicBackground) LTable_DrawColumnGridlines(w, y, height);
 
-			x += w->columns[i].width;
-			if (w->columns[i].hasGridline) x += gridlineWidth;
-		}
+		if (entry && y + w->rowHeight <= w->rowsEndY) LTable_DrawRow(w, entry, y);
+		LBackend_MarkAreaDirty(w->x, y, w->width, height);
 	}
 }
 
@@ -1099,11 +1182,19 @@ static void LTable_DrawScrollbar(struct LTable* w) {
 }
 
 void LBackend_TableDraw(struct LTable* w) {
-	LTable_DrawBackground(w);
-	LTable_DrawHeaders(w);
-	LTable_DrawRows(w);
+	/* +1 for last row that may be partially visible */
+	if (w->_redrawAllRows || w->visibleRows + 1 >= TABLE_MAX_CACHED_ROWS) {
+		LTable_DrawBackground(w);
+		LTable_DrawHeaders(w);
+		LTable_DrawRows(w);
+		LTable_CacheRows(w);
+		w->_redrawAllRows = false;
+		LBackend_MarkAreaDirty(w->x, w->y, w->width, w->height);
+	} else {
+		LTable_DrawChangedRows(w);
+		LBackend_MarkAreaDirty(w->x + w->width - scrollbarWidth, w->y, scrollbarWidth, w->height);
+	}
 	LTable_DrawScrollbar(w);
-	LBackend_MarkAllDirty();
 }
 
 
@@ -1196,6 +1287,7 @@ void LBackend_TableMouseMove(struct LTable* w, int idx) {
 		Math_Clamp(width, cellMinWidth, maxW - cellMinWidth);
 		if (width == w->columns[col].width) return;
 		w->columns[col].width = width;
+		w->_redrawAllRows     = true;
 		LBackend_NeedsRedraw(w);
 	}
 }
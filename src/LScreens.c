@@ -1289,7 +1289,7 @@ static void ServersScreen_OnSelectedChanged(void) {
 
 static void ServersScreen_ReloadServers(struct ServersScreen* s) {
 	int i;
-	LTable_Sort(&s->table);
+	LTable_Refresh(&s->table);
 
 	for (i = 0; i < FetchServersTask.numServers; i++) 
 	{
@@ -16,11 +16,21 @@
 /*########################################################################################################################*
 *----------------------------------------------------------JSON-----------------------------------------------------------*
 *#########################################################################################################################*/
-#define TOKEN_NONE  0
-#define TOKEN_NUM   1
-#define TOKEN_TRUE  2
-#define TOKEN_FALSE 3
-#define TOKEN_NULL  4
+/* What the parser expects to read next */
+#define JSON_EXPECT_ROOT    0 /* top level value */
+#define JSON_EXPECT_KEY     1 /* key of next object member, or end of object */
+#define JSON_EXPECT_COLON   2 /* ':' separating object member key and value */
+#define JSON_EXPECT_MEMBER  3 /* value of object member */
+#define JSON_EXPECT_ELEMENT 4 /* next array element, or end of array */
+
+/* Partial token being read, which may continue into the next chunk */
+#define JSON_LEX_NONE    0
+#define JSON_LEX_STRING  1
+#define JSON_LEX_ESCAPE  2 /* character after a \ in a string */
+#define JSON_LEX_UNICODE 3 /* hex digits of \uYYYY in a string */
+#define JSON_LEX_NUMBER  4
+#define JSON_LEX_LITERAL 5 /* true, false, or null */
+#define JSON_LEX_DONE    6 /* parsing has stopped, ignore any further input */
 /* Consumes n characters from the JSON stream */
 #define JsonContext_Consume(ctx, n) ctx->cur += n; ctx->left -= n;
 
@@ -36,136 +46,205 @@ static cc_bool Json_IsNumber(char c) {
 	return c == '-' || c == '.' || (c >= '0' && c <= '9');
 }
 
-static cc_bool Json_ConsumeConstant(struct JsonContext* ctx, const cc_string* value) {
-	int i;
-	if (value->length > ctx->left) return false;
+static void Json_Fail(struct JsonContext* ctx) {
+	ctx->failed = true;
+	ctx->_lexer = JSON_LEX_DONE;
+}
 
-	for (i = 0; i < value->length; i++) {
-		if (ctx->cur[i] != value->buffer[i]) return false;
+static void Json_InvalidToken(struct JsonContext* ctx) {
+	/* Invalid token at top level just stops parsing */
+	if (ctx->_parser == JSON_EXPECT_ROOT) {
+		ctx->_lexer = JSON_LEX_DONE;
+	} else {
+		Json_Fail(ctx);
 	}
-
-	JsonContext_Consume(ctx, value->length);
-	return true;
 }
 
-static int Json_ConsumeToken(struct JsonContext* ctx) {
-	char c;
-	for (; ctx->left && Json_IsWhitespace(*ctx->cur); ) { JsonContext_Consume(ctx, 1); }
-	if (!ctx->left) return TOKEN_NONE;
+static void Json_EndValue(struct JsonContext* ctx, const cc_string* value) {
+	int depth = ctx->depth;
+	if (!depth) { ctx->_parser = JSON_EXPECT_ROOT; return; }
+	ctx->OnValue(ctx, value);
 
-	c = *ctx->cur;
-	if (c == '{' || c == '}' || c == '[' || c == ']' || c == ',' || c == '"' || c == ':') {
-		JsonContext_Consume(ctx, 1); return c;
+	if (ctx->_containers[depth - 1] == '{') {
+		ctx->curKey  = ctx->_parentKeys[depth - 1];
+		ctx->_parser = JSON_EXPECT_KEY;
+	} else {
+		ctx->_parser = JSON_EXPECT_ELEMENT;
 	}
+}
 
-	/* number token forms part of value, don't consume it */
-	if (Json_IsNumber(c)) return TOKEN_NUM;
+static void Json_BeginContainer(struct JsonContext* ctx, char type) {
+	int depth = ctx->depth;
+	if (depth == JSON_MAX_DEPTH) { Json_Fail(ctx); return; }
 
-	if (Json_ConsumeConstant(ctx, &strTrue))  return TOKEN_TRUE;
-	if (Json_ConsumeConstant(ctx, &strFalse)) return TOKEN_FALSE;
-	if (Json_ConsumeConstant(ctx, &strNull))  return TOKEN_NULL;
+	ctx->_containers[depth] = type;
+	ctx->_parentKeys[depth] = ctx->curKey;
+	ctx->depth++;
 
-	/* invalid token */
-	JsonContext_Consume(ctx, 1);
-	return TOKEN_NONE;
+	if (type == '{') {
+		ctx->_parser = JSON_EXPECT_KEY;
+		ctx->OnNewObject(ctx);
+	} else {
+		ctx->_parser = JSON_EXPECT_ELEMENT;
+		ctx->OnNewArray(ctx);
+	}
 }
 
-static cc_string Json_ConsumeNumber(struct JsonContext* ctx) {
-	int len = 0;
-	for (; ctx->left && Json_IsNumber(*ctx->cur); len++) { JsonContext_Consume(ctx, 1); }
-	return String_Init(ctx->cur - len, len, len);
+static void Json_EndContainer(struct JsonContext* ctx) {
+	ctx->depth--;
+	ctx->curKey = ctx->_parentKeys[ctx->depth];
+	Json_EndValue(ctx, &String_Empty);
 }
 
-static void Json_ConsumeString(struct JsonContext* ctx, cc_string* str) {
-	int codepoint, h[4];
-	char c;
+static void Json_BeginString(struct JsonContext* ctx, cc_string* str) {
 	str->length = 0;
+	ctx->_str   = str;
+	ctx->_lexer = JSON_LEX_STRING;
+}
 
-	for (; ctx->left;) {
-		c = *ctx->cur; JsonContext_Consume(ctx, 1);
-		if (c == '"') return;
-		if (c != '\\') { String_Append(str, c); continue; }
+static void Json_BeginValue(struct JsonContext* ctx, char c) {
+	/* number and literal characters are consumed while reading the token */
+	if (Json_IsNumber(c)) {
+		ctx->_tmp.length = 0;
+		ctx->_lexer = JSON_LEX_NUMBER;
+		return;
+	}
 
-		/* form of \X */
-		if (!ctx->left) break;
-		c = *ctx->cur; JsonContext_Consume(ctx, 1);
-		if (c == '/' || c == '\\' || c == '"') { String_Append(str, c); continue; }
-		if (c == 'n') { String_Append(str, '\n'); continue; }
-
-		/* form of \uYYYY */
-		if (c != 'u' || ctx->left < 4) break;
-		if (!PackedCol_Unhex(ctx->cur, h, 4)) break;
-
-		codepoint = (h[0] << 12) | (h[1] << 8) | (h[2] << 4) | h[3];
-		/* don't want control characters in names/software */
-		/* TODO: Convert to CP437.. */
-		if (codepoint >= 32) String_Append(str, codepoint);
-		JsonContext_Consume(ctx, 4);
+	if (c == 't' || c == 'f' || c == 'n') {
+		ctx->_literal    = c == 't' ? &strTrue : (c == 'f' ? &strFalse : &strNull);
+		ctx->_literalPos = 0;
+		ctx->_lexer      = JSON_LEX_LITERAL;
+		return;
 	}
 
-	ctx->failed = true; str->length = 0;
+	JsonContext_Consume(ctx, 1);
+	switch (c) {
+	case '{': 
+	case '[': 
+		Json_BeginContainer(ctx, c); return;
+	case '"': 
+		Json_BeginString(ctx, &ctx->_tmp); return;
+	case '}': 
+	case ']': 
+	case ',': 
+	case ':':
+		Json_EndValue(ctx, &String_Empty); return;
+	}
+	Json_InvalidToken(ctx);
 }
-static cc_string Json_ConsumeValue(int token, struct JsonContext* ctx);
 
-static void Json_ConsumeObject(struct JsonContext* ctx) {
-	char keyBuffer[STRING_SIZE];
-	cc_string value, oldKey = ctx->curKey;
-	int token;
-	ctx->depth++;
-	ctx->OnNewObject(ctx);
+static void Json_ReadToken(struct JsonContext* ctx) {
+	char c = *ctx->cur;
+	if (Json_IsWhitespace(c)) { JsonContext_Consume(ctx, 1); return; }
 
-	while (true) {
-		token = Json_ConsumeToken(ctx);
-		if (token == ',') continue;
-		if (token == '}') break;
+	switch (ctx->_parser) {
+	case JSON_EXPECT_KEY:
+		JsonContext_Consume(ctx, 1);
+		if (c == ',') return;
+		if (c == '}') { Json_EndContainer(ctx); return; }
+		if (c != '"') { Json_Fail(ctx); return; }
 
-		if (token != '"') { ctx->failed = true; break; }
-		String_InitArray(ctx->curKey, keyBuffer);
-		Json_ConsumeString(ctx, &ctx->curKey);
+		String_InitArray(ctx->curKey, ctx->_keyBuffers[ctx->depth - 1]);
+		Json_BeginString(ctx, &ctx->curKey);
+		return;
 
-		token = Json_ConsumeToken(ctx);
-		if (token != ':') { ctx->failed = true; break; }
+	case JSON_EXPECT_COLON:
+		JsonContext_Consume(ctx, 1);
+		if (c != ':') { Json_Fail(ctx); return; }
 
-		token = Json_ConsumeToken(ctx);
-		if (token == TOKEN_NONE) { ctx->failed = true; break; }
+		ctx->_parser = JSON_EXPECT_MEMBER;
+		return;
 
-		value = Json_ConsumeValue(token, ctx);
-		ctx->OnValue(ctx, &value);
-		ctx->curKey = oldKey;
+	case JSON_EXPECT_ELEMENT:
+		if (c == ',') { JsonContext_Consume(ctx, 1); return; }
+		if (c == ']') { JsonContext_Consume(ctx, 1); Json_EndContainer(ctx); return; }
+		break;
 	}
-	ctx->depth--;
+	Json_BeginValue(ctx, c);
 }
 
-static void Json_ConsumeArray(struct JsonContext* ctx) {
-	cc_string value;
-	int token;
-	ctx->depth++;
-	ctx->OnNewArray(ctx);
+static void Json_EndString(struct JsonContext* ctx) {
+	ctx->_lexer = JSON_LEX_NONE;
+	if (ctx->_str == &ctx->curKey) {
+		ctx->_parser = JSON_EXPECT_COLON;
+	} else {
+		Json_EndValue(ctx, &ctx->_tmp);
+	}
+}
 
-	while (true) {
-		token = Json_ConsumeToken(ctx);
-		if (token == ',') continue;
-		if (token == ']') break;
+static void Json_ReadString(struct JsonContext* ctx) {
+	cc_string* str = ctx->_str;
+	char c;
 
-		if (token == TOKEN_NONE) { ctx->failed = true; break; }
-		value = Json_ConsumeValue(token, ctx);
-		ctx->OnValue(ctx, &value);
+	/* Overly long strings are still read fully, but truncated to capacity */
+	while (ctx->left) {
+		c = *ctx->cur; JsonContext_Consume(ctx, 1);
+		if (c == '"')  { Json_EndString(ctx); return; }
+		if (c == '\\') { ctx->_lexer = JSON_LEX_ESCAPE; return; }
+		String_Append(str, c);
 	}
-	ctx->depth--;
 }
 
-static cc_string Json_ConsumeValue(int token, struct JsonContext* ctx) {
-	switch (token) {
-	case '{': Json_ConsumeObject(ctx); break;
-	case '[': Json_ConsumeArray(ctx);  break;
-	case '"': Json_ConsumeString(ctx, &ctx->_tmp); return ctx->_tmp;
+static void Json_ReadEscape(struct JsonContext* ctx) {
+	char c = *ctx->cur;
+	JsonContext_Consume(ctx, 1);
+	ctx->_lexer = JSON_LEX_STRING;
+
+	/* form of \X */
+	if (c == '/' || c == '\\' || c == '"') { String_Append(ctx->_str, c); return; }
+	if (c == 'n') { String_Append(ctx->_str, '\n'); return; }
+	/* don't want control characters in names/software */
+	if (c == 'b' || c == 'f' || c == 'r' || c == 't') return;
+
+	/* form of \uYYYY */
+	if (c != 'u') { Json_Fail(ctx); return; }
+	ctx->_lexer     = JSON_LEX_UNICODE;
+	ctx->_hexDigits = 0;
+	ctx->_codepoint = 0;
+}
+
+static void Json_ReadUnicode(struct JsonContext* ctx) {
+	int hex;
+	for (; ctx->left && ctx->_hexDigits < 4; ctx->_hexDigits++) 
+	{
+		if (!PackedCol_Unhex(ctx->cur, &hex, 1)) { Json_Fail(ctx); return; }
+		ctx->_codepoint = (ctx->_codepoint << 4) | hex;
+		JsonContext_Consume(ctx, 1);
+	}
+	if (ctx->_hexDigits < 4) return;
+
+	ctx->_lexer = JSON_LEX_STRING;
+	/* don't want control characters in names/software */
+	if (ctx->_codepoint < 32) return;
+	String_Append(ctx->_str, Convert_CodepointToCP437(ctx->_codepoint));
+}
+
+static void Json_ReadNumber(struct JsonContext* ctx) {
+	char c;
+	while (ctx->left) {
+		c = *ctx->cur;
+		/* the character after the number forms part of the next token */
+		if (!Json_IsNumber(c)) {
+			ctx->_lexer = JSON_LEX_NONE;
+			Json_EndValue(ctx, &ctx->_tmp); return;
+		}
+
+		String_Append(&ctx->_tmp, c);
+		JsonContext_Consume(ctx, 1);
+	}
+}
 
-	case TOKEN_NUM:   return Json_ConsumeNumber(ctx);
-	case TOKEN_TRUE:  return strTrue;
-	case TOKEN_FALSE: return strFalse;
-	case TOKEN_NULL:  break;
+static void Json_ReadLiteral(struct JsonContext* ctx) {
+	const cc_string* value = ctx->_literal;
+	for (; ctx->left && ctx->_literalPos < value->length; ctx->_literalPos++) 
+	{
+		if (*ctx->cur != value->buffer[ctx->_literalPos]) { Json_InvalidToken(ctx); return; }
+		JsonContext_Consume(ctx, 1);
 	}
-	return String_Empty;
+	if (ctx->_literalPos < value->length) return;
+
+	ctx->_lexer = JSON_LEX_NONE;
+	Json_EndValue(ctx, value == &strNull ? &String_Empty : value);
 }
 
 static void Json_NullOnNew(struct JsonContext* ctx) { }
@@ -181,18 +260,57 @@ void Json_Init(struct JsonContext* ctx, STRING_REF char* str, int len) {
 	ctx->OnNewObject = Json_NullOnNew;
 	ctx->OnValue     = Json_NullOnValue;
 	String_InitArray(ctx->_tmp, ctx->_tmpBuffer);
+
+	ctx->_parser = JSON_EXPECT_ROOT;
+	ctx->_lexer  = JSON_LEX_NONE;
+	ctx->_str    = &ctx->_tmp;
 }
 
-cc_bool Json_Parse(struct JsonContext* ctx) {
-	int token;
-	do {
-		token = Json_ConsumeToken(ctx);
-		Json_ConsumeValue(token, ctx);
-	} while (token != TOKEN_NONE);
+void Json_Feed(struct JsonContext* ctx, STRING_REF char* data, int len) {
+	ctx->cur  = data;
+	ctx->left = len;
+
+	while (ctx->left) 
+	{
+		switch (ctx->_lexer) {
+		case JSON_LEX_NONE:    Json_ReadToken(ctx);   break;
+		case JSON_LEX_STRING:  Json_ReadString(ctx);  break;
+		case JSON_LEX_ESCAPE:  Json_ReadEscape(ctx);  break;
+		case JSON_LEX_UNICODE: Json_ReadUnicode(ctx); break;
+		case JSON_LEX_NUMBER:  Json_ReadNumber(ctx);  break;
+		case JSON_LEX_LITERAL: Json_ReadLiteral(ctx); break;
+		default:
+			JsonContext_Consume(ctx, ctx->left); break;
+		}
+	}
+}
 
+cc_bool Json_Finish(struct JsonContext* ctx) {
+	switch (ctx->_lexer) {
+	case JSON_LEX_NUMBER:
+		/* number at very end of the JSON */
+		ctx->_lexer = JSON_LEX_NONE;
+		Json_EndValue(ctx, &ctx->_tmp); break;
+	case JSON_LEX_LITERAL:
+		Json_InvalidToken(ctx); break;
+	case JSON_LEX_STRING:
+	case JSON_LEX_ESCAPE:
+	case JSON_LEX_UNICODE:
+		ctx->_str->length = 0;
+		Json_Fail(ctx); break;
+	}
+
+	/* unterminated object or array */
+	if (ctx->depth) ctx->failed = true;
+	ctx->_lexer = JSON_LEX_DONE;
 	return !ctx->failed;
 }
 
+cc_bool Json_Parse(struct JsonContext* ctx) {
+	Json_Feed(ctx, ctx->cur, ctx->left);
+	return Json_Finish(ctx);
+}
+
 static cc_bool Json_Handle(cc_uint8* data, cc_uint32 len, 
 						JsonOnValue onVal, JsonOnNew newArr, JsonOnNew newObj) {
 	struct JsonContext ctx;
@@ -403,6 +521,15 @@ static void ServerInfo_Init(struct ServerInfo* info) {
 	info->_order     = -100000;
 }
 
+/* Strings must point to the new buffers after a ServerInfo is moved in memory */
+static void ServerInfo_Relocate(struct ServerInfo* info) {
+	info->hash.buffer     = info->_hashBuffer;
+	info->name.buffer     = info->_nameBuffer;
+	info->ip.buffer       = info->_ipBuffer;
+	info->mppass.buffer   = info->_mppassBuffer;
+	info->software.buffer = info->_softBuffer;
+}
+
 static void ServerInfo_Parse(struct JsonContext* ctx, const cc_string* val) {
 	struct ServerInfo* info = curServer;
 	if (String_CaselessEqualsConst(&ctx->curKey, "hash")) {
@@ -466,7 +593,11 @@ void FetchServerTask_Run(const cc_string* hash) {
 > ]}
 */
 struct FetchServersData FetchServersTask;
-static void FetchServersTask_Count(struct JsonContext* ctx) {
+static int serversCapacity;
+
+static void FetchServersTask_Next(struct JsonContext* ctx) {
+	struct ServerInfo* servers = FetchServersTask.servers;
+	int i, count = FetchServersTask.numServers;
 	/* JSON is expected in this format: */
 	/*  { "servers" :      (depth = 1)  */
 	/*    [                (depth = 2)  */
@@ -474,13 +605,28 @@ static void FetchServersTask_Count(struct JsonContext* ctx) {
 	/*		 { server2 },  (depth = 3)  */
 	/*          ...                     */
 	if (ctx->depth != 3) return;
+	/* orders are stored as 16 bit indices */
+	if (count == 0xFFFF) { curServer = NULL; return; }
+
+	if (count == serversCapacity) {
+		serversCapacity = count ? count * 2 : 64;
+		if (servers) {
+			servers = (struct ServerInfo*)Mem_Realloc(servers, serversCapacity, sizeof(struct ServerInfo), "servers list");
+			for (i = 0; i < count; i++) ServerInfo_Relocate(&servers[i]);
+		} else {
+			servers = (struct ServerInfo*)Mem_Alloc(serversCapacity, sizeof(struct ServerInfo), "servers list");
+		}
+		FetchServersTask.servers = servers;
+	}
+
+	curServer = &servers[count];
+	ServerInfo_Init(curServer);
 	FetchServersTask.numServers++;
 }
 
-static void FetchServersTask_Next(struct JsonContext* ctx) {
-	if (ctx->depth != 3) return;
-	curServer++;
-	ServerInfo_Init(curServer);
+static void FetchServersTask_OnValue(struct JsonContext* ctx, const cc_string* val) {
+	if (ctx->depth != 3 || !curServer) return;
+	ServerInfo_Parse(ctx, val);
 }
 
 static void FetchServersTask_Handle(cc_uint8* data, cc_uint32 len) {
@@ -496,17 +642,15 @@ static void FetchServersTask_Handle(cc_uint8* data, cc_uint32 len) {
 	FetchServersTask.servers    = NULL;
 	FetchServersTask.orders     = NULL;
 
-	FetchServersTask.numServers = 0;
-	success = Json_Handle(data, len, NULL, NULL, FetchServersTask_Count);
+	/* Servers list is grown as each server is read, so the JSON only needs to be parsed once */
+	serversCapacity = 0;
+	curServer       = NULL;
+	success = Json_Handle(data, len, FetchServersTask_OnValue, NULL, FetchServersTask_Next);
 	count   = FetchServersTask.numServers;
 
 	if (!success) Logger_WarnFunc(&err_msg);
 	if (count <= 0) return;
-	FetchServersTask.servers = (struct ServerInfo*)Mem_Alloc(count, sizeof(struct ServerInfo), "servers list");
-	FetchServersTask.orders  = (cc_uint16*)Mem_Alloc(count, 2, "servers order");
-
-	curServer = FetchServersTask.servers - 1;
-	Json_Handle(data, len, ServerInfo_Parse, NULL, FetchServersTask_Next);
+	FetchServersTask.orders = (cc_uint16*)Mem_Alloc(count, 2, "servers order");
 }
 
 void FetchServersTask_Run(void) {
@@ -13,7 +13,12 @@ struct JsonContext;
 typedef void (*JsonOnValue)(struct JsonContext* ctx, const cc_string* v);
 typedef void (*JsonOnNew)(struct JsonContext* ctx);
 
+/* Maximum nesting depth of objects/arrays in JSON text */
+#define JSON_MAX_DEPTH 16
+
 /* State for parsing JSON text */
+/* NOTE: The JSON text may be provided in chunks, in which case */
+/*  the partial token at the end of a chunk is continued in the next chunk */
 struct JsonContext {
 	char* cur;        /* Pointer to current character in JSON stream being inspected. */
 	int left;         /* Number of characters left to be inspected. */
@@ -24,14 +29,29 @@ struct JsonContext {
 	JsonOnNew OnNewArray;  /* Invoked when start of an array is read. */
 	JsonOnNew OnNewObject; /* Invoked when start of an object is read. */
 	JsonOnValue OnValue;   /* Invoked on each member value in an object/array. */
-	cc_string _tmp; /* temp value used for reading string values */
+	cc_string _tmp; /* temp value used for reading string/number values */
 	char _tmpBuffer[STRING_SIZE];
+
+	/* (internal) parsing state that persists between chunks */
+	cc_uint8 _parser, _lexer, _hexDigits, _literalPos;
+	int _codepoint;
+	cc_string* _str;
+	const cc_string* _literal;
+	char _containers[JSON_MAX_DEPTH];
+	cc_string _parentKeys[JSON_MAX_DEPTH];
+	char _keyBuffers[JSON_MAX_DEPTH][STRING_SIZE];
 };
 /* Initialises state of JSON parser. */
 void Json_Init(struct JsonContext* ctx, STRING_REF char* str, int len);
 /* Parses the JSON text, invoking callbacks when value/array/objects are read. */
 /* NOTE: DO NOT persist the value argument in OnValue. */
 cc_bool Json_Parse(struct JsonContext* ctx);
+/* Parses the next chunk of the JSON text, invoking callbacks as with Json_Parse. */
+/* NOTE: Chunks can split the JSON text anywhere (e.g. in the middle of a string) */
+void Json_Feed(struct JsonContext* ctx, STRING_REF char* data, int len);
+/* Finishes parsing the JSON text after all of its chunks have been fed. */
+/* Returns whether the JSON text was completely and successfully parsed. */
+cc_bool Json_Finish(struct JsonContext* ctx);
 
 /* Represents all known details about a server. */
 struct ServerInfo {
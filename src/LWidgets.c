@@ -676,6 +676,7 @@ void LTable_Add(void* screen, struct LTable* w,
 	w->numColumns = Array_Elems(tableColumns);
 	w->sortingCol = -1;
 	w->opaque     = true;
+	w->_redrawAllRows = true;
 	w->layouts    = layouts;
 	
 	for (i = 0; i < w->numColumns; i++) {
@@ -685,6 +686,20 @@ void LTable_Add(void* screen, struct LTable* w,
 	LScreen_AddWidget(screen, w);
 }
 
+/* Pre-computed data for quickly sorting and filtering the servers list */
+#define LTABLE_NUM_SORTS (Array_Elems(tableColumns) + 1)
+struct LTableKey { int nameLen; char name[STRING_SIZE]; };
+static struct LTableIndex {
+	int count;              /* Number of servers this index was built for */
+	struct LTableKey* keys; /* Lowercased names of each server */
+	/* Stable sort permutation for each column, computed when first needed */
+	/* (0 is default sort order, otherwise column index + 1) */
+	cc_uint16* sorted[LTABLE_NUM_SORTS];
+	/* Filter that the currently visible rows were filtered with */
+	cc_string filter; char _filterBuffer[STRING_SIZE];
+	cc_bool filterValid, showEmpty;
+} tableIndex;
+
 void LTable_Reset(struct LTable* w) {
 	LBackend_TableMouseUp(w, 0);
 	LBackend_TableReposition(w);
@@ -693,28 +708,110 @@ void LTable_Reset(struct LTable* w) {
 	w->rowsCount  = 0;
 	w->_wheelAcc  = 0.0f;
 	w->sortingCol = -1;
+
+	w->_redrawAllRows      = true;
+	tableIndex.filterValid = false;
 }
 
-static int ShouldShowServer(struct LTable* w, struct ServerInfo* server) {
-	return String_CaselessContains(&server->name, w->filter) 
-		&& (Launcher_ShowEmptyServers || server->players > 0);
+static void LTableIndex_Free(void) {
+	int i;
+	for (i = 0; i < LTABLE_NUM_SORTS; i++) 
+	{
+		Mem_Free(tableIndex.sorted[i]);
+		tableIndex.sorted[i] = NULL;
+	}
+	Mem_Free(tableIndex.keys);
+	tableIndex.keys  = NULL;
+	tableIndex.count = 0;
 }
 
-void LTable_ApplyFilter(struct LTable* w) {
-	int i, j, count;
+static void LTableIndex_Build(void) {
+	struct ServerInfo* server;
+	struct LTableKey* key;
+	int i, j, count = FetchServersTask.numServers;
+
+	LTableIndex_Free();
+	tableIndex.filterValid = false;
+	if (!count) return;
+
+	tableIndex.keys  = (struct LTableKey*)Mem_Alloc(count, sizeof(struct LTableKey), "table keys");
+	tableIndex.count = count;
+
+	for (i = 0; i < count; i++) 
+	{
+		server = &FetchServersTask.servers[i];
+		key    = &tableIndex.keys[i];
+		key->nameLen = server->name.length;
+
+		for (j = 0; j < server->name.length; j++) 
+		{
+			key->name[j] = server->name.buffer[j]; 
+			Char_MakeLower(key->name[j]);
+		}
+	}
+}
+
+/* Whether str contains sub, assuming both are already lowercased */
+static cc_bool LTable_Contains(const char* str, int len, const cc_string* sub) {
+	int i, end = len - sub->length;
+	if (!sub->length) return true;
+
+	for (i = 0; i <= end; i++) 
+	{
+		if (str[i] != sub->buffer[0]) continue;
+		if (Mem_Equal(str + i, sub->buffer, sub->length)) return true;
+	}
+	return false;
+}
+
+static cc_bool ShouldShowServer(int i, const cc_string* filter) {
+	struct LTableKey* key = &tableIndex.keys[i];
+	return LTable_Contains(key->name, key->nameLen, filter)
+		&& (Launcher_ShowEmptyServers || FetchServersTask.servers[i].players > 0);
+}
 
-	count = FetchServersTask.numServers;
-	for (i = 0, j = 0; i < count; i++) {
-		if (ShouldShowServer(w, Servers_Get(i))) {
-			FetchServersTask.servers[j++]._order = FetchServersTask.orders[i];
+void LTable_ApplyFilter(struct LTable* w) {
+	cc_string filter; char filterBuffer[STRING_SIZE];
+	int i, j, count, oldCount;
+	struct ServerInfo* servers = FetchServersTask.servers;
+
+	String_InitArray(filter, filterBuffer);
+	String_AppendString(&filter, w->filter);
+	for (i = 0; i < filter.length; i++) { Char_MakeLower(filter.buffer[i]); }
+
+	oldCount = w->rowsCount;
+	count    = FetchServersTask.numServers;
+	if (tableIndex.count != count) LTableIndex_Build();
+
+	/* As the filter grows longer, servers matching it must also match the */
+	/*  previous filter, so just narrow down the currently visible rows */
+	if (tableIndex.filterValid && tableIndex.showEmpty == Launcher_ShowEmptyServers &&
+		LTable_Contains(filter.buffer, filter.length, &tableIndex.filter)) {
+
+		for (i = 0, j = 0; i < oldCount; i++) {
+			if (ShouldShowServer(servers[i]._order, &filter)) {
+				servers[j++]._order = servers[i]._order;
+			}
+		}
+		count = oldCount;
+	} else {
+		for (i = 0, j = 0; i < count; i++) {
+			if (ShouldShowServer(FetchServersTask.orders[i], &filter)) {
+				servers[j++]._order = FetchServersTask.orders[i];
+			}
 		}
 	}
 
 	w->rowsCount = j;
 	for (; j < count; j++) {
-		FetchServersTask.servers[j]._order = -100000;
+		servers[j]._order = -100000;
 	}
 
+	String_InitArray(tableIndex.filter, tableIndex._filterBuffer);
+	String_AppendString(&tableIndex.filter, &filter);
+	tableIndex.filterValid = true;
+	tableIndex.showEmpty   = Launcher_ShowEmptyServers;
+
 	w->_lastRow = -1;
 	LTable_ClampTopRow(w);
 	LBackend_TableUpdate(w);
@@ -722,46 +819,80 @@ void LTable_ApplyFilter(struct LTable* w) {
 
 static int sortingCol;
 static int LTable_SortOrder(const struct ServerInfo* a, const struct ServerInfo* b) {
-	int order;
-	if (sortingCol >= 0) {
-		order = tableColumns[sortingCol].SortOrder(a, b);
-		return tableColumns[sortingCol].invertSort ? -order : order;
-	}
+	if (sortingCol >= 0) return tableColumns[sortingCol].SortOrder(a, b);
 
 	/* Default sort order. (most active server, then by highest uptime) */
 	if (a->players != b->players) return a->players - b->players;
 	return a->uptime - b->uptime;
 }
+#define LTable_Compare(a, b) LTable_SortOrder(&FetchServersTask.servers[a], &FetchServersTask.servers[b])
 
-static void LTable_QuickSort(int left, int right) {
-	cc_uint16* keys = FetchServersTask.orders; cc_uint16 key;
+/* Sorts so that a comes before b when sort order of a and b is > 0 */
+/* NOTE: Servers with equal sort order keep their relative order */
+static void LTable_MergeSort(cc_uint16* keys, cc_uint16* tmp, int count) {
+	int i, j, k, mid = count >> 1;
+	if (count < 2) return;
 
-	while (left < right) {
-		int i = left, j = right;
-		struct ServerInfo* mid = Servers_Get((i + j) >> 1);
+	LTable_MergeSort(keys,       tmp, mid);
+	LTable_MergeSort(keys + mid, tmp, count - mid);
 
-		/* partition the list */
-		while (i <= j) {
-			while (LTable_SortOrder(mid, Servers_Get(i)) < 0) i++;
-			while (LTable_SortOrder(mid, Servers_Get(j)) > 0) j--;
-			QuickSort_Swap_Maybe();
-		}
-		/* recurse into the smaller subset */
-		QuickSort_Recurse(LTable_QuickSort)
+	for (i = 0, j = mid, k = 0; i < mid && j < count; ) {
+		tmp[k++] = LTable_Compare(keys[j], keys[i]) > 0 ? keys[j++] : keys[i++];
 	}
+	while (i < mid)   tmp[k++] = keys[i++];
+	while (j < count) tmp[k++] = keys[j++];
+	Mem_Copy(keys, tmp, count * 2);
+}
+
+static cc_uint16* LTable_GetSorted(void) {
+	cc_uint16** sorted = &tableIndex.sorted[sortingCol + 1];
+	cc_uint16* tmp;
+	int i, count = tableIndex.count;
+	if (*sorted) return *sorted;
+
+	*sorted = (cc_uint16*)Mem_Alloc(count, 2, "table sort order");
+	tmp     = (cc_uint16*)Mem_Alloc(count, 2, "table sort temp");
+	for (i = 0; i < count; i++) (*sorted)[i] = i;
+
+	LTable_MergeSort(*sorted, tmp, count);
+	Mem_Free(tmp);
+	return *sorted;
 }
 
 void LTable_Sort(struct LTable* w) {
-	sortingCol = w->sortingCol;
-	FetchServersTask_ResetOrder();
+	cc_uint16* dst = FetchServersTask.orders;
+	cc_uint16* sorted;
+	int i, beg, end, count;
 
-	if (FetchServersTask.numServers)
-		LTable_QuickSort(0, FetchServersTask.numServers - 1);
+	sortingCol = w->sortingCol;
+	count      = FetchServersTask.numServers;
+	if (tableIndex.count != count) LTableIndex_Build();
+
+	if (count) {
+		sorted = LTable_GetSorted();
+
+		if (sortingCol >= 0 && w->columns[sortingCol].invertSort) {
+			/* Reverse the order, but keep equal servers in their relative order */
+			for (end = count; end > 0; end = beg) {
+				for (beg = end - 1; beg > 0 && !LTable_Compare(sorted[beg - 1], sorted[end - 1]); beg--) { }
+				for (i = beg; i < end; i++) *dst++ = sorted[i];
+			}
+		} else {
+			Mem_Copy(dst, sorted, count * 2);
+		}
+	}
 
+	w->_redrawAllRows      = true;
+	tableIndex.filterValid = false;
 	LTable_ApplyFilter(w);
 	LTable_ShowSelected(w);
 }
 
+void LTable_Refresh(struct LTable* w) {
+	LTableIndex_Build();
+	LTable_Sort(w);
+}
+
 void LTable_ShowSelected(struct LTable* w) {
 	int i = LTable_GetSelectedIndex(w);
 	if (i == -1) return;
@@ -218,6 +218,8 @@ struct LTable {
 	int _lastRow;    /* last clicked row (for doubleclick join) */
 	cc_uint64 _lastClick; /* timestamp of last mouse click on a row */
 	int sortingCol;
+	/* Whether every row must be redrawn, instead of just rows that have changed */
+	cc_bool _redrawAllRows;
 };
 
 struct LTableCell { struct LTable* table; int x, y, width; };
@@ -237,6 +239,8 @@ cc_bool LTable_HandlesKey(int key, struct InputDevice* device);
 void LTable_ApplyFilter(struct LTable* table);
 /* Sorts the rows in the table by current Sorter function of table */
 void LTable_Sort(struct LTable* table);
+/* Rebuilds the sorting/filtering index after the servers list has changed, then sorts rows */
+void LTable_Refresh(struct LTable* table);
 /* If selected row is not visible, adjusts top row so it does show. */
 void LTable_ShowSelected(struct LTable* table);
 
@@ -269,6 +269,36 @@ void ClassicLighting_OnBlockChanged(int x, int y, int z, BlockID oldBlock, Block
 	ClassicLighting_RefreshAffected(x, y, z, newBlock, lightH + 1, newHeight);
 }
 
+static void ClassicLighting_OnColumnChanged(int x, int z, int minY, int maxY) {
+	int cx = x >> CHUNK_SHIFT, bX = x & CHUNK_MASK;
+	int cz = z >> CHUNK_SHIFT, bZ = z & CHUNK_MASK;
+	int hIndex = Lighting_Pack(x, z);
+	int lightH = classic_heightmap[hIndex];
+	int newHeight, oldCy, newCy, minCy, maxCy;
+
+	/* Column never had meshes for any of its chunks built, see ClassicLighting_OnBlockChanged */
+	if (lightH == HEIGHT_UNCALCULATED) return;
+	/* Blocks below the topmost block that stops light can't change the light height */
+	if (maxY < lightH) return;
+
+	/* Blocks above both the old light height and the highest changed block still don't stop light */
+	newHeight = ClassicLighting_CalcHeightAt(x, min(World.MaxY, max(maxY, lightH + 1)), z, hIndex);
+	if (newHeight == lightH) return;
+
+	/* The chunks containing the changed blocks are refreshed by the caller, */
+	/*  so only need to refresh chunks that are now in sun instead of shadow (or vice versa) */
+	oldCy = lightH    + 1 < 0 ? 0 : (lightH    + 1) >> 4;
+	newCy = newHeight + 1 < 0 ? 0 : (newHeight + 1) >> 4;
+	minCy = min(oldCy, newCy); maxCy = max(oldCy, newCy);
+	ClassicLighting_ResetColumn(cx, minCy, cz, minCy, maxCy);
+
+	/* Faces of blocks in neighbouring columns are also lit using this column's light height */
+	if (bX == 0 && cx > 0)                      ClassicLighting_ResetColumn(cx - 1, minCy, cz, minCy, maxCy);
+	if (bZ == 0 && cz > 0)                      ClassicLighting_ResetColumn(cx, minCy, cz - 1, minCy, maxCy);
+	if (bX == 15 && cx < World.ChunksX - 1)     ClassicLighting_ResetColumn(cx + 1, minCy, cz, minCy, maxCy);
+	if (bZ == 15 && cz < World.ChunksZ - 1)     ClassicLighting_ResetColumn(cx, minCy, cz + 1, minCy, maxCy);
+}
+
 
 /*########################################################################################################################*
 *---------------------------------------------------Lighting heightmap----------------------------------------------------*
@@ -404,11 +434,12 @@ static void ClassicLighting_SetActive(void) {
 	cc_bool smoothLighting = false;
 	if (!Game_ClassicMode) smoothLighting = Options_GetBool(OPT_SMOOTH_LIGHTING, false);
 
-	Lighting.OnBlockChanged = ClassicLighting_OnBlockChanged;
-	Lighting.Refresh        = ClassicLighting_Refresh;
-	Lighting.IsLit          = ClassicLighting_IsLit;
-	Lighting.Color          = smoothLighting ? SmoothLighting_Color : ClassicLighting_Color;
-	Lighting.Color_XSide    = ClassicLighting_Color_XSide;
+	Lighting.OnBlockChanged  = ClassicLighting_OnBlockChanged;
+	Lighting.OnColumnChanged = ClassicLighting_OnColumnChanged;
+	Lighting.Refresh         = ClassicLighting_Refresh;
+	Lighting.IsLit           = ClassicLighting_IsLit;
+	Lighting.Color           = smoothLighting ? SmoothLighting_Color : ClassicLighting_Color;
+	Lighting.Color_XSide     = ClassicLighting_Color_XSide;
 
 	Lighting.IsLit_Fast        = ClassicLighting_IsLit_Fast;
 	Lighting.Color_Sprite_Fast = ClassicLighting_Color_Sprite_Fast;
@@ -72,6 +72,12 @@ CC_VAR extern struct _Lighting {
 	PackedCol (*Color_YMin_Fast)(int x, int y, int z);
 	PackedCol (*Color_XSide_Fast)(int x, int y, int z);
 	PackedCol (*Color_ZSide_Fast)(int x, int y, int z);
+
+	/* Called after a batch of block changes, once for each column with changed blocks */
+	/*  (minY and maxY are the lowest and highest changed blocks in that column) */
+	/* NULL if OnBlockChanged must instead be called for every single block change */
+	/* NOTE: Implementations ***MUST*** mark all chunks affected by this lighting change as needing to be refreshed. */
+	void (*OnColumnChanged)(int x, int z, int minY, int maxY);
 } Lighting;
 
 void FancyLighting_SetActive(void);
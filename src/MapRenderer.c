@@ -51,7 +51,8 @@ static void ChunkInfo_Reset(struct ChunkInfo* chunk, int x, int y, int z) {
 	chunk->centreX = x + HALF_CHUNK_SIZE; chunk->centreY = y + HALF_CHUNK_SIZE; 
 	chunk->centreZ = z + HALF_CHUNK_SIZE;
 #ifndef CC_BUILD_GL11
-	chunk->vb = 0;
+	chunk->vb      = 0;
+	chunk->vbCount = 0;
 #endif
 
 	chunk->visible = true;  
@@ -59,6 +60,7 @@ static void ChunkInfo_Reset(struct ChunkInfo* chunk, int x, int y, int z) {
 	chunk->dirty   = false; 
 	chunk->allAir  = false;
 	chunk->noData  = true;
+	chunk->lod     = 0;
 
 	chunk->drawXMin = false; chunk->drawXMax = false; chunk->drawZMin = false;
 	chunk->drawZMax = false; chunk->drawYMin = false; chunk->drawYMax = false;
@@ -308,6 +310,124 @@ void MapRenderer_RenderTranslucent(float delta) {
 }
 
 
+/*########################################################################################################################*
+*-------------------------------------------------Chunk vertex buffer arena-----------------------------------------------*
+*#########################################################################################################################*/
+#ifndef CC_BUILD_GL11
+/* Rebuilding a chunk used to always destroy its vertex buffer and then create a new one, */
+/*  which on busy servers constantly churns the graphics driver's allocator. */
+/* Instead, vertex buffers are rounded up to a size class and recycled through per class free lists */
+/* NOTE: A size class has 4 steps per power of two, so at most 25% of a buffer is wasted */
+#define ARENA_CLASSES 56
+#define ARENA_MIN_SHIFT 6 /* smallest class is 4 << 6 = 256 vertices */
+/* Maximum combined size of free vertex buffers, before the largest ones start getting deleted */
+#define ARENA_MAX_FREE_VERTICES ((8 * 1024 * 1024) / SIZEOF_VERTEX_TEXTURED)
+
+struct _ChunkVbArenaStats ChunkVbArena;
+static GfxResourceID* arenaFree[ARENA_CLASSES];
+static int arenaFreeCount[ARENA_CLASSES], arenaFreeCapacity[ARENA_CLASSES];
+
+static int Arena_Capacity(int cls) {
+	return (4 + (cls & 3)) << ((cls >> 2) + ARENA_MIN_SHIFT);
+}
+
+static int Arena_Class(int count) {
+	int cls;
+	for (cls = 0; cls < ARENA_CLASSES - 1; cls++) 
+	{
+		if (count <= Arena_Capacity(cls)) return cls;
+	}
+	return cls;
+}
+
+static void Arena_DeleteFree(int cls) {
+	GfxResourceID vb = arenaFree[cls][--arenaFreeCount[cls]];
+	Gfx_DeleteVb(&vb);
+
+	ChunkVbArena.FreeVbs--;
+	ChunkVbArena.FreeVertices -= Arena_Capacity(cls);
+}
+
+/* Deletes free vertex buffers (largest first) until the free lists are within budget */
+static void Arena_Compact(cc_uint32 maxFreeVertices) {
+	int cls;
+	for (cls = ARENA_CLASSES - 1; cls >= 0; cls--) 
+	{
+		while (arenaFreeCount[cls] && ChunkVbArena.FreeVertices > maxFreeVertices) {
+			Arena_DeleteFree(cls);
+			ChunkVbArena.Trimmed++;
+		}
+	}
+}
+
+/* Deletes all free vertex buffers (e.g. when the graphics context is lost) */
+static void Arena_Clear(void) {
+	int cls;
+	for (cls = 0; cls < ARENA_CLASSES; cls++) 
+	{
+		while (arenaFreeCount[cls]) Arena_DeleteFree(cls);
+
+		Mem_Free(arenaFree[cls]);
+		arenaFree[cls]          = NULL;
+		arenaFreeCapacity[cls]  = 0;
+	}
+}
+
+static void Arena_Release(struct ChunkInfo* info) {
+	int cls;
+	if (!info->vb) return;
+
+	cls = Arena_Class(info->vbCount);
+	ChunkVbArena.LiveVbs--;
+	ChunkVbArena.LiveVertices -= Arena_Capacity(cls);
+	ChunkVbArena.UsedVertices -= info->vbCount;
+
+	if (arenaFreeCount[cls] == arenaFreeCapacity[cls]) {
+		Utils_Resize((void**)&arenaFree[cls], &arenaFreeCapacity[cls],
+					sizeof(GfxResourceID), 8, 8);
+	}
+	arenaFree[cls][arenaFreeCount[cls]++] = info->vb;
+	ChunkVbArena.FreeVbs++;
+	ChunkVbArena.FreeVertices += Arena_Capacity(cls);
+
+	info->vb      = 0;
+	info->vbCount = 0;
+	if (ChunkVbArena.FreeVertices > ARENA_MAX_FREE_VERTICES) Arena_Compact(ARENA_MAX_FREE_VERTICES);
+}
+
+void* MapRenderer_LockChunkVb(struct ChunkInfo* info, int count) {
+	int cls, capacity;
+	Arena_Release(info);
+
+	cls      = Arena_Class(count);
+	capacity = Arena_Capacity(cls);
+
+	if (arenaFreeCount[cls]) {
+		info->vb = arenaFree[cls][--arenaFreeCount[cls]];
+		ChunkVbArena.FreeVbs--;
+		ChunkVbArena.FreeVertices -= capacity;
+		ChunkVbArena.Reused++;
+	} else {
+		info->vb = Gfx_CreateVb(VERTEX_FORMAT_TEXTURED, capacity);
+		ChunkVbArena.Created++;
+	}
+
+	info->vbCount = count;
+	ChunkVbArena.LiveVbs++;
+	ChunkVbArena.LiveVertices += capacity;
+	ChunkVbArena.UsedVertices += count;
+	/* Only the used vertices are uploaded, the rest of the buffer's capacity is left as is */
+	return Gfx_LockVb(info->vb, VERTEX_FORMAT_TEXTURED, count);
+}
+
+int MapRenderer_ArenaFragmentation(void) {
+	cc_uint32 total = ChunkVbArena.LiveVertices + ChunkVbArena.FreeVertices;
+	if (!total) return 0;
+	return (int)((cc_uint64)(total - ChunkVbArena.UsedVertices) * 100 / total);
+}
+#endif
+
+
 /*########################################################################################################################*
 *---------------------------------------------------Chunk functionality---------------------------------------------------*
 *#########################################################################################################################*/
@@ -318,7 +438,7 @@ static void DeleteChunk(struct ChunkInfo* info) {
 #ifdef CC_BUILD_GL11
 	int j;
 #else
-	Gfx_DeleteVb(&info->vb);
+	Arena_Release(info);
 #endif
 
 	info->empty  = false; 
@@ -365,6 +485,8 @@ static void BuildChunk(struct ChunkInfo* info, int* chunkUpdates) {
 
 	info->dirty  = false;
 	info->noData = !info->normalParts && !info->translucentParts;
+	/* NOTE: A lower detail mesh may have no faces even though the full detail mesh does, */
+	/*  so empty chunks remember their level of detail (see IsEmptyAtLod) */
 	info->empty  = info->noData;
 	if (info->empty) return;
 	
@@ -474,6 +596,9 @@ static void DeleteChunks(void) {
 		DeleteChunk(&mapChunks[i]);
 	}
 	ResetPartCounts();
+#ifndef CC_BUILD_GL11
+	Arena_Clear();
+#endif
 }
 
 void MapRenderer_Refresh(void) {
@@ -522,6 +647,8 @@ static void RefreshBorderChunks(int maxHeight) {
 *#########################################################################################################################*/
 #define CHUNK_TARGET_TIME ((1.0f/30) + 0.01f)
 static int chunksTarget = 12;
+/* Max chunks rebuilt per frame just to change their level of detail */
+static int lodTarget = 3;
 static Vec3 lastCamPos;
 static float lastYaw, lastPitch;
 /* Max distance from camera that chunks are rendered within */
@@ -542,19 +669,70 @@ static void CalcViewDists(void) {
 	renderDistSquared = AdjustDist(Game_ViewDistance);
 }
 
+/* Squared distances from camera past which chunks are built at a lower level of detail */
+static int lod1DistSquared = Int32_MaxValue, lod2DistSquared = Int32_MaxValue;
+/* Chunks must be this many blocks past a level of detail boundary before switching level, */
+/*  so that chunks near a boundary aren't constantly rebuilt as the camera moves back and forth */
+#define LOD_MARGIN CHUNK_SIZE
+/* Squared distances from camera past which a chunk moves to (enter) or from (leave) a level of detail */
+static int lodEnterSquared[3], lodLeaveSquared[3];
+
+static void CalcLodDists(int dist) {
+	int lod, lodDist, leaveDist;
+	if (!dist) {
+		lod1DistSquared = Int32_MaxValue;
+		lod2DistSquared = Int32_MaxValue;
+	} else {
+		lod1DistSquared = dist * dist;
+		lod2DistSquared = (dist * 2) * (dist * 2);
+	}
+
+	for (lod = 1; lod < 3; lod++) 
+	{
+		lodDist   = dist * lod;
+		leaveDist = max(0, lodDist - LOD_MARGIN);
+
+		lodEnterSquared[lod] = dist ? (lodDist + LOD_MARGIN) * (lodDist + LOD_MARGIN) : Int32_MaxValue;
+		lodLeaveSquared[lod] = dist ? leaveDist * leaveDist : 0;
+	}
+}
+
+int MapRenderer_CalcLod(int distSqr) {
+	if (distSqr >= lod2DistSquared) return 2;
+	if (distSqr >= lod1DistSquared) return 1;
+	return 0;
+}
+
+/* Calculates the level of detail for a chunk currently at the given level of detail */
+static int UpdateLod(int lod, int distSqr) {
+	while (lod < 2 && distSqr >= lodEnterSquared[lod + 1]) lod++;
+	while (lod > 0 && distSqr <  lodLeaveSquared[lod])     lod--;
+	return lod;
+}
+
+/* Whether the given chunk's mesh is empty, and would still be empty at its new level of detail */
+/* NOTE: Only meshes built at a lower detail need to be rebuilt at a higher detail, */
+/*  since merging blocks into cells may have turned the few blocks in the chunk into air */
+static cc_bool IsEmptyAtLod(struct ChunkInfo* info, int distSqr) {
+	if (!info->empty) return false;
+	if (info->allAir || info->lod <= UpdateLod(info->lod, distSqr)) return true;
+
+	info->empty = false;
+	return false;
+}
+
 static int UpdateChunksAndVisibility(int* chunkUpdates) {
 	int renderDistSqr = renderDistSquared;
 	int buildDistSqr  = buildDistSquared;
 
 	struct ChunkInfo* info;
-	int i, j = 0, distSqr;
+	int i, j = 0, distSqr, lod;
 	cc_bool noData;
 
 	for (i = 0; i < chunksCount; i++) {
-		info = sortedChunks[i];
-		if (info->empty) continue;
-
+		info    = sortedChunks[i];
 		distSqr = distances[i];
+		if (IsEmptyAtLod(info, distSqr)) continue;
 		noData  = info->noData;
 		
 		/* Auto unload chunks far away chunks */
@@ -562,9 +740,16 @@ static int UpdateChunksAndVisibility(int* chunkUpdates) {
 			DeleteChunk(info); continue;
 		}
 		noData |= info->dirty;
+		lod     = UpdateLod(info->lod, distSqr);
 
 		if (noData && distSqr <= buildDistSqr && *chunkUpdates < chunksTarget) {
 			DeleteChunk(info);
+			info->lod = lod;
+			BuildChunk(info, chunkUpdates);
+		} else if (!noData && info->lod != lod && *chunkUpdates < lodTarget) {
+			/* Changing level of detail is low priority compared to building missing chunks */
+			DeleteChunk(info);
+			info->lod = lod;
 			BuildChunk(info, chunkUpdates);
 		}
 
@@ -580,14 +765,13 @@ static int UpdateChunksStill(int* chunkUpdates) {
 	int buildDistSqr  = buildDistSquared;
 
 	struct ChunkInfo* info;
-	int i, j = 0, distSqr;
+	int i, j = 0, distSqr, lod;
 	cc_bool noData;
 
 	for (i = 0; i < chunksCount; i++) {
-		info = sortedChunks[i];
-		if (info->empty) continue;
-
+		info    = sortedChunks[i];
 		distSqr = distances[i];
+		if (IsEmptyAtLod(info, distSqr)) continue;
 		noData  = info->noData;
 
 		/* Auto unload chunks far away chunks */
@@ -595,15 +779,22 @@ static int UpdateChunksStill(int* chunkUpdates) {
 			DeleteChunk(info); continue;
 		}
 		noData |= info->dirty;
+		lod     = UpdateLod(info->lod, distSqr);
 
 		if (noData && distSqr <= buildDistSqr && *chunkUpdates < chunksTarget) {
 			DeleteChunk(info);
+			info->lod = lod;
 			BuildChunk(info, chunkUpdates);
 
 			/* only need to update the visibility of chunks in range. */
 			info->visible = distSqr <= renderDistSqr &&
 				FrustumCulling_SphereInFrustum(info->centreX, info->centreY, info->centreZ, 14); /* 14 ~ sqrt(3 * 8^2) */
 			if (info->visible && !info->empty) { renderChunks[j] = info; j++; }
+		} else if (!noData && info->lod != lod && *chunkUpdates < lodTarget) {
+			DeleteChunk(info);
+			info->lod = lod;
+			BuildChunk(info, chunkUpdates);
+			if (info->visible && !info->empty) { renderChunks[j] = info; j++; }
 		} else if (info->visible) {
 			renderChunks[j] = info; j++;
 		}
@@ -619,6 +810,8 @@ static void UpdateChunks(float delta) {
 	/* Build more chunks if 30 FPS or over, otherwise slowdown */
 	chunksTarget += delta < CHUNK_TARGET_TIME ? 1 : -1; 
 	Math_Clamp(chunksTarget, 4, maxChunkUpdates);
+	/* Always allow at least one, otherwise low chunk update limits never switch LOD */
+	lodTarget = max(1, chunksTarget >> 2);
 
 	p = Entities.CurPlayer;
 	samePos = Vec3_Equals(&Camera.CurrentPos, &lastCamPos)
@@ -714,14 +907,13 @@ void MapRenderer_RefreshChunk(int cx, int cy, int cz) {
 	info->dirty = true;
 }
 
-void MapRenderer_OnBlockChanged(int x, int y, int z, BlockID block) {
-	int cx = x >> CHUNK_SHIFT, cy = y >> CHUNK_SHIFT, cz = z >> CHUNK_SHIFT;
-	struct ChunkInfo* chunk;
+void MapRenderer_OnChunkChanged(int cx, int cy, int cz, cc_bool allAir) {
+	struct ChunkInfo* chunk = &mapChunks[World_ChunkPack(cx, cy, cz)];
+	chunk->allAir &= allAir;
 
-	chunk = &mapChunks[World_ChunkPack(cx, cy, cz)];
-	chunk->allAir &= Blocks.Draw[block] == DRAW_GAS;
-	/* TODO: Don't lookup twice, refresh directly using chunk pointer */
-	MapRenderer_RefreshChunk(cx, cy, cz);
+	if (chunk->allAir) return; /* do not recreate chunks completely air */
+	chunk->empty = false;
+	chunk->dirty = true;
 }
 
 static void OnEnvVariableChanged(void* obj, int envVar) {
@@ -802,6 +994,7 @@ static void OnInit(void) {
 	chunkPos   = IVec3_MaxValue();
 	maxChunkUpdates = Options_GetInt(OPT_MAX_CHUNK_UPDATES, 4, 1024, 30);
 	CalcViewDists();
+	CalcLodDists(Options_GetInt(OPT_LOD_DISTANCE, 0, 4096, 0));
 }
 
 struct IGameComponent MapRenderer_Component = {
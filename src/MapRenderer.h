@@ -41,6 +41,7 @@ struct ChunkInfo {
 	cc_uint8 dirty : 1;   /* Whether chunk is pending being rebuilt */
 	cc_uint8 allAir : 1;  /* Whether chunk is completely air */
 	cc_uint8 noData : 1;  /* Whether the chunk is currently empty of data, but may have data if built */
+	cc_uint8 lod : 2;     /* Level of detail the chunk's mesh is built at (0 = full detail) */
 	cc_uint8 : 0;         /* pad to next byte*/
 
 	cc_uint8 drawXMin : 1;
@@ -56,11 +57,33 @@ struct ChunkInfo {
 #endif
 #ifndef CC_BUILD_GL11
 	GfxResourceID vb;
+	int vbCount; /* Number of vertices acquired from the chunk vertex buffer arena */
 #endif
 	struct ChunkPartInfo* normalParts;
 	struct ChunkPartInfo* translucentParts;
 };
 
+#ifndef CC_BUILD_GL11
+/* Statistics about the arena that chunk vertex buffers are allocated from. */
+/* Chunk vertex buffers are created with a capacity rounded up to a size class, */
+/*  and are returned to a free list for that size class when the chunk is deleted. */
+extern struct _ChunkVbArenaStats {
+	int Created;  /* Number of vertex buffers created by the arena */
+	int Reused;   /* Number of times a vertex buffer was reused from a free list */
+	int Trimmed;  /* Number of free vertex buffers deleted to stay within budget */
+	int LiveVbs;  /* Number of vertex buffers currently used by chunks */
+	int FreeVbs;  /* Number of vertex buffers currently in the free lists */
+	cc_uint32 LiveVertices; /* Total capacity (in vertices) of vertex buffers used by chunks */
+	cc_uint32 UsedVertices; /* Total vertices actually used by chunks */
+	cc_uint32 FreeVertices; /* Total capacity (in vertices) of vertex buffers in the free lists */
+} ChunkVbArena;
+
+/* Acquires a vertex buffer with room for at least count vertices, then locks the first count vertices. */
+void* MapRenderer_LockChunkVb(struct ChunkInfo* info, int count);
+/* Percentage of vertex buffer capacity in the arena that is not used by chunk vertices */
+int MapRenderer_ArenaFragmentation(void);
+#endif
+
 /* Renders the meshes of non-translucent blocks in visible chunks. */
 void MapRenderer_RenderNormal(float delta);
 /* Renders the meshes of translucent blocks in visible chunks. */
@@ -73,8 +96,12 @@ void MapRenderer_Update(float delta);
 /* Marks the given chunk as needing to be rebuilt/redrawn. */
 /* NOTE: Coordinates outside the map are simply ignored. */
 void MapRenderer_RefreshChunk(int cx, int cy, int cz);
-/* Called when a block is changed, to update internal state. */
-void MapRenderer_OnBlockChanged(int x, int y, int z, BlockID block);
+/* Calculates the level of detail a chunk at the given squared distance from the camera is built at. */
+/* 0 = full detail, 1 = 2x2x2 blocks per cell, 2 = 4x4x4 blocks per cell */
+int MapRenderer_CalcLod(int distSqr);
+/* Called after blocks in the given chunk changed, to update internal state. */
+/* allAir is whether all of the changed blocks are now air. */
+void MapRenderer_OnChunkChanged(int cx, int cy, int cz, cc_bool allAir);
 /* Deletes all chunks and resets internal state. */
 void MapRenderer_Refresh(void);
 
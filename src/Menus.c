@@ -24,7 +24,6 @@
 #include "Audio.h"
 #include "Screens.h"
 #include "Gui.h"
-#include "Deflate.h"
 #include "Stream.h"
 #include "Builder.h"
 #include "Lighting.h"
@@ -1330,56 +1329,6 @@ static void SaveLevelScreen_RemoveOverwrites(struct SaveLevelScreen* s) {
 	}
 }
 
-static cc_result DoSaveMap(const cc_string* path, struct GZipState* state) {
-	static const cc_string schematic = String_FromConst(".schematic");
-	static const cc_string mine      = String_FromConst(".mine");
-	struct Stream stream, compStream;
-	cc_result res;
-
-	res = Stream_CreateFile(&stream, path);
-	if (res) { Logger_SysWarn2(res, "creating", path); return res; }
-	GZip_MakeStream(&compStream, state, &stream);
-
-	if (String_CaselessEnds(path, &schematic)) {
-		res = Schematic_Save(&compStream);
-	} else if (String_CaselessEnds(path, &mine)) {
-		res = Dat_Save(&compStream);
-	} else {
-		res = Cw_Save(&compStream);
-	}
-
-	if (res) {
-		stream.Close(&stream);
-		Logger_SysWarn2(res, "encoding", path); return res;
-	}
-
-	if ((res = compStream.Close(&compStream))) {
-		stream.Close(&stream);
-		Logger_SysWarn2(res, "closing", path); return res;
-	}
-
-	res = stream.Close(&stream);
-	if (res) { Logger_SysWarn2(res, "closing", path); return res; }
-	return 0;
-}
-
-static cc_result SaveLevelScreen_SaveMap(const cc_string* path) {
-	struct GZipState* state;
-	cc_result res;
-
-	state = Mem_TryAlloc(1, sizeof(struct GZipState));
-	res   = ERR_OUT_OF_MEMORY;
-	if (!state) { Logger_SysWarn(res, "allocating temp memory"); return res; }
-
-	res = DoSaveMap(path, state);
-	Mem_Free(state);
-	if (res) return res;
-
-	World.LastSave = Game.Time;
-	Gui_ShowPauseMenu();
-	return 0;
-}
-
 static void SaveLevelScreen_Save(void* screen, void* widget) { 
 	struct SaveLevelScreen* s = (struct SaveLevelScreen*)screen;
 	struct ButtonWidget* btn  = (struct ButtonWidget*)widget;
@@ -1405,13 +1354,14 @@ static void SaveLevelScreen_Save(void* screen, void* widget) {
 	}
 		
 	SaveLevelScreen_RemoveOverwrites(s);
-	if ((res = SaveLevelScreen_SaveMap(&path))) return;
-	Chat_Add1("&eSaved map to: %s", &path);
+	/* Result is reported in chat (and World.LastSave updated) once the map has been written */
+	if ((res = Map_SaveAsync(&path, false))) return;
+	Gui_ShowPauseMenu();
 }
 
 static void SaveLevelScreen_UploadCallback(const cc_string* path) {
-	cc_result res = SaveLevelScreen_SaveMap(path);
-	if (!res) Chat_Add1("&eSaved map to: %s", path);
+	/* Result is reported in chat (and World.LastSave updated) by Map_Save */
+	if (!Map_Save(path)) Gui_ShowPauseMenu();
 }
 
 static void SaveLevelScreen_File(void* screen, void* b) {
@@ -2556,9 +2506,7 @@ static int TexIdsOverlay_RenderTerrain(struct TexIdsOverlay* s, int offset) {
 	int i, count = Atlas1D.TilesPerAtlas * 4;
 	for (i = 0; i < Atlas1D.Count; i++) 
 	{
-		Atlas1D_Bind(i);
-
-		Gfx_DrawVb_IndexedTris_Range(count, offset);
+		Gfx_Draw2DRange(Atlas1D_Texture(i), count, offset);
 		offset += count;
 	}
 	return offset;
@@ -2593,14 +2541,11 @@ static void TexIdsOverlay_Render(void* screen, float delta) {
 	int offset = 0;
 	Menu_RenderBounds();
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	Gfx_BindDynamicVb(s->vb);
+	Gfx_Bind2DVb(s->vb);
 
 	offset = Widget_Render2(&s->title, offset);
 	offset = TexIdsOverlay_RenderTerrain(s, offset);
-
-	Gfx_BindTexture(s->idAtlas.tex.ID);
-	Gfx_DrawVb_IndexedTris_Range(s->textVertices, offset);
+	Gfx_Draw2DRange(s->idAtlas.tex.ID, s->textVertices, offset);
 }
 
 static int TexIdsOverlay_KeyDown(void* screen, int key, struct InputDevice* device) {
@@ -213,6 +213,8 @@ void Model_DrawPart(struct ModelPart* part) {
 	struct Model* model        = Models.Active;
 	struct ModelVertex* src    = &model->vertices[part->offset];
 	struct VertexTextured* dst = &Models.Vertices[model->index];
+	float uScale = Models.uScale, uOffset = 0.01f * Models.uScale;
+	float vScale = Models.vScale, vOffset = 0.01f * Models.vScale;
 
 	struct ModelVertex v;
 	int i, count = part->count;
@@ -222,62 +224,94 @@ void Model_DrawPart(struct ModelPart* part) {
 		dst->x = v.x; dst->y = v.y; dst->z = v.z;
 		dst->Col = Models.Cols[i >> 2];
 
-		dst->U = (v.u & UV_POS_MASK) * Models.uScale - (v.u >> UV_MAX_SHIFT) * 0.01f * Models.uScale;
-		dst->V = (v.v & UV_POS_MASK) * Models.vScale - (v.v >> UV_MAX_SHIFT) * 0.01f * Models.vScale;
+		dst->U = (v.u & UV_POS_MASK) * uScale - (v.u >> UV_MAX_SHIFT) * uOffset;
+		dst->V = (v.v & UV_POS_MASK) * vScale - (v.v >> UV_MAX_SHIFT) * vOffset;
 		src++; dst++;
 	}
 	model->index += count;
 }
 
-#define Model_RotateX t = cosX * v.y + sinX * v.z; v.z = -sinX * v.y + cosX * v.z; v.y = t;
-#define Model_RotateY t = cosY * v.x - sinY * v.z; v.z =  sinY * v.x + cosY * v.z; v.x = t;
-#define Model_RotateZ t = cosZ * v.x + sinZ * v.y; v.y = -sinZ * v.x + cosZ * v.y; v.x = t;
+/* 3x3 rotation matrix, stored in row major order */
+struct PartRotation { float m[9]; };
+
+/* Sets rot to 'a * rot' */
+static void PartRotation_Apply(struct PartRotation* rot, const struct PartRotation* a) {
+	struct PartRotation r;
+	const float* b = rot->m;
+	int row;
+
+	for (row = 0; row < 9; row += 3) {
+		r.m[row + 0] = a->m[row] * b[0] + a->m[row + 1] * b[3] + a->m[row + 2] * b[6];
+		r.m[row + 1] = a->m[row] * b[1] + a->m[row + 1] * b[4] + a->m[row + 2] * b[7];
+		r.m[row + 2] = a->m[row] * b[2] + a->m[row + 1] * b[5] + a->m[row + 2] * b[8];
+	}
+	*rot = r;
+}
+
+static void PartRotation_RotX(struct PartRotation* rot, float c, float s) {
+	struct PartRotation r = {{ 1,0,0,  0,c,s,  0,-s,c }};
+	PartRotation_Apply(rot, &r);
+}
+static void PartRotation_RotY(struct PartRotation* rot, float c, float s) {
+	struct PartRotation r = {{ c,0,-s,  0,1,0,  s,0,c }};
+	PartRotation_Apply(rot, &r);
+}
+static void PartRotation_RotZ(struct PartRotation* rot, float c, float s) {
+	struct PartRotation r = {{ c,s,0,  -s,c,0,  0,0,1 }};
+	PartRotation_Apply(rot, &r);
+}
 
 void Model_DrawRotate(float angleX, float angleY, float angleZ, struct ModelPart* part, cc_bool head) {
 	struct Model* model        = Models.Active;
 	struct ModelVertex* src    = &model->vertices[part->offset];
 	struct VertexTextured* dst = &Models.Vertices[model->index];
+	float uScale = Models.uScale, uOffset = 0.01f * Models.uScale;
+	float vScale = Models.vScale, vOffset = 0.01f * Models.vScale;
 
 	float cosX = Math_CosF(-angleX), sinX = Math_SinF(-angleX);
 	float cosY = Math_CosF(-angleY), sinY = Math_SinF(-angleY);
 	float cosZ = Math_CosF(-angleZ), sinZ = Math_SinF(-angleZ);
-	float t, x = part->rotX, y = part->rotY, z = part->rotZ;
+	float x = part->rotX, y = part->rotY, z = part->rotZ;
+	struct PartRotation rot = {{ 1,0,0, 0,1,0, 0,0,1 }};
+	const float* m = rot.m;
 	
 	struct ModelVertex v;
 	int i, count = part->count;
 
+	/* Combine all the rotations into one matrix once, instead of rotating every vertex 3-4 times */
+	/* Rotate locally */
+	if (Models.Rotation == ROTATE_ORDER_ZYX) {
+		PartRotation_RotZ(&rot, cosZ, sinZ);
+		PartRotation_RotY(&rot, cosY, sinY);
+		PartRotation_RotX(&rot, cosX, sinX);
+	} else if (Models.Rotation == ROTATE_ORDER_XZY) {
+		PartRotation_RotX(&rot, cosX, sinX);
+		PartRotation_RotZ(&rot, cosZ, sinZ);
+		PartRotation_RotY(&rot, cosY, sinY);
+	} else if (Models.Rotation == ROTATE_ORDER_YZX) {
+		PartRotation_RotY(&rot, cosY, sinY);
+		PartRotation_RotZ(&rot, cosZ, sinZ);
+		PartRotation_RotX(&rot, cosX, sinX);
+	} else if (Models.Rotation == ROTATE_ORDER_XYZ) {
+		PartRotation_RotX(&rot, cosX, sinX);
+		PartRotation_RotY(&rot, cosY, sinY);
+		PartRotation_RotZ(&rot, cosZ, sinZ);
+	}
+
+	/* Rotate globally */
+	if (head) PartRotation_RotY(&rot, Models.cosHead, Models.sinHead);
+
 	for (i = 0; i < count; i++) {
 		v = *src;
 		v.x -= x; v.y -= y; v.z -= z;
 
-		/* Rotate locally */
-		if (Models.Rotation == ROTATE_ORDER_ZYX) {
-			Model_RotateZ
-			Model_RotateY
-			Model_RotateX
-		} else if (Models.Rotation == ROTATE_ORDER_XZY) {
-			Model_RotateX
-			Model_RotateZ
-			Model_RotateY
-		} else if (Models.Rotation == ROTATE_ORDER_YZX) {
-			Model_RotateY
-			Model_RotateZ
-			Model_RotateX
-		} else if (Models.Rotation == ROTATE_ORDER_XYZ) {
-			Model_RotateX
-			Model_RotateY
-			Model_RotateZ
-		}
-
-		/* Rotate globally (inlined RotY) */
-		if (head) {
-			t = Models.cosHead * v.x - Models.sinHead * v.z; v.z = Models.sinHead * v.x + Models.cosHead * v.z; v.x = t;
-		}
-		dst->x = v.x + x; dst->y = v.y + y; dst->z = v.z + z;
+		dst->x = m[0] * v.x + m[1] * v.y + m[2] * v.z + x;
+		dst->y = m[3] * v.x + m[4] * v.y + m[5] * v.z + y;
+		dst->z = m[6] * v.x + m[7] * v.y + m[8] * v.z + z;
 		dst->Col = Models.Cols[i >> 2];
 
-		dst->U = (v.u & UV_POS_MASK) * Models.uScale - (v.u >> UV_MAX_SHIFT) * 0.01f * Models.uScale;
-		dst->V = (v.v & UV_POS_MASK) * Models.vScale - (v.v >> UV_MAX_SHIFT) * 0.01f * Models.vScale;
+		dst->U = (v.u & UV_POS_MASK) * uScale - (v.u >> UV_MAX_SHIFT) * uOffset;
+		dst->V = (v.v & UV_POS_MASK) * vScale - (v.v >> UV_MAX_SHIFT) * vOffset;
 		src++; dst++;
 	}
 	model->index += count;
@@ -10,6 +10,7 @@
 
 struct StringsBuffer Options;
 static struct StringsBuffer changedOpts;
+static struct EntryListIndex optionsIndex;
 cc_result Options_LoadResult;
 static cc_bool savingPaused;
 #if defined CC_BUILD_WEB || defined CC_BUILD_MOBILE || defined CC_BUILD_CONSOLE
@@ -17,6 +18,7 @@ static cc_bool savingPaused;
 #endif
 
 void Options_Free(void) {
+	EntryList_RemoveIndex(&optionsIndex);
 	StringsBuffer_Clear(&Options);
 	StringsBuffer_Clear(&changedOpts);
 }
@@ -41,6 +43,8 @@ static cc_bool Options_LoadFilter(const cc_string* entry) {
 void Options_Load(void) {
 	/* Increase from max 512 to 2048 per entry */
 	StringsBuffer_SetLengthBits(&Options, 11);
+	/* Options are looked up by key very often, so avoid scanning every entry each time */
+	if (!optionsIndex.list) EntryList_AddIndex(&optionsIndex, &Options, '=');
 	Options_LoadResult = EntryList_Load(&Options, "options-default.txt", '=', NULL);
 	Options_LoadResult = EntryList_Load(&Options, "options.txt",         '=', NULL);
 }
@@ -49,6 +53,9 @@ void Options_Reload(void) {
 	cc_string entry, key, value;
 	int i;
 
+	/* Cheaper to rebuild the index once afterwards than to update it per removed entry */
+	EntryList_RemoveIndex(&optionsIndex);
+
 	/* Reset all the unchanged options */
 	for (i = Options.count - 1; i >= 0; i--) {
 		entry = StringsBuffer_UNSAFE_Get(&Options, i);
@@ -57,6 +64,8 @@ void Options_Reload(void) {
 		if (HasChanged(&key)) continue;
 		StringsBuffer_Remove(&Options, i);
 	}
+	EntryList_AddIndex(&optionsIndex, &Options, '=');
+
 	/* Load only options which have not changed */
 	Options_LoadResult = EntryList_Load(&Options, "options.txt", '=', Options_LoadFilter);
 }
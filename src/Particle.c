@@ -9,11 +9,18 @@
 #include "Funcs.h"
 #include "Game.h"
 #include "Event.h"
+#include "Options.h"
+#include "Platform.h"
 
 #ifdef CC_BUILD_TINYMEM
+	#define PARTICLES_MIN 10
+	#define PARTICLES_DEF 10
 	#define PARTICLES_MAX 10
 #else
-	#define PARTICLES_MAX 600
+	#define PARTICLES_MIN 100
+	#define PARTICLES_DEF 600
+	/* Each particle type is drawn using one draw call, which can use at most GFX_MAX_VERTICES */
+	#define PARTICLES_MAX (GFX_MAX_VERTICES / 4)
 #endif
 
 
@@ -24,6 +31,21 @@ static GfxResourceID particles_TexId, particles_VB;
 static RNGState rnd;
 static cc_bool hitTerrain;
 typedef cc_bool (*CanPassThroughFunc)(BlockID b);
+/* Maximum number of particles of each type */
+static int particles_max;
+struct _ParticlesStats Particles_Stats;
+
+/* Removes the oldest particles from the given array (oldest particles are first), */
+/*  so that there is room to add at least 'needed' new particles. Returns new count. */
+/* NOTE: 'needed' must not be greater than particles_max */
+static int Particles_MakeRoom(void* particles, int count, int needed, cc_uint32 elemSize) {
+	int drop = count + needed - particles_max;
+	if (drop <= 0) return count;
+	if (drop >= count) return 0;
+
+	Mem_Move(particles, (cc_uint8*)particles + drop * elemSize, (count - drop) * elemSize);
+	return count - drop;
+}
 
 void Particle_DoRender(const Vec2* size, const Vec3* pos, const TextureRec* rec, PackedCol col, struct VertexTextured* v) {
 	struct Matrix* view;
@@ -131,7 +153,7 @@ static cc_bool PhysicsTick(struct Particle* p, float gravity, CanPassThroughFunc
 /*########################################################################################################################*
 *-------------------------------------------------------Rain particle-----------------------------------------------------*
 *#########################################################################################################################*/
-static struct Particle rain_Particles[PARTICLES_MAX];
+static struct Particle* rain_Particles;
 static int rain_count;
 static TextureRec rain_rec = { 2.0f/128.0f, 14.0f/128.0f, 5.0f/128.0f, 16.0f/128.0f };
 
@@ -176,28 +198,25 @@ static void Rain_Render(float t) {
 	Gfx_DrawVb_IndexedTris(rain_count * 4);
 }
 
-static void Rain_RemoveAt(int i) {
-	for (; i < rain_count - 1; i++) {
-		rain_Particles[i] = rain_Particles[i + 1];
-	}
-	rain_count--;
-}
-
 static void Rain_Tick(float delta) {
-	int i;
+	int i, j = 0;
+	/* Compacts surviving particles in one pass, preserving oldest first order */
 	for (i = 0; i < rain_count; i++) {
-		if (RainParticle_Tick(&rain_Particles[i], delta)) {
-			Rain_RemoveAt(i); i--;
-		}
+		if (RainParticle_Tick(&rain_Particles[i], delta)) continue;
+
+		if (i != j) rain_Particles[j] = rain_Particles[i];
+		j++;
 	}
+	rain_count = j;
 }
 
 void Particles_RainSnowEffect(float x, float y, float z) {
 	struct Particle* p;
 	int i, type;
 
+	rain_count = Particles_MakeRoom(rain_Particles, rain_count, 2, sizeof(struct Particle));
+
 	for (i = 0; i < 2; i++) {
-		if (rain_count == PARTICLES_MAX) Rain_RemoveAt(0);
 		p = &rain_Particles[rain_count++];
 
 		p->velocity.x = Random_Float(&rnd) * 0.8f - 0.4f; /* [-0.4, 0.4] */
@@ -227,10 +246,11 @@ struct TerrainParticle {
 	BlockID block;
 };
 
-static struct TerrainParticle terrain_particles[PARTICLES_MAX];
+static struct TerrainParticle* terrain_particles;
+#define GRID_SIZE 4
 static int terrain_count;
-static cc_uint16 terrain_1DCount[ATLAS1D_MAX_ATLASES];
-static cc_uint16 terrain_1DIndices[ATLAS1D_MAX_ATLASES];
+static int terrain_1DCount[ATLAS1D_MAX_ATLASES];
+static int terrain_1DIndices[ATLAS1D_MAX_ATLASES];
 
 static cc_bool TerrainParticle_CanPass(BlockID block) {
 	cc_uint8 draw = Blocks.Draw[block];
@@ -306,22 +326,16 @@ static void Terrain_Render(float t) {
 	}
 }
 
-static void Terrain_RemoveAt(int i) {
-	for (; i < terrain_count - 1; i++) 
-	{
-		terrain_particles[i] = terrain_particles[i + 1];
-	}
-	terrain_count--;
-}
-
 static void Terrain_Tick(float delta) {
-	int i;
+	int i, j = 0;
 	for (i = 0; i < terrain_count; i++) 
 	{
-		if (TerrainParticle_Tick(&terrain_particles[i], delta)) {
-			Terrain_RemoveAt(i); i--;
-		}
+		if (TerrainParticle_Tick(&terrain_particles[i], delta)) continue;
+
+		if (i != j) terrain_particles[j] = terrain_particles[i];
+		j++;
 	}
+	terrain_count = j;
 }
 
 void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
@@ -339,8 +353,8 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 	
 	/* per-particle variables */
 	float cellX, cellY, cellZ;
-	Vec3 cell;
-	int x, y, z, type;
+	Vec3 cell, cells[GRID_SIZE * GRID_SIZE * GRID_SIZE];
+	int x, y, z, i, type, cellsCount = 0;
 
 	if (now != BLOCK_AIR || Blocks.Draw[old] == DRAW_GAS) return;
 	IVec3_ToVec3(&origin, &coords);
@@ -360,7 +374,6 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 	if (minU < 12 && maxU > 12) maxUsedU = 12;
 	if (minV < 12 && maxV > 12) maxUsedV = 12;
 
-	#define GRID_SIZE 4
 	/* gridOffset gives the centre of the cell on a grid */
 	#define CELL_CENTRE ((1.0f / GRID_SIZE) * 0.5f)
 
@@ -375,34 +388,43 @@ void Particles_BreakBlockEffect(IVec3 coords, BlockID old, BlockID now) {
 				if (cell.x < minBB.x || cell.x > maxBB.x || cell.y < minBB.y
 					|| cell.y > maxBB.y || cell.z < minBB.z || cell.z > maxBB.z) continue;
 
-				if (terrain_count == PARTICLES_MAX) Terrain_RemoveAt(0);
-				p = &terrain_particles[terrain_count++];
-
-				/* centre random offset around [-0.2, 0.2] */
-				p->base.velocity.x = CELL_CENTRE + (cellX - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
-				p->base.velocity.y = CELL_CENTRE + (cellY - 0.0f) + (Random_Float(&rnd) * 0.4f - 0.2f);
-				p->base.velocity.z = CELL_CENTRE + (cellZ - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
-
-				rec = baseRec;
-				rec.u1 = baseRec.u1 + Random_Range(&rnd, minU, maxUsedU) * uScale;
-				rec.v1 = baseRec.v1 + Random_Range(&rnd, minV, maxUsedV) * vScale;
-				rec.u2 = rec.u1 + 4 * uScale;
-				rec.v2 = rec.v1 + 4 * vScale;
-				rec.u2 = min(rec.u2, maxU2) - 0.01f * uScale;
-				rec.v2 = min(rec.v2, maxV2) - 0.01f * vScale;
-		
-				Vec3_Add(&p->base.lastPos, &origin, &cell);
-				p->base.nextPos  = p->base.lastPos;
-				p->base.lifetime = 0.3f + Random_Float(&rnd) * 1.2f;
-
-				p->rec    = rec;
-				p->texLoc = loc;
-				p->block  = old;
-				type = Random_Next(&rnd, 30);
-				p->base.size = type >= 28 ? 12 : (type >= 25 ? 10 : 8);
+				cells[cellsCount++] = cell;
 			}
 		}
 	}
+
+	/* If there are more cells than the particles limit, only the last cells can be kept anyways */
+	i = max(0, cellsCount - particles_max);
+	terrain_count = Particles_MakeRoom(terrain_particles, terrain_count, 
+									cellsCount - i, sizeof(struct TerrainParticle));
+	for (; i < cellsCount; i++) 
+	{
+		cell = cells[i];
+		p    = &terrain_particles[terrain_count++];
+
+		/* centre random offset around [-0.2, 0.2] */
+		p->base.velocity.x = (cell.x - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
+		p->base.velocity.y = (cell.y - CELL_CENTRE / 2 + CELL_CENTRE) + (Random_Float(&rnd) * 0.4f - 0.2f);
+		p->base.velocity.z = (cell.z - 0.5f) + (Random_Float(&rnd) * 0.4f - 0.2f);
+
+		rec = baseRec;
+		rec.u1 = baseRec.u1 + Random_Range(&rnd, minU, maxUsedU) * uScale;
+		rec.v1 = baseRec.v1 + Random_Range(&rnd, minV, maxUsedV) * vScale;
+		rec.u2 = rec.u1 + 4 * uScale;
+		rec.v2 = rec.v1 + 4 * vScale;
+		rec.u2 = min(rec.u2, maxU2) - 0.01f * uScale;
+		rec.v2 = min(rec.v2, maxV2) - 0.01f * vScale;
+
+		Vec3_Add(&p->base.lastPos, &origin, &cell);
+		p->base.nextPos  = p->base.lastPos;
+		p->base.lifetime = 0.3f + Random_Float(&rnd) * 1.2f;
+
+		p->rec    = rec;
+		p->texLoc = loc;
+		p->block  = old;
+		type = Random_Next(&rnd, 30);
+		p->base.size = type >= 28 ? 12 : (type >= 25 ? 10 : 8);
+	}
 }
 
 
@@ -417,7 +439,7 @@ struct CustomParticle {
 };
 
 struct CustomParticleEffect Particles_CustomEffects[256];
-static struct CustomParticle custom_particles[PARTICLES_MAX];
+static struct CustomParticle* custom_particles;
 static int custom_count;
 static cc_uint8 collideFlags;
 #define EXPIRES_UPON_TOUCHING_GROUND (1 << 0)
@@ -488,34 +510,30 @@ static void Custom_Render(float t) {
 	Gfx_DrawVb_IndexedTris(custom_count * 4);
 }
 
-static void Custom_RemoveAt(int i) {
-	for (; i < custom_count - 1; i++) {
-		custom_particles[i] = custom_particles[i + 1];
-	}
-	custom_count--;
-}
-
 static void Custom_Tick(float delta) {
-	int i;
+	int i, j = 0;
 	for (i = 0; i < custom_count; i++) {
-		if (CustomParticle_Tick(&custom_particles[i], delta)) {
-			Custom_RemoveAt(i); i--;
-		}
+		if (CustomParticle_Tick(&custom_particles[i], delta)) continue;
+
+		if (i != j) custom_particles[j] = custom_particles[i];
+		j++;
 	}
+	custom_count = j;
 }
 
 void Particles_CustomEffect(int effectID, float x, float y, float z, float originX, float originY, float originZ) {
 	struct CustomParticle* p;
 	struct CustomParticleEffect* e = &Particles_CustomEffects[effectID];
-	int i, count = e->particleCount;
+	int i, count = min(e->particleCount, particles_max);
 	Vec3 offset, delta, origin;
 	float d;
 
 	origin.x = originX; origin.y = originY; origin.z = originZ;
+	custom_count = Particles_MakeRoom(custom_particles, custom_count, 
+									count, sizeof(struct CustomParticle));
 
 	for (i = 0; i < count; i++) 
 	{
-		if (custom_count == PARTICLES_MAX) Custom_RemoveAt(0);
 		p = &custom_particles[custom_count++];
 		p->effectId = effectID;
 
@@ -565,12 +583,14 @@ static void Custom_Tick(float delta) { }
 *--------------------------------------------------------Particles--------------------------------------------------------*
 *#########################################################################################################################*/
 void Particles_Render(float t) {
+	cc_uint64 beg;
 	if (!terrain_count && !rain_count && !custom_count) return;
 
 	if (Gfx.LostContext) return;
 	if (!particles_VB)
-		particles_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, PARTICLES_MAX * 4);
+		particles_VB = Gfx_CreateDynamicVb(VERTEX_FORMAT_TEXTURED, particles_max * 4);
 
+	beg = Stopwatch_Measure();
 	Gfx_SetAlphaTest(true);
 
 	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
@@ -579,15 +599,24 @@ void Particles_Render(float t) {
 	Custom_Render(t);
 
 	Gfx_SetAlphaTest(false);
+	Particles_Stats.Drawn         = terrain_count + rain_count + custom_count;
+	Particles_Stats.DrawMicrosecs = (int)Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
 }
 
 static void Particles_Tick(struct ScheduledTask* task) {
 	float delta = task->interval;
+	cc_uint64 beg = Stopwatch_Measure();
+	Particles_Stats.Simulated = terrain_count + rain_count + custom_count;
+
 	Terrain_Tick(delta);
 	Rain_Tick(delta);
 	Custom_Tick(delta);
+	Particles_Stats.TickMicrosecs = (int)Stopwatch_ElapsedMicroseconds(beg, Stopwatch_Measure());
 }
 
+int Particles_Count(void) { return terrain_count + rain_count + custom_count; }
+int Particles_MaxCount(void) { return particles_max; }
+
 
 /*########################################################################################################################*
 *---------------------------------------------------Particles component---------------------------------------------------*
@@ -610,6 +639,13 @@ static void OnBreakBlockEffect_Handler(void* obj, IVec3 coords, BlockID old, Blo
 }
 
 static void OnInit(void) {
+	particles_max = Options_GetInt(OPT_MAX_PARTICLES, PARTICLES_MIN, PARTICLES_MAX, PARTICLES_DEF);
+	rain_Particles    = (struct Particle*)Mem_Alloc(particles_max, sizeof(struct Particle), "rain particles");
+	terrain_particles = (struct TerrainParticle*)Mem_Alloc(particles_max, sizeof(struct TerrainParticle), "terrain particles");
+#ifdef CC_BUILD_NETWORKING
+	custom_particles  = (struct CustomParticle*)Mem_Alloc(particles_max, sizeof(struct CustomParticle), "custom particles");
+#endif
+
 	ScheduledTask_Add(GAME_DEF_TICKS, Particles_Tick);
 	Random_SeedFromCurrentTime(&rnd);
 	TextureEntry_Register(&particles_entry);
@@ -618,7 +654,17 @@ static void OnInit(void) {
 	Event_Register_(&GfxEvents.ContextLost,   NULL, OnContextLost);
 }
 
-static void OnFree(void) { OnContextLost(NULL); }
+static void OnFree(void) { 
+	OnContextLost(NULL); 
+	Mem_Free(rain_Particles);
+	Mem_Free(terrain_particles);
+	rain_Particles    = NULL;
+	terrain_particles = NULL;
+#ifdef CC_BUILD_NETWORKING
+	Mem_Free(custom_particles);
+	custom_particles  = NULL;
+#endif
+}
 
 static void OnReset(void) { rain_count = 0; terrain_count = 0; custom_count = 0; }
 
@@ -39,12 +39,22 @@ struct CustomParticleEffect {
 
 extern struct CustomParticleEffect Particles_CustomEffects[256];
 
+/* Statistics about the most recent particles tick and render */
+extern struct _ParticlesStats {
+	int Simulated, TickMicrosecs; /* Particles simulated in last tick, and time taken */
+	int Drawn, DrawMicrosecs;     /* Particles drawn in last frame, and time taken */
+} Particles_Stats;
+
 /* http://www.opengl-tutorial.org/intermediate-tutorials/billboards-particles/billboards/ */
 void Particle_DoRender(const Vec2* size, const Vec3* pos, const TextureRec* rec, PackedCol col, struct VertexTextured* vertices);
 void Particles_Render(float t);
 void Particles_BreakBlockEffect(IVec3 coords, BlockID oldBlock, BlockID block);
 void Particles_RainSnowEffect(float x, float y, float z);
 void Particles_CustomEffect(int effectID, float x, float y, float z, float originX, float originY, float originZ);
+/* Returns the number of currently active particles (of all types) */
+int Particles_Count(void);
+/* Returns the maximum number of active particles of each type */
+int Particles_MaxCount(void);
 
 CC_END_HEADER
 #endif
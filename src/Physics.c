@@ -7,6 +7,7 @@
 #include "Funcs.h"
 #include "Logger.h"
 #include "Entity.h"
+#include "Event.h"
 
 
 /*########################################################################################################################*
@@ -131,6 +132,12 @@ static struct SearcherState searcherDefaultStates[SEARCHER_STATES_MIN];
 static cc_uint32 searcherCapacity = SEARCHER_STATES_MIN;
 struct SearcherState* Searcher_States = searcherDefaultStates;
 
+static void Searcher_FreeStates(void) {
+	if (Searcher_States != searcherDefaultStates) Mem_Free(Searcher_States);
+	Searcher_States  = searcherDefaultStates;
+	searcherCapacity = SEARCHER_STATES_MIN;
+}
+
 static void Searcher_QuickSort(int left, int right) {
 	struct SearcherState* keys = Searcher_States; struct SearcherState key;
 
@@ -149,12 +156,119 @@ static void Searcher_QuickSort(int left, int right) {
 	}
 }
 
+/* Solid blocks in a box around each entity are cached between ticks, */
+/*  until either the entity moves outside that box or a block inside it changes */
+/* NOTE: Blocks are stored in the same Y/Z/X order the box was searched in, */
+/*  so filtering them down to the search box gives the same candidate order */
+#define SEARCHER_CACHE_PADDING 2
+#define SEARCHER_MAX_CACHES MAX_LOCAL_PLAYERS
+struct SearcherBlock { int x; BlockID block; };
+struct SearcherCache {
+	struct Entity* entity;
+	int epoch;
+	IVec3 min, max;
+	/* Index of the first block in each Y/Z row of the box, followed by total number of blocks */
+	int* rows;
+	struct SearcherBlock* blocks;
+	int rowsCapacity, blocksCapacity;
+};
+static struct SearcherCache searcher_caches[SEARCHER_MAX_CACHES];
+static int searcher_nextCache;
+/* Incremented to invalidate all cached boxes (e.g. when block properties change) */
+static int searcher_epoch = 1;
+
+static void Searcher_GrowBlocks(struct SearcherCache* cache) {
+	if (!cache->blocks) {
+		cache->blocksCapacity = SEARCHER_STATES_MIN;
+		cache->blocks = (struct SearcherBlock*)Mem_Alloc(cache->blocksCapacity, 
+											sizeof(struct SearcherBlock), "collision search blocks");
+	} else {
+		cache->blocksCapacity *= 2;
+		cache->blocks = (struct SearcherBlock*)Mem_Realloc(cache->blocks, cache->blocksCapacity, 
+											sizeof(struct SearcherBlock), "collision search blocks");
+	}
+}
+
+static void Searcher_FillCache(struct SearcherCache* cache) {
+	IVec3 min = cache->min, max = cache->max;
+	cc_bool skipEmpty, rowInside;
+	int rows, row = 0, count = 0, rowIndex;
+	BlockID block;
+	int x, y, z;
+
+	rows = (max.y - min.y + 1) * (max.z - min.z + 1) + 1;
+	if (rows > cache->rowsCapacity) {
+		Mem_Free(cache->rows);
+		cache->rowsCapacity = rows;
+		cache->rows = (int*)Mem_Alloc(rows, sizeof(int), "collision search rows");
+	}
+
+	/* Air is normally not solid, so empty regions of the world can be skipped over */
+	skipEmpty = Blocks.Collide[BLOCK_AIR] != COLLIDE_SOLID;
+
+	/* Order loops so that we minimise cache misses */
+	for (y = min.y; y <= max.y; y++) {
+		for (z = min.z; z <= max.z; z++) {
+			cache->rows[row++] = count;
+			/* Rows entirely inside the map can skip bounds checks and index the blocks array directly */
+			rowInside = World_Contains(min.x, y, z) && max.x < World.Width;
+			rowIndex  = rowInside ? World_Pack(0, y, z) : 0;
+
+			for (x = min.x; x <= max.x; x++) {
+				if (skipEmpty && (rowInside || World_Contains(x, y, z))) {
+					if (World_IsEmptyChunk(x, y, z)) { x |= CHUNK_MAX; continue; }
+					if (World_IsEmptyBrick(x, y, z)) { x |= OCCUPANCY_BRICK_MAX; continue; }
+				}
+				block = rowInside ? (BlockID)World_GetRawBlock(rowIndex + x) : World_GetPhysicsBlock(x, y, z);
+				if (Blocks.Collide[block] != COLLIDE_SOLID) continue;
+
+				if (count == cache->blocksCapacity) Searcher_GrowBlocks(cache);
+				cache->blocks[count].x     = x;
+				cache->blocks[count].block = block;
+				count++;
+			}
+		}
+	}
+	cache->rows[row] = count;
+}
+
+/* Returns the cached solid blocks for the given entity, which contains at least the given box */
+static struct SearcherCache* Searcher_GetCache(struct Entity* entity, const IVec3* min, const IVec3* max) {
+	struct SearcherCache* cache = NULL;
+	int i;
+
+	for (i = 0; i < SEARCHER_MAX_CACHES; i++) 
+	{
+		if (searcher_caches[i].entity == entity) { cache = &searcher_caches[i]; break; }
+	}
+	if (!cache) {
+		cache = &searcher_caches[searcher_nextCache];
+		searcher_nextCache = (searcher_nextCache + 1) % SEARCHER_MAX_CACHES;
+		cache->entity = entity;
+		cache->epoch  = 0;
+	}
+
+	if (cache->epoch != searcher_epoch ||
+		min->x < cache->min.x || min->y < cache->min.y || min->z < cache->min.z ||
+		max->x > cache->max.x || max->y > cache->max.y || max->z > cache->max.z) {
+		cache->epoch = searcher_epoch;
+		cache->min.x = min->x - SEARCHER_CACHE_PADDING; cache->max.x = max->x + SEARCHER_CACHE_PADDING;
+		cache->min.y = min->y - SEARCHER_CACHE_PADDING; cache->max.y = max->y + SEARCHER_CACHE_PADDING;
+		cache->min.z = min->z - SEARCHER_CACHE_PADDING; cache->max.z = max->z + SEARCHER_CACHE_PADDING;
+		Searcher_FillCache(cache);
+	}
+	return cache;
+}
+
 int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, struct AABB* entityExtentBB) {
 	Vec3 vel = entity->Velocity;
 	IVec3 min, max;
 	cc_uint32 elements;
 	struct SearcherState* curState;
-	int count;
+	struct SearcherCache* cache;
+	struct SearcherBlock* cur;
+	struct SearcherBlock* end;
+	int count, row, rowStride;
 
 	BlockID block;
 	struct AABB blockBB;
@@ -176,18 +290,27 @@ int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, s
 	elements = (max.x - min.x + 1) * (max.y - min.y + 1) * (max.z - min.z + 1);
 
 	if (elements > searcherCapacity) {
-		Searcher_Free();
+		/* Grow geometrically, to avoid reallocating every tick while the entity is accelerating */
+		elements = max(elements, searcherCapacity * 2);
+		Searcher_FreeStates();
 		searcherCapacity = elements;
 		Searcher_States  = (struct SearcherState*)Mem_Alloc(elements, sizeof(struct SearcherState), "collision search states");
 	}
-	curState = Searcher_States;
+	curState  = Searcher_States;
+	cache     = Searcher_GetCache(entity, &min, &max);
+	rowStride = cache->max.z - cache->min.z + 1;
 
-	/* Order loops so that we minimise cache misses */
 	for (y = min.y; y <= max.y; y++) {
 		for (z = min.z; z <= max.z; z++) {
-			for (x = min.x; x <= max.x; x++) {
-				block = World_GetPhysicsBlock(x, y, z);
-				if (Blocks.Collide[block] != COLLIDE_SOLID) continue;
+			row = (y - cache->min.y) * rowStride + (z - cache->min.z);
+			cur = &cache->blocks[cache->rows[row]];
+			end = &cache->blocks[cache->rows[row + 1]];
+
+			for (; cur < end; cur++) {
+				x = cur->x;
+				if (x < min.x) continue;
+				if (x > max.x) break;
+				block = cur->block;
 
 				xx = (float)x; yy = (float)y; zz = (float)z;
 				blockBB.Min = Blocks.MinBB[block];
@@ -213,6 +336,29 @@ int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, s
 	return count;
 }
 
+void Searcher_OnBlocksChanged(const IVec3* min, const IVec3* max) {
+	struct SearcherCache* cache;
+	int i;
+
+	for (i = 0; i < SEARCHER_MAX_CACHES; i++) 
+	{
+		cache = &searcher_caches[i];
+		if (cache->epoch != searcher_epoch) continue; /* Already invalid */
+
+		if (max->x < cache->min.x || min->x > cache->max.x || max->y < cache->min.y
+			|| min->y > cache->max.y || max->z < cache->min.z || min->z > cache->max.z) continue;
+		cache->epoch = 0;
+	}
+}
+
+static void Searcher_Invalidate(void* obj) { searcher_epoch++; }
+
+void Searcher_Init(void) {
+	Event_Register_(&BlockEvents.BlockDefChanged, NULL, Searcher_Invalidate);
+	Event_Register_(&WorldEvents.NewMap,          NULL, Searcher_Invalidate);
+	Event_Register_(&WorldEvents.MapLoaded,       NULL, Searcher_Invalidate);
+}
+
 void Searcher_CalcTime(Vec3* vel, struct AABB *entityBB, struct AABB* blockBB, float* tx, float* ty, float* tz) {
 	float dx = vel->x > 0.0f ? blockBB->Min.x - entityBB->Max.x : entityBB->Min.x - blockBB->Max.x;
 	float dy = vel->y > 0.0f ? blockBB->Min.y - entityBB->Max.y : entityBB->Min.y - blockBB->Max.y;
@@ -238,7 +384,15 @@ void Searcher_CalcTime(Vec3* vel, struct AABB *entityBB, struct AABB* blockBB, f
 }
 
 void Searcher_Free(void) {
-	if (Searcher_States != searcherDefaultStates) Mem_Free(Searcher_States);
-	Searcher_States  = searcherDefaultStates;
-	searcherCapacity = SEARCHER_STATES_MIN;
+	struct SearcherCache* cache;
+	int i;
+	Searcher_FreeStates();
+
+	for (i = 0; i < SEARCHER_MAX_CACHES; i++) 
+	{
+		cache = &searcher_caches[i];
+		Mem_Free(cache->rows);
+		Mem_Free(cache->blocks);
+		Mem_Set(cache, 0, sizeof(struct SearcherCache));
+	}
 }
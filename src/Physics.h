@@ -39,6 +39,9 @@ struct SearcherState { int x, y, z; float tSquared; };
 extern struct SearcherState* Searcher_States;
 int Searcher_FindReachableBlocks(struct Entity* entity, struct AABB* entityBB, struct AABB* entityExtentBB);
 void Searcher_CalcTime(Vec3* vel, struct AABB *entityBB, struct AABB* blockBB, float* tx, float* ty, float* tz);
+/* Invalidates cached solid blocks around entities that overlap the given region */
+void Searcher_OnBlocksChanged(const IVec3* min, const IVec3* max);
+void Searcher_Init(void);
 void Searcher_Free(void);
 
 CC_END_HEADER
@@ -151,16 +151,100 @@ static BlockID Picking_GetOutside(int x, int y, int z, IVec3 origin) {
 	return BLOCK_AIR;
 }
 
-static cc_bool RayTrace(struct RayTracer* t, const Vec3* origin, const Vec3* dir, float reach, IntersectTest intersect) {
-	IVec3 pOrigin;
-	cc_bool insideMap;
-	float reachSq;
-	Vec3 v;
-
+/* Calculates the bounds of the given block in the given cell, then returns whether they are beyond reach */
+static cc_bool Picking_CalcBounds(struct RayTracer* t, int x, int y, int z, BlockID block, float reachSq) {
 	float dxMin, dxMax, dx;
 	float dyMin, dyMax, dy;
 	float dzMin, dzMax, dz;
-	int i, x, y, z;
+	Vec3 v;
+
+	v.x = (float)x; v.y = (float)y; v.z = (float)z;
+	Vec3_Add(&t->Min, &v, &Blocks.RenderMinBB[block]);
+	Vec3_Add(&t->Max, &v, &Blocks.RenderMaxBB[block]);
+
+	dxMin = Math_AbsF(t->origin.x - t->Min.x); dxMax = Math_AbsF(t->origin.x - t->Max.x);
+	dyMin = Math_AbsF(t->origin.y - t->Min.y); dyMax = Math_AbsF(t->origin.y - t->Max.y);
+	dzMin = Math_AbsF(t->origin.z - t->Min.z); dzMax = Math_AbsF(t->origin.z - t->Max.z);
+	dx = min(dxMin, dxMax); dy = min(dyMin, dyMax); dz = min(dzMin, dzMax);
+	return dx * dx + dy * dy + dz * dz > reachSq;
+}
+
+/* Returns mask of the empty region of the world the given cell lies in, or -1 if not in an empty region */
+static int Picking_EmptyRegionMask(int x, int y, int z) {
+	if (!World_Contains(x, y, z))    return -1;
+	if (World_IsEmptyChunk(x, y, z)) return CHUNK_MAX;
+	if (World_IsEmptyBrick(x, y, z)) return OCCUPANCY_BRICK_MAX;
+	return -1;
+}
+
+/* Calculates how far along the ray it leaves the given region on an axis */
+/* NOTE: cells is set to the number of cell boundaries inside the region the ray crosses before that */
+static float Picking_RegionExit(int pos, int step, int mask, float tMax, float tDelta, int* cells) {
+	*cells = step > 0 ? (pos | mask) - pos : (pos & mask);
+	/* Ray never crosses a cell boundary on this axis */
+	if (!step || tDelta <= 0.0f) return MATH_LARGENUM;
+	return tMax + *cells * tDelta;
+}
+
+/* Returns how many cell boundaries on an axis the ray crosses before reaching tExit */
+/* NOTE: RayTracer_Step crosses a boundary at exactly tExit first if the axis comes after the exit axis */
+static int Picking_CellsBefore(float tMax, float tDelta, float tExit, int cells, cc_bool inclusive) {
+	int count;
+	if (tDelta <= 0.0f) return 0;
+
+	if (inclusive) {
+		if (tMax > tExit) return 0;
+		count = Math_Floor((tExit - tMax) / tDelta) + 1;
+	} else {
+		if (tMax >= tExit) return 0;
+		count = Math_Ceil((tExit - tMax) / tDelta);
+	}
+	return min(cells, count);
+}
+
+/* Moves the ray directly to the first cell outside the given empty region, */
+/*  returning the number of cells stepped over */
+/* NOTE: last is set to the last cell that was inside the region */
+static int Picking_SkipRegion(struct RayTracer* t, int mask, IVec3* last) {
+	IVec3 cells, moved;
+	float exitX, exitY, exitZ, tExit;
+	int axis;
+
+	exitX = Picking_RegionExit(t->pos.x, t->step.x, mask, t->tMax.x, t->tDelta.x, &cells.x);
+	exitY = Picking_RegionExit(t->pos.y, t->step.y, mask, t->tMax.y, t->tDelta.y, &cells.y);
+	exitZ = Picking_RegionExit(t->pos.z, t->step.z, mask, t->tMax.z, t->tDelta.z, &cells.z);
+
+	/* Same axis order as RayTracer_Step when boundaries are equally near */
+	if (exitX < exitY && exitX < exitZ) {
+		tExit = exitX; axis = 0;
+	} else if (exitY < exitZ) {
+		tExit = exitY; axis = 1;
+	} else {
+		tExit = exitZ; axis = 2;
+	}
+
+	moved.x = axis == 0 ? cells.x : Picking_CellsBefore(t->tMax.x, t->tDelta.x, tExit, cells.x, false);
+	moved.y = axis == 1 ? cells.y : Picking_CellsBefore(t->tMax.y, t->tDelta.y, tExit, cells.y, axis < 1);
+	moved.z = axis == 2 ? cells.z : Picking_CellsBefore(t->tMax.z, t->tDelta.z, tExit, cells.z, true);
+
+	last->x = t->pos.x + moved.x * t->step.x;
+	last->y = t->pos.y + moved.y * t->step.y;
+	last->z = t->pos.z + moved.z * t->step.z;
+	t->pos  = *last;
+	t->tMax.x += moved.x * t->tDelta.x;
+	t->tMax.y += moved.y * t->tDelta.y;
+	t->tMax.z += moved.z * t->tDelta.z;
+
+	/* Cross the boundary of the region */
+	RayTracer_Step(t);
+	return moved.x + moved.y + moved.z + 1;
+}
+
+static cc_bool RayTrace(struct RayTracer* t, const Vec3* origin, const Vec3* dir, float reach, IntersectTest intersect) {
+	IVec3 pOrigin, last;
+	cc_bool insideMap, skipEmpty;
+	float reachSq;
+	int i, x, y, z, mask;
 
 	RayTracer_Init(t, origin, dir);
 	/* Check if origin is at NaN (happens if player's position is at infinity) */
@@ -173,20 +257,22 @@ static cc_bool RayTrace(struct RayTracer* t, const Vec3* origin, const Vec3* dir
 	/*  pick blocks on the INSIDE of the map borders instead of OUTSIDE them */
 	insideMap = World_ContainsXZ(pOrigin.x, pOrigin.z) && pOrigin.y >= 0;
 	reachSq   = reach * reach;
+	/* Both ClipBlock and ClipCamera ignore gas blocks, so empty regions can never be hit */
+	skipEmpty = insideMap && Blocks.Draw[BLOCK_AIR] == DRAW_GAS && (t->step.x | t->step.y | t->step.z);
 		
 	for (i = 0; i < 25000; i++) {
-		x   = t->pos.x; y   = t->pos.y; z   = t->pos.z;
-		v.x = (float)x; v.y = (float)y; v.z = (float)z;
+		x = t->pos.x; y = t->pos.y; z = t->pos.z;
+
+		if (skipEmpty && (mask = Picking_EmptyRegionMask(x, y, z)) >= 0) {
+			i += Picking_SkipRegion(t, mask, &last) - 1;
+			/* Distance to cells only increases as the ray steps further away from the origin, */
+			/*  so if any skipped cell was out of reach, the last skipped cell is too */
+			if (Picking_CalcBounds(t, last.x, last.y, last.z, BLOCK_AIR, reachSq)) return false;
+			continue;
+		}
 
 		t->block = insideMap ? Picking_GetInside(x, y, z) : Picking_GetOutside(x, y, z, pOrigin);
-		Vec3_Add(&t->Min, &v, &Blocks.RenderMinBB[t->block]);
-		Vec3_Add(&t->Max, &v, &Blocks.RenderMaxBB[t->block]);
-
-		dxMin = Math_AbsF(origin->x - t->Min.x); dxMax = Math_AbsF(origin->x - t->Max.x);
-		dyMin = Math_AbsF(origin->y - t->Min.y); dyMax = Math_AbsF(origin->y - t->Max.y);
-		dzMin = Math_AbsF(origin->z - t->Min.z); dzMax = Math_AbsF(origin->z - t->Max.z);
-		dx = min(dxMin, dxMax); dy = min(dyMin, dyMax); dz = min(dzMin, dzMax);
-		if (dx * dx + dy * dy + dz * dz > reachSq) return false;
+		if (Picking_CalcBounds(t, x, y, z, t->block, reachSq)) return false;
 
 		if (intersect(t)) return true;
 		RayTracer_Step(t);
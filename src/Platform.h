@@ -279,6 +279,12 @@ cc_result File_Seek(cc_file file, int offset, int seekType);
 cc_result File_Position(cc_file file, cc_uint32* pos);
 /* Attempts to retrieve the length of the given file. */
 cc_result File_Length(cc_file file, cc_uint32* len);
+#if defined CC_BUILD_WIN || defined CC_BUILD_POSIX
+#define CC_BUILD_FILE_RENAME
+/* Attempts to rename src to dst, replacing dst if it already exists. */
+/* NOTE: Where supported by the OS, dst is replaced atomically. */
+cc_result File_Rename(const cc_filepath* src, const cc_filepath* dst);
+#endif
 
 
 /*########################################################################################################################*
@@ -392,6 +392,18 @@ cc_result File_Close(cc_file file) {
 	return CloseHandle(file) ? 0 : GetLastError();
 }
 
+cc_result File_Rename(const cc_filepath* src, const cc_filepath* dst) {
+	cc_result res;
+	if (MoveFileExW(src->uni, dst->uni, MOVEFILE_REPLACE_EXISTING)) return 0;
+	
+	res = GetLastError();
+	if (res != ERROR_CALL_NOT_IMPLEMENTED) return res;
+
+	/* MoveFileEx isn't supported on Windows 9x, so replacing can't be atomic */
+	DeleteFileA(dst->ansi);
+	return MoveFileA(src->ansi, dst->ansi) ? 0 : GetLastError();
+}
+
 cc_result File_Seek(cc_file file, int offset, int seekType) {
 	static cc_uint8 modes[] = { FILE_BEGIN, FILE_CURRENT, FILE_END };
 	DWORD pos = SetFilePointer(file, offset, NULL, modes[seekType]);
@@ -212,6 +212,7 @@ static void AddEntity(cc_uint8* data, EntityID id, const cc_string* name, const
 		NetPlayer_Init((struct NetPlayer*)e);
 		Entities.List[id] = e;
 		Event_RaiseInt(&EntityEvents.Added, id);
+		Event_RaiseIntBatch(&EntityEvents.AddedBatch, id);
 	} else {
 		e = &Entities.CurPlayer->Base;
 	}
@@ -1257,9 +1258,7 @@ static void CPE_ExtAddEntity2(cc_uint8* data) {
 static void CPE_BulkBlockUpdate(cc_uint8* data) {
 	cc_int32 indices[BULK_MAX_BLOCKS];
 	BlockID blocks[BULK_MAX_BLOCKS];
-	int index, i;
-	int x, y, z;
-	int count = 1 + *data++;
+	int i, count = 1 + *data++;
 
 	for (i = 0; i < count; i++) {
 		indices[i] = Stream_GetU32_BE(data); data += 4;
@@ -1282,17 +1281,12 @@ static void CPE_BulkBlockUpdate(cc_uint8* data) {
 		data += BULK_MAX_BLOCKS / 4;
 	}
 
-	for (i = 0; i < count; i++) {
-		index = indices[i];
-		if (index < 0 || index >= World.Volume) continue;
-		World_Unpack(index, x, y, z);
-
 #ifdef EXTENDED_BLOCKS
-		Game_UpdateBlock(x, y, z, blocks[i] % BLOCK_COUNT);
-#else
-		Game_UpdateBlock(x, y, z, blocks[i]);
-#endif
+	for (i = 0; i < count; i++) {
+		blocks[i] %= BLOCK_COUNT;
 	}
+#endif
+	Game_UpdateBlocks(indices, blocks, count);
 }
 
 static void CPE_SetTextColor(cc_uint8* data) {
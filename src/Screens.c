@@ -390,27 +390,24 @@ static void HUDScreen_Render(void* screen, float delta) {
 
 	Gfx_3DS_SetRenderScreen(TOP_SCREEN);
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	Gfx_BindDynamicVb(s->vb);
+	Gfx_Bind2DVb(s->vb);
 	if (Gui.ShowFPS) Widget_Render2(&s->line1, 4);
 
 	if (Game_ClassicMode) {
 		Widget_Render2(&s->line2, 8);
 	} else if (IsOnlyChatActive() && Gui.ShowFPS) {
 		Widget_Render2(&s->line2, 8);
-		Gfx_BindTexture(s->posAtlas.tex.ID);
-		Gfx_DrawVb_IndexedTris_Range(s->posCount, 12 + HOTBAR_MAX_VERTICES);
+		Gfx_Draw2DRange(s->posAtlas.tex.ID, s->posCount, 12 + HOTBAR_MAX_VERTICES);
 		/* TODO swap these two lines back */
 	}
 
 	if (!Gui_GetBlocksWorld()) {
-		Gfx_BindDynamicVb(s->vb);
+		Gfx_Bind2DVb(s->vb);
 		if (!Gui.HideHotbar) Widget_Render2(&s->hotbar, 12);
 
 		if (!Gui.HideCrosshair && Gui.IconsTex && !tablist_active) {
-			Gfx_BindTexture(Gui.IconsTex);
-			Gfx_BindDynamicVb(s->vb); /* Have to rebind for mobile right now... */
-			Gfx_DrawVb_IndexedTris(4);
+			Gfx_Bind2DVb(s->vb); /* Have to rebind for mobile right now... */
+			Gfx_Draw2DRange(Gui.IconsTex, 4, 0);
 		}
 	}
 
@@ -701,37 +698,36 @@ static void TabListOverlay_SortAndLayout(struct TabListOverlay* s) {
 	s->dirty = true;
 }
 
-static void TabListOverlay_Add(void* obj, int id) {
-	struct TabListOverlay* s = (struct TabListOverlay*)obj;
-	TabListOverlay_AddName(s, id, -1);
-	TabListOverlay_SortAndLayout(s);
-}
-
-static void TabListOverlay_Update(void* obj, int id) {
-	struct TabListOverlay* s = (struct TabListOverlay*)obj;
+static int TabListOverlay_IndexOf(struct TabListOverlay* s, int id) {
 	int i;
 	for (i = 0; i < s->usedCount; i++)
 	{
-		if (s->ids[i] != id) continue;
-		Gfx_DeleteTexture(&s->textures[i].ID);
-
-		TabListOverlay_AddName(s, id, i);
-		TabListOverlay_SortAndLayout(s);
-		return;
+		if (s->ids[i] == id) return i;
 	}
+	return -1;
 }
 
-static void TabListOverlay_Remove(void* obj, int id) {
+/* Called at most once per frame for each of added, changed and removed entries */
+/*  (so when many players join at once, the list is only sorted and laid out once) */
+static void TabListOverlay_Sync(void* obj, const int* ids, int count) {
 	struct TabListOverlay* s = (struct TabListOverlay*)obj;
-	int i;
-	for (i = 0; i < s->usedCount; i++)
+	int i, index;
+
+	/* Entries may have changed again since being batched, so just update to match the current tab list */
+	for (i = 0; i < count; i++)
 	{
-		if (s->ids[i] != id) continue;
+		index = TabListOverlay_IndexOf(s, ids[i]);
 
-		TabListOverlay_DeleteAt(s, i);
-		TabListOverlay_SortAndLayout(s);
-		return;
+		if (!TabList.NameOffsets[ids[i]]) {
+			if (index >= 0) TabListOverlay_DeleteAt(s, index);
+		} else if (index >= 0) {
+			Gfx_DeleteTexture(&s->textures[index].ID);
+			TabListOverlay_AddName(s, ids[i], index);
+		} else {
+			TabListOverlay_AddName(s, ids[i], -1);
+		}
 	}
+	TabListOverlay_SortAndLayout(s);
 }
 
 static int TabListOverlay_PointerDown(void* screen, int id, int x, int y) {
@@ -834,16 +830,13 @@ static void TabListOverlay_Render(void* screen, float delta) {
 
 	Gfx_Draw2DGradient(s->x, s->y, s->width, s->height, topCol, bottomCol);
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	Gfx_BindDynamicVb(s->vb);
+	Gfx_Bind2DVb(s->vb);
 	offset = Widget_Render2(&s->title, offset);
 
 	for (i = 0; i < s->usedCount; i++)
 	{
 		if (!s->textures[i].ID) continue;
-		Gfx_BindTexture(s->textures[i].ID);
-
-		Gfx_DrawVb_IndexedTris_Range(4, offset);
+		Gfx_Draw2DRange(s->textures[i].ID, 4, offset);
 		offset += 4;
 	}
 
@@ -853,9 +846,9 @@ static void TabListOverlay_Render(void* screen, float delta) {
 static void TabListOverlay_Free(void* screen) {
 	struct TabListOverlay* s = (struct TabListOverlay*)screen;
 	tablist_active = false;
-	Event_Unregister_(&TabListEvents.Added,   s, TabListOverlay_Add);
-	Event_Unregister_(&TabListEvents.Changed, s, TabListOverlay_Update);
-	Event_Unregister_(&TabListEvents.Removed, s, TabListOverlay_Remove);
+	Event_Unregister_(&TabListEvents.AddedBatch,   s, TabListOverlay_Sync);
+	Event_Unregister_(&TabListEvents.ChangedBatch, s, TabListOverlay_Sync);
+	Event_Unregister_(&TabListEvents.RemovedBatch, s, TabListOverlay_Sync);
 }
 
 static void TabListOverlay_Init(void* screen) {
@@ -866,9 +859,9 @@ static void TabListOverlay_Init(void* screen) {
 	s->maxVertices   = TABLIST_MAX_VERTICES;
 	TextWidget_Init(&s->title);
 
-	Event_Register_(&TabListEvents.Added,   s, TabListOverlay_Add);
-	Event_Register_(&TabListEvents.Changed, s, TabListOverlay_Update);
-	Event_Register_(&TabListEvents.Removed, s, TabListOverlay_Remove);
+	Event_Register_(&TabListEvents.AddedBatch,   s, TabListOverlay_Sync);
+	Event_Register_(&TabListEvents.ChangedBatch, s, TabListOverlay_Sync);
+	Event_Register_(&TabListEvents.RemovedBatch, s, TabListOverlay_Sync);
 }
 
 static const struct ScreenVTABLE TabListOverlay_VTABLE = {
@@ -897,7 +890,7 @@ static struct ChatScreen {
 	float chatAcc;
 	cc_bool suppressNextPress;
 	int chatIndex, paddingX, paddingY;
-	int lastDownloadStatus;
+	int lastDownloadStatus, lastLoadStatus, lastTrimmed;
 	struct FontDesc chatFont, announcementFont, bigAnnouncementFont, smallAnnouncementFont;
 	struct TextWidget announcement, bigAnnouncement, smallAnnouncement;
 	struct ChatInputWidget input;
@@ -1007,6 +1000,13 @@ static void ChatScreen_ScrollChatBy(struct ChatScreen* s, int delta) {
 	delta = newIndex - s->chatIndex;
 	if (Game_PureClassic) return;
 
+	/* Shifting only saves redrawing lines that stay visible */
+	if (Math_AbsI(delta) >= Gui.Chatlines) {
+		s->chatIndex = newIndex;
+		TextGroupWidget_RedrawAll(&s->chat);
+		return;
+	}
+
 	while (delta) {
 		if (delta < 0) {
 			/* scrolling up to oldest */
@@ -1044,10 +1044,12 @@ static void ChatScreen_EnterChatInput(struct ChatScreen* s, cc_bool close) {
 
 static void ChatScreen_UpdateTexpackStatus(struct ChatScreen* s) {
 	int progress = Http_CheckProgress(TexturePack_ReqID);
+	int loading  = TexturePack_LoadProgress();
 	cc_string msg; char msgBuffer[STRING_SIZE];
-	if (progress == s->lastDownloadStatus) return;
+	if (progress == s->lastDownloadStatus && loading == s->lastLoadStatus) return;
 
 	s->lastDownloadStatus = progress;
+	s->lastLoadStatus     = loading;
 	String_InitArray(msg, msgBuffer);
 
 	if (progress == HTTP_PROGRESS_MAKING_REQUEST) {
@@ -1056,6 +1058,8 @@ static void ChatScreen_UpdateTexpackStatus(struct ChatScreen* s) {
 		String_AppendConst(&msg, "&eDownloading texture pack");
 	} else if (progress >= 0 && progress <= 100) {
 		String_Format1(&msg, "&eDownloading texture pack (&7%i&e%%)", &progress);
+	} else if (loading >= 0) {
+		String_Format1(&msg, "&eLoading texture pack (&7%i&e%%)", &loading);
 	}
 	Chat_AddOf(&msg, MSG_TYPE_EXTRASTATUS_1);
 }
@@ -1078,15 +1082,35 @@ static void ChatScreen_ColCodeChanged(void* screen, int code) {
 	s->input.base.caretAccumulator = caretAcc;
 }
 
+/* Adjusts chat index for oldest messages removed from the chat log */
+/* Returns whether the lines being viewed were removed, and so chat needs to be redrawn */
+static cc_bool ChatScreen_CheckTrimmed(struct ChatScreen* s) {
+	int trimmed = Chat_LogTrimmed - s->lastTrimmed;
+	if (!trimmed) return false;
+
+	s->lastTrimmed = Chat_LogTrimmed;
+	s->chatIndex  -= trimmed;
+	if (s->chatIndex >= 0) return false;
+
+	s->chatIndex = ChatScreen_ClampChatIndex(0);
+	return true;
+}
+
 static void ChatScreen_ChatReceived(void* screen, const cc_string* msg, int type) {
 	struct ChatScreen* s = (struct ChatScreen*)screen;
+	cc_bool redraw = type == MSG_TYPE_NORMAL && ChatScreen_CheckTrimmed(s);
 	if (Gfx.LostContext) return;
 	s->dirty = true;
 
 	if (type == MSG_TYPE_NORMAL) {
 		s->chatIndex++;
 		if (!Gui.Chatlines) return;
-		TextGroupWidget_ShiftUp(&s->chat);
+
+		if (redraw) {
+			TextGroupWidget_RedrawAll(&s->chat);
+		} else {
+			TextGroupWidget_ShiftUp(&s->chat);
+		}
 	} else if (type >= MSG_TYPE_STATUS_1 && type <= MSG_TYPE_STATUS_3) {
 		/* Status[0] is for texture pack downloading message */
 		/* Status[1] is for reduced performance mode message */
@@ -1155,8 +1179,7 @@ static void ChatScreen_DrawChat(struct ChatScreen* s, float delta) {
 	Elem_Render(&s->bottomRight, delta);
 	Elem_Render(&s->clientStatus, delta);
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	Gfx_BindDynamicVb(s->vb);
+	Gfx_Bind2DVb(s->vb);
 	now = Game.Time;
 
 	if (s->grabsInput) {
@@ -1172,8 +1195,7 @@ static void ChatScreen_DrawChat(struct ChatScreen* s, float delta) {
 			/* Only draw chat within last 10 seconds */
 			if (Chat_GetLogTime(logIdx) + 10 < now) continue;
 			
-			Gfx_BindTexture(tex.ID);
-			Gfx_DrawVb_IndexedTris_Range(4, i * 4);
+			Gfx_Draw2DRange(tex.ID, 4, i * 4);
 		}
 	}
 
@@ -1478,7 +1500,8 @@ static void ChatScreen_Init(void* screen) {
 	s->clientStatus.collapsible[1] = true;
 
 	s->chat.underlineUrls = !Game_ClassicMode;
-	s->chatIndex = Chat_Log.count - Gui.Chatlines;
+	s->chatIndex   = Chat_Log.count - Gui.Chatlines;
+	s->lastTrimmed = Chat_LogTrimmed;
 
 	Event_Register_(&ChatEvents.ChatReceived,   s, ChatScreen_ChatReceived);
 	Event_Register_(&ChatEvents.ColCodeChanged, s, ChatScreen_ColCodeChanged);
@@ -1538,6 +1561,7 @@ static const struct ScreenVTABLE ChatScreen_VTABLE = {
 void ChatScreen_Show(void) {
 	struct ChatScreen* s  = &ChatScreen_Instance;
 	s->lastDownloadStatus = HTTP_PROGRESS_NOT_WORKING_ON;
+	s->lastLoadStatus     = -1;
 
 	s->VTABLE = &ChatScreen_VTABLE;
 	Gui_Chat  = s;
@@ -1932,15 +1956,13 @@ static void LoadingScreen_Render(void* screen, float delta) {
 	int offset, filledWidth;
 	TextureLoc loc;
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	Gfx_BindDynamicVb(s->vb);
+	Gfx_Bind2DVb(s->vb);
 
 	/* Draw background dirt */
 	offset = 0;
 	if (s->rows) {
 		loc = Block_Tex(BLOCK_DIRT, FACE_YMAX);
-		Atlas1D_Bind(Atlas1D_Index(loc));
-		Gfx_DrawVb_IndexedTris(s->rows * 4);
+		Gfx_Draw2DRange(Atlas1D_Texture(Atlas1D_Index(loc)), s->rows * 4, 0);
 		offset = s->rows * 4;
 	}
 
@@ -6,12 +6,15 @@
 #include "Game.h"
 #include "Camera.h"
 
+struct _SelectionsStats Selections_Stats;
+
 #ifdef CC_BUILD_NETWORKING
 /* Data for a selection box. */
 struct SelectionBox {
 	Vec3 p0, p1;
 	PackedCol color;
 	float minDist, maxDist;
+	float offset; /* How far box is expanded outwards, to avoid z-fighting with blocks */
 };
 
 #define X0 0
@@ -34,10 +37,9 @@ static void BuildFaces(struct SelectionBox* box, struct VertexColoured* v) {
 	PackedCol color;
 	int i, flags;
 
-	float offset = box->minDist < 32.0f * 32.0f ? (1/32.0f) : (1/16.0f);
 	Vec3 coords[2];
-	Vec3_Add1(&coords[0], &box->p0, -offset);
-	Vec3_Add1(&coords[1], &box->p1,  offset);
+	Vec3_Add1(&coords[0], &box->p0, -box->offset);
+	Vec3_Add1(&coords[1], &box->p1,  box->offset);
 
 	color = box->color;
 	for (i = 0; i < Array_Elems(faceIndices); i++, v++) {
@@ -58,10 +60,9 @@ static void BuildEdges(struct SelectionBox* box, struct VertexColoured* v) {
 	PackedCol color;
 	int i, flags;
 
-	float offset = box->minDist < 32.0f * 32.0f ? (1/32.0f) : (1/16.0f);
 	Vec3 coords[2];
-	Vec3_Add1(&coords[0], &box->p0, -offset);
-	Vec3_Add1(&coords[1], &box->p1,  offset);
+	Vec3_Add1(&coords[0], &box->p0, -box->offset);
+	Vec3_Add1(&coords[1], &box->p1,  box->offset);
 
 	color = box->color;
 	/* invert R/G/B for surrounding line */
@@ -103,23 +104,31 @@ static void CalcDists(struct SelectionBox* box, Vec3 P) {
 
 #define SELECTIONS_MAX 256
 #define SELECTIONS_VERTICES 24
-#define SELECTIONS_MAX_VERTICES SELECTIONS_MAX * SELECTIONS_VERTICES
+/* How far the camera must move before selections are sorted again */
+#define SELECTIONS_RESORT_DIST 1.0f
 
 static int selections_count;
 static struct SelectionBox selections_list[SELECTIONS_MAX];
 static cc_uint8 selections_ids[SELECTIONS_MAX];
 static GfxResourceID selections_VB, selections_LineVB;
+/* Whether selections need to be sorted again, or the vertex buffers rebuilt */
+static cc_bool selections_unsorted, selections_changed;
+static Vec3 selections_sortPos;
 
 void Selections_Add(cc_uint8 id, const IVec3* p1, const IVec3* p2, PackedCol color) {
 	struct SelectionBox sel;
 	IVec3_ToVec3(&sel.p0, p1);
 	IVec3_ToVec3(&sel.p1, p2);
-	sel.color = color;
+	sel.color  = color;
+	sel.offset = 0.0f;
 
 	Selections_Remove(id);
 	selections_list[selections_count] = sel;
 	selections_ids[selections_count]  = id;
 	selections_count++;
+
+	selections_unsorted = true;
+	selections_changed  = true;
 }
 
 void Selections_Remove(cc_uint8 id) {
@@ -133,73 +142,109 @@ void Selections_Remove(cc_uint8 id) {
 		}
 
 		selections_count--;
+		selections_changed = true;
 		return;
 	}
 }
 
-static void Selections_ContextLost(void* obj) {
-	Gfx_DeleteDynamicVb(&selections_VB);
-	Gfx_DeleteDynamicVb(&selections_LineVB);
+int Selections_Count(void) { return selections_count; }
+
+static void Selections_Reset(void) {
+	selections_count   = 0;
+	selections_changed = true;
 }
 
-static void AllocateVertexBuffers(void) {
-	selections_VB     = Gfx_CreateDynamicVb(VERTEX_FORMAT_COLOURED, SELECTIONS_MAX_VERTICES);
-	selections_LineVB = Gfx_CreateDynamicVb(VERTEX_FORMAT_COLOURED, SELECTIONS_MAX_VERTICES);
+static void Selections_ContextLost(void* obj) {
+	Gfx_DeleteVb(&selections_VB);
+	Gfx_DeleteVb(&selections_LineVB);
+	selections_changed = true;
 }
 
-static void Selections_QuickSort(int left, int right) {
+/* Boxes are only ever added at the end, and the order barely changes as the camera moves, */
+/*  so insertion sort is usually close to a single pass over the already sorted boxes */
+static void Selections_InsertionSort(void) {
 	cc_uint8* values = selections_ids; cc_uint8 value;
 	struct SelectionBox* keys = selections_list; struct SelectionBox key;
+	int i, j;
 
-	while (left < right) {
-		int i = left, j = right;
-		struct SelectionBox* pivot = &keys[(i + j) >> 1];
+	for (i = 1; i < selections_count; i++) {
+		key = keys[i]; value = values[i];
 
-		/* partition the list */
-		while (i <= j) {
-			while (CompareDists(pivot, &keys[i]) > 0) i++;
-			while (CompareDists(pivot, &keys[j]) < 0) j--;
-			QuickSort_Swap_KV_Maybe();
+		for (j = i; j > 0 && CompareDists(&keys[j - 1], &key) > 0; j--) {
+			keys[j] = keys[j - 1]; values[j] = values[j - 1];
 		}
-		/* recurse into the smaller subset */
-		QuickSort_Recurse(Selections_QuickSort)
+		if (j == i) continue;
+
+		keys[j] = key; values[j] = value;
+		selections_changed = true;
 	}
 }
 
-void Selections_Render(void) {
-	struct VertexColoured* data;
-	Vec3 cameraPos;
-	int i, count;
-	if (!selections_count) return;
+static void Selections_Sort(Vec3 cameraPos) {
+	struct SelectionBox* box;
+	float offset;
+	int i;
+
+	selections_sortPos  = cameraPos;
+	selections_unsorted = false;
+	Selections_Stats.Sorts++;
 
-	/* TODO: Proper selection box sorting. But this is very difficult because
-	   we can have boxes within boxes, intersecting boxes, etc. Probably not worth it. */
-	cameraPos = Camera.CurrentPos;
 	for (i = 0; i < selections_count; i++) {
-		CalcDists(&selections_list[i], cameraPos);
+		box = &selections_list[i];
+		CalcDists(box, cameraPos);
+
+		offset = box->minDist < 32.0f * 32.0f ? (1/32.0f) : (1/16.0f);
+		if (offset != box->offset) selections_changed = true;
+		box->offset = offset;
 	}
-	Selections_QuickSort(0, selections_count - 1);
+	Selections_InsertionSort();
+}
 
-	/* lazy init as most servers don't use this */
-	if (!selections_VB) AllocateVertexBuffers();
+static void Selections_Rebuild(void) {
+	struct VertexColoured* data;
+	int i, count = selections_count * SELECTIONS_VERTICES;
 
-	count = selections_count * SELECTIONS_VERTICES;
-	Gfx_SetVertexFormat(VERTEX_FORMAT_COLOURED);
+	selections_changed = false;
+	Selections_Stats.Rebuilds++;
 
-	data = (struct VertexColoured*)Gfx_LockDynamicVb(selections_LineVB, 
+	data = (struct VertexColoured*)Gfx_RecreateAndLockVb(&selections_LineVB,
 										VERTEX_FORMAT_COLOURED, count);
 	for (i = 0; i < selections_count; i++, data += SELECTIONS_VERTICES) {
 		BuildEdges(&selections_list[i], data);
 	}
-	Gfx_UnlockDynamicVb(selections_LineVB);
-	Gfx_DrawVb_Lines(count);
+	Gfx_UnlockVb(selections_LineVB);
 
-	data = (struct VertexColoured*)Gfx_LockDynamicVb(selections_VB, 
+	data = (struct VertexColoured*)Gfx_RecreateAndLockVb(&selections_VB,
 										VERTEX_FORMAT_COLOURED, count);
 	for (i = 0; i < selections_count; i++, data += SELECTIONS_VERTICES) {
 		BuildFaces(&selections_list[i], data);
 	}
-	Gfx_UnlockDynamicVb(selections_VB);
+	Gfx_UnlockVb(selections_VB);
+}
+
+void Selections_Render(void) {
+	Vec3 cameraPos, delta;
+	int count;
+	if (!selections_count) return;
+	Selections_Stats.Frames++;
+
+	/* TODO: Proper selection box sorting. But this is very difficult because
+	   we can have boxes within boxes, intersecting boxes, etc. Probably not worth it. */
+	cameraPos = Camera.CurrentPos;
+	Vec3_Sub(&delta, &cameraPos, &selections_sortPos);
+
+	if (selections_unsorted || Vec3_LengthSquared(&delta) >= SELECTIONS_RESORT_DIST * SELECTIONS_RESORT_DIST) {
+		Selections_Sort(cameraPos);
+	}
+	/* Vertex buffers are lazily created as most servers don't use this */
+	if (selections_changed) Selections_Rebuild();
+
+	count = selections_count * SELECTIONS_VERTICES;
+	Gfx_SetVertexFormat(VERTEX_FORMAT_COLOURED);
+
+	Gfx_BindVb(selections_LineVB);
+	Gfx_DrawVb_Lines(count);
+	Gfx_BindVb(selections_VB);
 
 	Gfx_SetDepthWrite(false);
 	Gfx_SetAlphaBlending(true);
@@ -208,8 +253,9 @@ void Selections_Render(void) {
 	Gfx_SetAlphaBlending(false);
 }
 #else
-static int selections_count;
 void Selections_Render(void) { }
+int Selections_Count(void) { return 0; }
+static void Selections_Reset(void) { }
 static void Selections_ContextLost(void* obj) { }
 #endif
 
@@ -221,7 +267,7 @@ static void OnInit(void) {
 	Event_Register_(&GfxEvents.ContextLost, NULL, Selections_ContextLost);
 }
 
-static void OnReset(void) { selections_count = 0; }
+static void OnReset(void) { Selections_Reset(); }
 
 static void OnFree(void) { Selections_ContextLost(NULL); }
 
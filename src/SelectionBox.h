@@ -15,6 +15,15 @@ void Selections_Render(void);
 CC_API void Selections_Add(cc_uint8 id, const IVec3* p1, const IVec3* p2, PackedCol color);
 /* Removes the selection box with the givne ID */
 CC_API void Selections_Remove(cc_uint8 id);
+/* Returns the number of selection boxes currently shown */
+int Selections_Count(void);
+
+/* Statistics about selection box rendering since the game started */
+extern struct _SelectionsStats {
+	int Frames;   /* Frames in which at least one selection box was rendered */
+	int Sorts;    /* Times boxes were sorted again, due to being added or the camera moving */
+	int Rebuilds; /* Times vertex buffers were rebuilt, due to boxes or their order changing */
+} Selections_Stats;
 
 CC_END_HEADER
 #endif
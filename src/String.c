@@ -917,6 +917,32 @@ void StringsBuffer_Remove(struct StringsBuffer* buffer, int index) {
 	buffer->totalLength -= len;
 }
 
+void StringsBuffer_RemoveFirst(struct StringsBuffer* buffer, int count) {
+	cc_uint32 offset, offsetAdj;
+	int i, remaining;
+	if (count <= 0) return;
+
+	if (count >= buffer->count) {
+		buffer->count       = 0;
+		buffer->totalLength = 0;
+		return;
+	}
+
+	/* Since strings are in order, all text before the first kept string can be discarded */
+	offset    = StringsBuffer_GetOffset(buffer->flagsBuffer[count]);
+	offsetAdj = StringsBuffer_PackOffset(offset);
+	remaining = buffer->count - count;
+
+	Mem_Move(buffer->textBuffer, buffer->textBuffer + offset, buffer->totalLength - offset);
+	for (i = 0; i < remaining; i++) 
+	{
+		buffer->flagsBuffer[i] = buffer->flagsBuffer[i + count] - offsetAdj;
+	}
+
+	buffer->count        = remaining;
+	buffer->totalLength -= offset;
+}
+
 static struct StringsBuffer* sort_buffer;
 static void StringsBuffer_QuickSort(int left, int right) {
 	struct StringsBuffer* buffer = sort_buffer;
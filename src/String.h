@@ -260,6 +260,9 @@ STRING_REF void StringsBuffer_UNSAFE_GetRaw(struct StringsBuffer* buffer, int i,
 CC_API void StringsBuffer_Add(struct StringsBuffer* buffer, const cc_string* str);
 /* Removes the i'th string from the given buffer, shifting following strings downwards */
 CC_API void StringsBuffer_Remove(struct StringsBuffer* buffer, int index);
+/* Removes the first count strings from the given buffer, shifting following strings downwards */
+/* NOTE: Strings must be stored in order (i.e. only ever added, never sorted or removed) */
+void StringsBuffer_RemoveFirst(struct StringsBuffer* buffer, int count);
 /* Sorts all the entries in the given buffer using String_Compare */
 void StringsBuffer_Sort(struct StringsBuffer* buffer);
 
@@ -17,6 +17,11 @@
 #include "Chat.h" /* TODO avoid this include */
 #include "Errors.h"
 
+/* Texture packs from servers are extracted on a background thread when possible */
+#if !defined CC_BUILD_COOPTHREADED && !defined CC_BUILD_LOWMEM && !defined CC_BUILD_TINYSTACK
+	#define TEXPACK_BACKGROUND_LOADING
+#endif
+
 /* Simple fallback terrain for when no texture packs are available at all */
 static BitmapCol fallback_terrain[16 * 8] = {
 	BitmapColor_RGB( 96, 144,  85), BitmapColor_RGB(129, 128, 127), BitmapColor_RGB(123,  87,  66), BitmapColor_RGB(174, 124,  74), BitmapColor_RGB(184, 151, 105), BitmapColor_RGB(200, 200, 197), BitmapColor_RGB(175, 173, 173), BitmapColor_RGB(153, 101,  75), 
@@ -66,6 +71,10 @@ struct _Atlas2DData Atlas2D;
 struct _Atlas1DData Atlas1D;
 int TexturePack_ReqID;
 
+void Atlas1D_Bind(int index) {
+	Gfx_BindTexture(Atlas1D_Texture(index));
+}
+
 TextureRec Atlas1D_TexRec(TextureLoc texLoc, int uCount, int* index) {
 	TextureRec rec;
 	int y  = Atlas1D_RowId(texLoc);
@@ -111,10 +120,10 @@ static void Atlas1D_LoadBlock(int index) {
 	Mem_Free(atlas1D.scan0);
 }
 
-void Atlas1D_Bind(int index) {
+GfxResourceID Atlas1D_Texture(int index) {
 	if (index < Atlas1D.Count && !Atlas1D.TexIds[index])
 		Atlas1D_LoadBlock(index);
-	Gfx_BindTexture(Atlas1D.TexIds[index]);
+	return Atlas1D.TexIds[index];
 }
 
 static void Atlas_Convert2DTo1D(void) {
@@ -123,8 +132,38 @@ static void Atlas_Convert2DTo1D(void) {
 	Platform_Log2("Terrain atlas: %i bmps, %i per bmp", &atlasesCount, &tilesPerAtlas);
 }
 #else
-void Atlas1D_Bind(int index) {
-	Gfx_BindTexture(Atlas1D.TexIds[index]);
+GfxResourceID Atlas1D_Texture(int index) {
+	return Atlas1D.TexIds[index];
+}
+
+/* 1D atlases that were already sliced from a terrain atlas by the background texture pack loader */
+static struct Bitmap atlas_slices;
+static BitmapCol* atlas_slicesSrc;
+
+static void Atlas_FreeSlices(void) {
+	Mem_Free(atlas_slices.scan0);
+	atlas_slices.scan0 = NULL;
+	atlas_slicesSrc    = NULL;
+}
+
+static cc_bool Atlas_UploadSlices(void) {
+	int tileSize     = Atlas2D.TileSize;
+	int atlasHeight  = Atlas1D.TilesPerAtlas * tileSize;
+	struct Bitmap atlas1D;
+	int i;
+
+	/* Slices are only usable if they were made with the same layout as the current 1D atlases */
+	if (atlas_slicesSrc != Atlas2D.Bmp.scan0 || atlas_slices.width != tileSize) return false;
+	if (atlas_slices.height != Atlas1D.Count * atlasHeight) return false;
+
+	for (i = 0; i < Atlas1D.Count; i++) 
+	{
+		atlas1D.scan0  = Bitmap_GetRow(&atlas_slices, i * atlasHeight);
+		atlas1D.width  = tileSize;
+		atlas1D.height = atlasHeight;
+		Gfx_RecreateTexture(&Atlas1D.TexIds[i], &atlas1D, TEXTURE_FLAG_MANAGED | TEXTURE_FLAG_DYNAMIC, Gfx.Mipmaps);
+	}
+	return true;
 }
 
 static void Atlas_Convert2DTo1D(void) {
@@ -135,6 +174,7 @@ static void Atlas_Convert2DTo1D(void) {
 	int i;
 
 	Platform_Log2("Loaded terrain atlas: %i bmps, %i per bmp", &atlasesCount, &tilesPerAtlas);
+	if (Atlas_UploadSlices()) { Atlas_FreeSlices(); return; }
 	Bitmap_Allocate(&atlas1D, tileSize, tilesPerAtlas * tileSize);
 	
 	for (i = 0; i < atlasesCount; i++) 
@@ -145,22 +185,26 @@ static void Atlas_Convert2DTo1D(void) {
 }
 #endif
 
-static void Atlas_Update1D(void) {
-	int maxAtlasHeight, maxTilesPerAtlas, maxTiles;
+static int Atlas1D_CalcTilesPerAtlas(int tileSize, int maxTiles) {
+	int maxAtlasHeight, maxTilesPerAtlas;
 	int maxTexHeight = Gfx.MaxTexHeight;
 
 	/* E.g. a graphics backend may support textures up to 256 x 256 */
 	/*   dimension wise, but only have enough storage for 16 x 256 */
 	if (Gfx.MaxTexSize) {
-		int maxCurHeight = Gfx.MaxTexSize / Atlas2D.TileSize;
+		int maxCurHeight = Gfx.MaxTexSize / tileSize;
 		maxTexHeight     = min(maxTexHeight, maxCurHeight);
 	}
 
 	maxAtlasHeight   = min(4096, maxTexHeight);
-	maxTilesPerAtlas = maxAtlasHeight / Atlas2D.TileSize;
-	maxTiles         = Atlas2D.RowsCount * ATLAS2D_TILES_PER_ROW;
+	maxTilesPerAtlas = maxAtlasHeight / tileSize;
+	return min(maxTilesPerAtlas, maxTiles);
+}
 
-	Atlas1D.TilesPerAtlas = min(maxTilesPerAtlas, maxTiles);
+static void Atlas_Update1D(void) {
+	int maxTiles = Atlas2D.RowsCount * ATLAS2D_TILES_PER_ROW;
+
+	Atlas1D.TilesPerAtlas = Atlas1D_CalcTilesPerAtlas(Atlas2D.TileSize, maxTiles);
 	Atlas1D.Count = Math_CeilDiv(maxTiles, Atlas1D.TilesPerAtlas);
 
 	Atlas1D.InvTileSize = 1.0f / Atlas1D.TilesPerAtlas;
@@ -426,6 +470,414 @@ static void UpdateCache(struct HttpRequest* req) {
 }
 
 
+/*########################################################################################################################*
+*----------------------------------------------------TexturePack loader---------------------------------------------------*
+*#########################################################################################################################*/
+/* Reading, decompressing and decoding a texture pack is done on a background thread, */
+/*  and then all the files are handed to TextureEvents.FileChanged at once on the main thread. */
+/* This way the current texture pack remains in use until the new one is ready, */
+/*  and the main thread only has to upload the already decoded images to the GPU. */
+#ifdef TEXPACK_BACKGROUND_LOADING
+enum PackItemType { PACK_ITEM_BEGIN, PACK_ITEM_FILE, PACK_ITEM_ATLAS, PACK_ITEM_ERROR };
+
+struct PackItem {
+	struct PackItem* next;
+	int type;
+	cc_string name;
+	char nameBuffer[FILENAME_SIZE];
+	/* Raw contents of the file */
+	cc_uint8* data;
+	cc_uint32 size;
+	/* Whether the file is a .png image that still needs to be decoded */
+	cc_bool needsDecode;
+	/* Decoded image, if the file is a valid .png */
+	struct Bitmap bmp;
+	/* 1D atlases sliced from the image, if the file is terrain.png */
+	struct Bitmap slices;
+	/* Error that occurred, and what was being done when it occurred */
+	cc_result res;
+	const char* place;
+};
+
+static void* loader_thread;
+static volatile cc_bool loader_done, loader_stop;
+/* Number of texture packs to extract, how many are done, and how far through the current one */
+static volatile int loader_packs, loader_packsDone, loader_percent;
+static struct Stream* loader_src;
+static cc_uint32 loader_srcLength;
+static struct PackItem* loader_head;
+static struct PackItem* loader_tail;
+
+static cc_bool loader_defaults, loader_defaultMissing;
+static cc_bool loader_hasPack;
+static struct Stream loader_pack;
+static void* loader_data;
+static char loaderUserBuffer[FILENAME_SIZE];
+static char loaderUrlBuffer[URL_MAX_SIZE];
+static cc_string loader_user = String_FromArray(loaderUserBuffer);
+static cc_string loader_url  = String_FromArray(loaderUrlBuffer);
+
+/* Image and stream of the file currently being raised in TextureEvents.FileChanged */
+static struct PackItem* loader_cur;
+static struct Stream loader_curStream;
+
+static struct PackItem* PackLoader_Add(int type, const cc_string* name) {
+	struct PackItem* item = (struct PackItem*)Mem_TryAllocCleared(1, sizeof(struct PackItem));
+	if (!item) return NULL;
+
+	item->type = type;
+	String_InitArray(item->name, item->nameBuffer);
+	String_AppendString(&item->name, name);
+
+	LinkedList_Append(item, loader_head, loader_tail);
+	return item;
+}
+
+static void PackLoader_AddError(cc_result res, const char* place, const cc_string* path) {
+	struct PackItem* item = PackLoader_Add(PACK_ITEM_ERROR, path);
+	if (!item) return;
+
+	item->res   = res;
+	item->place = place;
+}
+
+/* Copies all the tiles of the given terrain atlas into consecutive 1D atlases */
+static void PackLoader_SliceAtlas(struct Bitmap* atlas, struct Bitmap* slices) {
+	int tileSize = atlas->width / ATLAS2D_TILES_PER_ROW;
+	int rowsCount, maxTiles, tilesPerAtlas, count, tile;
+	if (tileSize <= 0 || atlas->height < tileSize) return;
+
+	rowsCount     = min(atlas->height / tileSize, ATLAS2D_MAX_ROWS_COUNT);
+	maxTiles      = rowsCount * ATLAS2D_TILES_PER_ROW;
+	tilesPerAtlas = Atlas1D_CalcTilesPerAtlas(tileSize, maxTiles);
+	if (tilesPerAtlas <= 0) return;
+	count         = Math_CeilDiv(maxTiles, tilesPerAtlas);
+
+	Bitmap_TryAllocate(slices, tileSize, count * tilesPerAtlas * tileSize);
+	if (!slices->scan0) return;
+
+	for (tile = 0; tile < maxTiles; tile++) 
+	{
+		Bitmap_UNSAFE_CopyBlock(Atlas2D_TileX(tile) * tileSize, Atlas2D_TileY(tile) * tileSize,
+							0, tile * tileSize, atlas, slices, tileSize);
+	}
+}
+
+static void PackLoader_DecodePng(struct PackItem* item) {
+	static const cc_string terrain = String_FromConst("terrain.png");
+	struct Stream stream;
+	Stream_ReadonlyMemory(&stream, item->data, item->size);
+
+	/* If decoding fails, the file's handler will report the error when it decodes the file itself */
+	if (Png_Decode(&item->bmp, &stream)) {
+		Mem_Free(item->bmp.scan0);
+		item->bmp.scan0 = NULL;
+	} else if (String_CaselessEquals(&item->name, &terrain)) {
+		PackLoader_SliceAtlas(&item->bmp, &item->slices);
+	}
+}
+
+#define LOADER_DECODE_THREADS 3
+static void* loader_decoders[LOADER_DECODE_THREADS];
+static void* loader_decodeMutex;
+static struct PackItem* loader_decodeNext;
+
+/* Returns the next extracted .png file that still needs to be decoded */
+static struct PackItem* PackLoader_NextPng(void) {
+	struct PackItem* item;
+
+	Mutex_Lock(loader_decodeMutex);
+	{
+		for (item = loader_decodeNext; item && !item->needsDecode; item = item->next) { }
+		loader_decodeNext = item ? item->next : NULL;
+	}
+	Mutex_Unlock(loader_decodeMutex);
+	return item;
+}
+
+static void PackLoader_DecodeWorker(void) {
+	struct PackItem* item;
+
+	while (!loader_stop && (item = PackLoader_NextPng())) {
+		PackLoader_DecodePng(item);
+	}
+}
+
+/* Decodes all the .png files from first onwards, using several threads at once */
+static void PackLoader_DecodeAll(struct PackItem* first) {
+	int i;
+	loader_decodeNext  = first;
+	loader_decodeMutex = Mutex_Create("Texture pack decoding");
+
+	for (i = 0; i < LOADER_DECODE_THREADS; i++) {
+		Thread_Run(&loader_decoders[i], PackLoader_DecodeWorker, 256 * 1024, "Texture pack decoder");
+	}
+	PackLoader_DecodeWorker();
+
+	for (i = 0; i < LOADER_DECODE_THREADS; i++) {
+		Thread_Join(loader_decoders[i]);
+		loader_decoders[i] = NULL;
+	}
+	Mutex_Free(loader_decodeMutex);
+	loader_decodeMutex = NULL;
+}
+
+static cc_bool PackLoader_SelectEntry(const cc_string* path) { return true; }
+
+static cc_result PackLoader_ProcessEntry(const cc_string* path, struct Stream* stream, struct ZipEntry* source) {
+	static const cc_string png = String_FromConst(".png");
+	struct PackItem* item;
+	cc_string name = *path;
+	cc_uint32 pos;
+	cc_result res;
+	if (loader_stop) return ERR_NOT_SUPPORTED;
+
+	Utils_UNSAFE_GetFilename(&name);
+	item = PackLoader_Add(PACK_ITEM_FILE, &name);
+	if (!item) return ERR_OUT_OF_MEMORY;
+
+	item->size = source->UncompressedSize;
+	item->data = (cc_uint8*)Mem_TryAlloc(item->size + 1, 1);
+
+	if (!item->data) {
+		item->type  = PACK_ITEM_ERROR;
+		item->res   = ERR_OUT_OF_MEMORY;
+		item->place = "extracting";
+	} else if ((res = Stream_Read(stream, item->data, item->size))) {
+		item->type  = PACK_ITEM_ERROR;
+		item->res   = res;
+		item->place = "extracting";
+	} else {
+		/* Images are decoded later, once all the entries have been extracted */
+		item->needsDecode = String_CaselessEnds(&name, &png);
+	}
+
+	/* Entries are usually stored in the order they are extracted in */
+	if (!loader_src->Position(loader_src, &pos) && loader_srcLength) {
+		loader_percent = (int)(pos * 100.0f / loader_srcLength);
+	}
+	return 0;
+}
+
+static cc_result PackLoader_Extract(struct Stream* stream, const cc_string* path) {
+	struct ZipEntry entries[512];
+	struct PackItem* item;
+	struct PackItem* last;
+	struct Bitmap bmp;
+	cc_result res;
+	PackLoader_Add(PACK_ITEM_BEGIN, path);
+
+	res = Png_Decode(&bmp, stream);
+	if (!res) {
+		/* Texture pack is just a terrain.png image */
+		item = PackLoader_Add(PACK_ITEM_ATLAS, path);
+		if (!item) { Mem_Free(bmp.scan0); return ERR_OUT_OF_MEMORY; }
+
+		item->bmp = bmp;
+		PackLoader_SliceAtlas(&item->bmp, &item->slices);
+		return 0;
+	}
+	Mem_Free(bmp.scan0);
+
+	if (res == PNG_ERR_INVALID_SIG) {
+		/* file isn't a .png image, probably a .zip archive then */
+		last = loader_tail;
+		res  = Zip_Extract(stream, PackLoader_SelectEntry, PackLoader_ProcessEntry,
+							entries, Array_Elems(entries));
+		PackLoader_DecodeAll(last ? last->next : loader_head);
+
+		if (res && !loader_stop) PackLoader_AddError(res, "extracting", path);
+	} else {
+		PackLoader_AddError(res, "decoding", path);
+	}
+	return res;
+}
+
+static cc_result PackLoader_ExtractFrom(struct Stream* stream, const cc_string* path) {
+	cc_result res;
+	if (loader_stop) return ERR_NOT_SUPPORTED;
+
+	loader_src       = stream;
+	loader_srcLength = 0;
+	(void)stream->Length(stream, &loader_srcLength);
+
+	res = PackLoader_Extract(stream, path);
+	loader_packsDone++;
+	loader_percent = 0;
+	return res;
+}
+
+static cc_result PackLoader_ExtractFile(const cc_string* path) {
+	struct Stream stream;
+	cc_result res;
+
+	res = Stream_OpenFile(&stream, path);
+	if (res) { PackLoader_AddError(res, "opening", path); return res; }
+
+	res = PackLoader_ExtractFrom(&stream, path);
+	/* No point logging error for closing readonly file */
+	(void)stream.Close(&stream);
+	return res;
+}
+
+static void PackLoader_Worker(void) {
+	cc_result res;
+
+	if (loader_defaults) {
+		res = TexturePack_ExtractDefault(PackLoader_ExtractFile);
+		loader_defaultMissing = res == ReturnCode_FileNotFound;
+		if (loader_user.length) PackLoader_ExtractFile(&loader_user);
+	}
+
+	if (loader_hasPack) {
+		PackLoader_ExtractFrom(&loader_pack, &loader_url);
+		/* No point logging error for closing readonly file */
+		(void)loader_pack.Close(&loader_pack);
+	}
+	loader_done = true;
+}
+
+/* Starts extracting the default texture packs (if defaults is true) and then the given */
+/*  texture pack (if pack is non-NULL) on a background thread. Takes ownership of pack and data. */
+static cc_bool PackLoader_Start(cc_bool defaults, const cc_string* userPath,
+								struct Stream* pack, void* data, const cc_string* url) {
+	loader_done      = false;
+	loader_stop      = false;
+	loader_packs     = (defaults ? 1 + (userPath->length > 0) : 0) + (pack != NULL);
+	loader_packsDone = 0;
+	loader_percent   = 0;
+
+	loader_defaults  = defaults;
+	loader_hasPack   = pack != NULL;
+	loader_data      = data;
+	if (pack) loader_pack = *pack;
+
+	String_Copy(&loader_user, userPath);
+	String_Copy(&loader_url,  url);
+	Thread_Run(&loader_thread, PackLoader_Worker, 256 * 1024, "Texture pack loader");
+	return true;
+}
+
+static void PackLoader_Free(void) {
+	struct PackItem* item;
+	struct PackItem* next;
+
+	for (item = loader_head; item; item = next) 
+	{
+		next = item->next;
+		Mem_Free(item->data);
+		Mem_Free(item->bmp.scan0);
+		Mem_Free(item->slices.scan0);
+		Mem_Free(item);
+	}
+	loader_head = NULL;
+	loader_tail = NULL;
+
+	Mem_Free(loader_data);
+	loader_data = NULL;
+}
+
+/* Cancels extracting the texture pack, returning whether it was extracting default texture packs too */
+static cc_bool PackLoader_Stop(void) {
+	if (!loader_thread) return false;
+
+	loader_stop = true;
+	Thread_Join(loader_thread);
+	loader_thread = NULL;
+
+	PackLoader_Free();
+	return loader_defaults;
+}
+
+static void PackLoader_Apply(void) {
+	struct PackItem* item;
+
+	for (item = loader_head; item; item = item->next) 
+	{
+		switch (item->type) 
+		{
+		case PACK_ITEM_BEGIN:
+			Event_RaiseVoid(&TextureEvents.PackChanged);
+			break;
+
+		case PACK_ITEM_ERROR:
+			Logger_SysWarn2(item->res, item->place, &item->name);
+			break;
+
+		case PACK_ITEM_ATLAS:
+			atlas_slices    = item->slices;
+			atlas_slicesSrc = item->bmp.scan0;
+			item->slices.scan0 = NULL;
+
+			if (Atlas_TryChange(&item->bmp)) item->bmp.scan0 = NULL;
+			break;
+
+		case PACK_ITEM_FILE:
+			Stream_ReadonlyMemory(&loader_curStream, item->data, item->size);
+			loader_cur = item;
+			Event_RaiseEntry(&TextureEvents.FileChanged, &loader_curStream, &item->name);
+			loader_cur = NULL;
+			break;
+		}
+
+		/* Free resources as soon as possible, as HD texture packs can use a lot of memory */
+		Mem_Free(item->bmp.scan0);    item->bmp.scan0    = NULL;
+		Mem_Free(item->slices.scan0); item->slices.scan0 = NULL;
+		Atlas_FreeSlices();
+	}
+}
+
+/* Applies the extracted texture packs once the background thread has finished */
+static cc_bool PackLoader_Check(cc_bool* hasPack) {
+	if (!loader_thread || !loader_done) return false;
+	/* If context is lost, then trying to load textures will just fail */
+	/* So defer applying the texture pack until context is restored */
+	if (Gfx.LostContext) return false;
+
+	Thread_Join(loader_thread);
+	loader_thread = NULL;
+
+	if (loader_defaults) TexturePack_DefaultMissing = loader_defaultMissing;
+	*hasPack = loader_hasPack;
+	PackLoader_Apply();
+	PackLoader_Free();
+	return true;
+}
+
+int TexturePack_LoadProgress(void) {
+	int progress;
+	if (!loader_thread || !loader_packs) return -1;
+
+	progress = (loader_packsDone * 100 + loader_percent) / loader_packs;
+	return min(progress, 100);
+}
+
+cc_result TexturePack_DecodePng(struct Bitmap* bmp, struct Stream* stream) {
+	struct PackItem* item = loader_cur;
+	if (!item || stream != &loader_curStream || !item->bmp.scan0) return Png_Decode(bmp, stream);
+
+	/* Image was already decoded on the background thread */
+	*bmp = item->bmp;
+	item->bmp.scan0 = NULL;
+
+	atlas_slices    = item->slices;
+	atlas_slicesSrc = bmp->scan0;
+	item->slices.scan0 = NULL;
+	return 0;
+}
+#else
+static cc_bool PackLoader_Start(cc_bool defaults, const cc_string* userPath,
+								struct Stream* pack, void* data, const cc_string* url) { return false; }
+static cc_bool PackLoader_Stop(void)  { return false; }
+static cc_bool PackLoader_Check(cc_bool* hasPack) { return false; }
+int TexturePack_LoadProgress(void) { return -1; }
+
+cc_result TexturePack_DecodePng(struct Bitmap* bmp, struct Stream* stream) {
+	return Png_Decode(bmp, stream);
+}
+#endif
+
+
 /*########################################################################################################################*
 *-------------------------------------------------------TexturePack-------------------------------------------------------*
 *#########################################################################################################################*/
@@ -527,6 +979,14 @@ static cc_result ExtractFromFile(const cc_string* path) {
 }
 #endif
 
+/* Returns the path of the user's selected texture pack, or empty if it is just the default textures */
+static cc_string GetUserTexturesPath(void) {
+	cc_string path = TexturePack_Path;
+	if (String_CaselessEqualsConst(&path, "texpacks/default.zip")) path.length = 0;
+	if (Game_ClassicMode) path.length = 0;
+	return path;
+}
+
 static cc_result ExtractUserTextures(void) {
 	cc_string path;
 	cc_result res;
@@ -536,9 +996,8 @@ static cc_result ExtractUserTextures(void) {
 	/* Game shows a warning dialog if default textures are missing */
 	TexturePack_DefaultMissing = res == ReturnCode_FileNotFound;
 
-	path = TexturePack_Path;
-	if (String_CaselessEqualsConst(&path, "texpacks/default.zip")) path.length = 0;
-	if (Game_ClassicMode || path.length == 0) return res;
+	path = GetUserTexturesPath();
+	if (path.length == 0) return res;
 
 	/* override default textures with user's selected texture pack */
 	return ExtractFromFile(&path);
@@ -550,6 +1009,9 @@ cc_result TexturePack_ExtractCurrent(cc_bool forceReload) {
 	struct Stream stream;
 	cc_result res = 0;
 
+	/* Texture pack being extracted in the background is outdated now */
+	PackLoader_Stop();
+
 	/* don't pointlessly load default texture pack */
 	if (!usingDefault || forceReload) {
 		res = ExtractUserTextures();
@@ -569,23 +1031,58 @@ cc_result TexturePack_ExtractCurrent(cc_bool forceReload) {
 	return res;
 }
 
+/* Same as TexturePack_ExtractCurrent(false), except that the texture pack is extracted */
+/*  in the background when possible so the game isn't blocked while doing so */
+static void ExtractCurrentAsync(void) {
+	cc_string url  = TexturePack_Url;
+	cc_string path = GetUserTexturesPath();
+	cc_bool defaults, hasPack;
+	struct Stream stream;
+
+	PackLoader_Stop();
+	defaults = !usingDefault;
+	hasPack  = url.length && OpenCachedData(&url, &stream);
+	if (!defaults && !hasPack) return;
+
+	if (PackLoader_Start(defaults, &path, hasPack ? &stream : NULL, NULL, &url)) return;
+	/* No point logging error for closing readonly file */
+	if (hasPack) (void)stream.Close(&stream);
+	TexturePack_ExtractCurrent(false);
+}
+
 /* Extracts and updates cache for the downloaded texture pack */
 static void ApplyDownloaded(struct HttpRequest* item) {
 	struct Stream mem;
-	cc_string url;
+	cc_string url, path;
+	cc_bool defaults;
 
 	url = String_FromRawArray(item->url);
 	if (!Platform_ReadonlyFilesystem) UpdateCache(item);
 	/* Took too long to download and is no longer active texture pack */
 	if (!String_Equals(&TexturePack_Url, &url)) return;
 
+	/* The cached texture pack may still be extracting, but this one is newer */
+	defaults = PackLoader_Stop();
+	path     = GetUserTexturesPath();
 	Stream_ReadonlyMemory(&mem, item->data, item->size);
+
+	if (PackLoader_Start(defaults, &path, &mem, item->data, &url)) {
+		item->data = NULL; return;
+	}
+
 	ExtractFrom(&mem, &url);
 	usingDefault = false;
 }
 
 void TexturePack_CheckPending(void) {
 	struct HttpRequest item;
+	cc_bool hasPack;
+
+	if (PackLoader_Check(&hasPack)) {
+		usingDefault = !hasPack;
+		/* Use fallback terrain texture with 1 pixel per tile */
+		if (!Atlas2D.Bmp.scan0) LoadFallbackAtlas();
+	}
 	if (!Http_GetResult(TexturePack_ReqID, &item)) return;
 
 	if (item.success) {
@@ -627,7 +1124,7 @@ void TexturePack_Extract(const cc_string* url) {
 
 	if (String_Equals(url, &TexturePack_Url)) return;
 	String_Copy(&TexturePack_Url, url);
-	TexturePack_ExtractCurrent(false);
+	ExtractCurrentAsync();
 }
 
 static struct TextureEntry* entries_head;
@@ -643,7 +1140,7 @@ void TextureEntry_Register(struct TextureEntry* entry) {
 *#########################################################################################################################*/
 static void TerrainPngProcess(struct Stream* stream, const cc_string* name) {
 	struct Bitmap bmp;
-	cc_result res = Png_Decode(&bmp, stream);
+	cc_result res = TexturePack_DecodePng(&bmp, stream);
 
 	if (res) {
 		Logger_SysWarn2(res, "decoding", name);
@@ -705,6 +1202,7 @@ static void OnReset(void) {
 }
 
 static void OnFree(void) {
+	PackLoader_Stop();
 	OnContextLost(NULL);
 	Atlas2D_Free();
 	TexturePack_Url.length = 0;
@@ -28,8 +28,10 @@ extern struct IGameComponent Textures_Component;
 #else
 	#define ATLAS2D_MAX_ROWS_COUNT 16
 #endif
+/* Maximum number of tiles in the atlas. */
+#define ATLAS2D_MAX_TILES (ATLAS2D_TILES_PER_ROW * ATLAS2D_MAX_ROWS_COUNT)
 /* Maximum possible number of 1D terrain atlases. (worst case, each 1D atlas only has 1 tile) */
-#define ATLAS1D_MAX_ATLASES (ATLAS2D_TILES_PER_ROW * ATLAS2D_MAX_ROWS_COUNT)
+#define ATLAS1D_MAX_ATLASES ATLAS2D_MAX_TILES
 
 CC_VAR extern struct _Atlas2DData {
 	/* Bitmap that contains the textures of all tiles. */
@@ -77,6 +79,8 @@ cc_bool Atlas_TryChange(struct Bitmap* bmp);
 /* That is, returns U1/U2/V1/V2 coords that make up the tile in a 1D atlas. */
 /* index is set to the index of the 1D atlas that the tile is in. */
 TextureRec Atlas1D_TexRec(TextureLoc texLoc, int uCount, int* index);
+/* Returns the texture of the given 1D atlas */
+GfxResourceID Atlas1D_Texture(int index);
 void Atlas1D_Bind(int index);
 
 /* Whether the given URL is in list of accepted URLs. */
@@ -109,6 +113,12 @@ CC_API void TexturePack_Extract(const cc_string* url);
 
 typedef cc_result (*DefaultZipCallback)(const cc_string* path);
 cc_result TexturePack_ExtractDefault(DefaultZipCallback callback);
+/* Returns how far extracting the texture pack in the background is (from 0 to 100), */
+/*  or -1 if no texture pack is currently being extracted in the background. */
+int TexturePack_LoadProgress(void);
+/* Decodes the .png image passed to a TextureEvents.FileChanged handler. */
+/* NOTE: If the image was already decoded on the background thread, that image is returned instead. */
+cc_result TexturePack_DecodePng(struct Bitmap* bmp, struct Stream* stream);
 
 struct TextureEntry;
 struct TextureEntry {
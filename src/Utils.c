@@ -231,6 +231,112 @@ int Convert_FromBase64(const char* src, int len, cc_uint8* dst) {
 /*########################################################################################################################*
 *--------------------------------------------------------EntryList--------------------------------------------------------*
 *#########################################################################################################################*/
+/* Indexes are kept in a small linked list, as very few lists are ever indexed */
+static struct EntryListIndex* indices_head;
+
+static struct EntryListIndex* EntryList_GetIndex(struct StringsBuffer* list, char separator) {
+	struct EntryListIndex* idx;
+	for (idx = indices_head; idx; idx = idx->next)
+	{
+		if (idx->list != list) continue;
+		return idx->separator == separator ? idx : NULL;
+	}
+	return NULL;
+}
+
+/* FNV-1a hash of the key, lowercased so it matches String_CaselessEquals */
+static cc_uint32 EntryList_HashKey(const cc_string* key) {
+	cc_uint32 hash = 2166136261UL;
+	int i;
+	char c;
+
+	for (i = 0; i < key->length; i++)
+	{
+		c = key->buffer[i];
+		Char_MakeLower(c);
+		hash = (hash ^ (cc_uint8)c) * 16777619UL;
+	}
+	return hash;
+}
+
+static cc_uint32 EntryList_HashAt(struct EntryListIndex* idx, int i) {
+	cc_string entry, key, value;
+	StringsBuffer_UNSAFE_GetRaw(idx->list, i, &entry);
+	String_UNSAFE_Separate(&entry, idx->separator, &key, &value);
+	return EntryList_HashKey(&key);
+}
+
+static void EntryList_InsertSlot(struct EntryListIndex* idx, int i, cc_uint32 hash) {
+	int slot = hash & idx->mask;
+	while (idx->slots[slot].index >= 0) { slot = (slot + 1) & idx->mask; }
+
+	idx->slots[slot].index = i;
+	idx->slots[slot].hash  = hash;
+}
+
+static void EntryList_RebuildIndex(struct EntryListIndex* idx) {
+	int i, capacity = ENTRYLIST_MIN_SLOTS;
+	/* Keep at most half the slots in use, so probe chains stay short */
+	while (capacity < idx->list->count * 2 + 2) capacity *= 2;
+
+	if (capacity != idx->mask + 1) {
+		Mem_Free(idx->slots);
+		idx->slots = (struct EntryListSlot*)Mem_Alloc(capacity, sizeof(struct EntryListSlot), "entrylist index");
+		idx->mask  = capacity - 1;
+	}
+
+	for (i = 0; i < capacity; i++) { idx->slots[i].index = -1; }
+	for (i = 0; i < idx->list->count; i++)
+	{
+		EntryList_InsertSlot(idx, i, EntryList_HashAt(idx, i));
+	}
+}
+
+/* Adds the entry that was just appended to the list to any index over the list */
+static void EntryList_Append(struct StringsBuffer* list, const cc_string* entry) {
+	struct EntryListIndex* idx;
+	int i = list->count;
+	StringsBuffer_Add(list, entry);
+
+	for (idx = indices_head; idx; idx = idx->next)
+	{
+		if (idx->list != list) continue;
+
+		if (list->count * 2 + 2 > idx->mask + 1) {
+			EntryList_RebuildIndex(idx);
+		} else {
+			EntryList_InsertSlot(idx, i, EntryList_HashAt(idx, i));
+		}
+	}
+}
+
+/* Removes the slot for the given entry, then shifts later slots in the probe chain back into the gap */
+static void EntryList_RemoveSlot(struct EntryListIndex* idx, int i) {
+	struct EntryListSlot* slots = idx->slots;
+	int gap, cur, home, mask = idx->mask;
+
+	gap = EntryList_HashAt(idx, i) & mask;
+	while (slots[gap].index != i) { gap = (gap + 1) & mask; }
+
+	for (cur = gap;;)
+	{
+		slots[gap].index = -1;
+		for (;;)
+		{
+			cur = (cur + 1) & mask;
+			if (slots[cur].index < 0) return;
+			home = slots[cur].hash & mask;
+
+			/* Slot can't be moved if its home position lies cyclically within (gap, cur] */
+			if (gap <= cur ? (gap < home && home <= cur) : (gap < home || home <= cur)) continue;
+			break;
+		}
+
+		slots[gap] = slots[cur];
+		gap = cur;
+	}
+}
+
 cc_result EntryList_Load(struct StringsBuffer* list, const char* file, char separator, EntryList_Filter filter) {
 	cc_string entry; char entryBuffer[1024];
 	cc_string path;
@@ -278,7 +384,7 @@ cc_result EntryList_Load(struct StringsBuffer* list, const char* file, char sepa
 			String_UNSAFE_Separate(&entry, separator, &key, &value);
 			EntryList_Set(list, &key, &value, separator);
 		} else {
-			StringsBuffer_Add(list, &entry);
+			EntryList_Append(list, &entry);
 		}
 	}
 
@@ -313,6 +419,53 @@ void EntryList_Save(struct StringsBuffer* list, const char* file) {
 	if (res) { Logger_SysWarn2(res, "closing", &path); }
 }
 
+void EntryList_AddIndex(struct EntryListIndex* idx, struct StringsBuffer* list, char separator) {
+	idx->list      = list;
+	idx->separator = separator;
+	idx->slots     = NULL;
+	idx->mask      = -1;
+
+	EntryList_RebuildIndex(idx);
+	idx->next    = indices_head;
+	indices_head = idx;
+}
+
+void EntryList_RemoveIndex(struct EntryListIndex* idx) {
+	struct EntryListIndex** cur;
+	for (cur = &indices_head; *cur; cur = &(*cur)->next)
+	{
+		if (*cur != idx) continue;
+		*cur = idx->next; break;
+	}
+
+	Mem_Free(idx->slots);
+	idx->slots = NULL;
+	idx->list  = NULL;
+	idx->mask  = -1;
+}
+
+void EntryList_RemoveAt(struct StringsBuffer* list, int i) {
+	struct EntryListIndex* idx;
+	int j;
+
+	for (idx = indices_head; idx; idx = idx->next)
+	{
+		if (idx->list == list) EntryList_RemoveSlot(idx, i);
+	}
+	StringsBuffer_Remove(list, i);
+
+	/* Entries after the removed one have all moved down by one */
+	for (idx = indices_head; idx; idx = idx->next)
+	{
+		if (idx->list != list) continue;
+
+		for (j = 0; j <= idx->mask; j++)
+		{
+			if (idx->slots[j].index > i) idx->slots[j].index--;
+		}
+	}
+}
+
 cc_bool EntryList_Remove(struct StringsBuffer* list, const cc_string* key, char separator) {
 	cc_bool found = false;
 	/* Have to use a for loop, because may be multiple entries with same key */
@@ -320,7 +473,7 @@ cc_bool EntryList_Remove(struct StringsBuffer* list, const cc_string* key, char
 		int i = EntryList_Find(list, key, separator);
 		if (i == -1) break;
 		
-		StringsBuffer_Remove(list, i);
+		EntryList_RemoveAt(list, i);
 		found = true;
 	}
 	return found;
@@ -337,25 +490,43 @@ void EntryList_Set(struct StringsBuffer* list, const cc_string* key, const cc_st
 	}
 
 	EntryList_Remove(list, key, separator);
-	StringsBuffer_Add(list, &entry);
+	EntryList_Append(list, &entry);
 }
 
 cc_string EntryList_UNSAFE_Get(struct StringsBuffer* list, const cc_string* key, char separator) {
 	cc_string curEntry, curKey, curValue;
-	int i;
+	int i = EntryList_Find(list, key, separator);
+	if (i == -1) return String_Empty;
 
-	for (i = 0; i < list->count; i++) {
-		StringsBuffer_UNSAFE_GetRaw(list, i, &curEntry);
-		String_UNSAFE_Separate(&curEntry, separator, &curKey, &curValue);
+	StringsBuffer_UNSAFE_GetRaw(list, i, &curEntry);
+	String_UNSAFE_Separate(&curEntry, separator, &curKey, &curValue);
+	return curValue;
+}
+
+static int EntryList_FindIndexed(struct EntryListIndex* idx, const cc_string* key) {
+	cc_string curEntry, curKey, curValue;
+	cc_uint32 hash = EntryList_HashKey(key);
+	int slot = hash & idx->mask;
+	int i, best = -1;
+
+	/* Must return the earliest matching entry, like the linear search does */
+	for (; (i = idx->slots[slot].index) >= 0; slot = (slot + 1) & idx->mask)
+	{
+		if (idx->slots[slot].hash != hash) continue;
+		if (best != -1 && i > best)        continue;
 
-		if (String_CaselessEquals(key, &curKey)) return curValue;
+		StringsBuffer_UNSAFE_GetRaw(idx->list, i, &curEntry);
+		String_UNSAFE_Separate(&curEntry, idx->separator, &curKey, &curValue);
+		if (String_CaselessEquals(key, &curKey)) best = i;
 	}
-	return String_Empty;
+	return best;
 }
 
 int EntryList_Find(struct StringsBuffer* list, const cc_string* key, char separator) {
 	cc_string curEntry, curKey, curValue;
+	struct EntryListIndex* idx = EntryList_GetIndex(list, separator);
 	int i;
+	if (idx) return EntryList_FindIndexed(idx, key);
 
 	for (i = 0; i < list->count; i++) {
 		StringsBuffer_UNSAFE_GetRaw(list, i, &curEntry);
@@ -76,6 +76,25 @@ CC_NOINLINE void EntryList_Set(struct StringsBuffer* list, const cc_string* key,
 CC_NOINLINE STRING_REF cc_string EntryList_UNSAFE_Get(struct StringsBuffer* list, const cc_string* key, char separator);
 /* Finds the index of the entry whose key caselessly equals the given key. */
 CC_NOINLINE int EntryList_Find(struct StringsBuffer* list, const cc_string* key, char separator);
+/* Removes the entry at the given index, keeping any index over the list up to date. */
+CC_NOINLINE void EntryList_RemoveAt(struct StringsBuffer* list, int i);
+
+#define ENTRYLIST_MIN_SLOTS 64
+struct EntryListSlot { int index; cc_uint32 hash; };
+/* Hashed index over the keys of a list, so Find/Get/Set don't have to scan every entry. */
+/* NOTE: Only used when the separator passed to EntryList functions matches the index's separator. */
+struct EntryListIndex {
+	struct EntryListIndex* next;
+	struct StringsBuffer* list;
+	struct EntryListSlot* slots;
+	int mask; /* Number of slots - 1 */
+	char separator;
+};
+/* Builds an index over the given list, which is then kept in sync by EntryList functions. */
+/* NOTE: Entries must only be added/removed through EntryList functions while indexed. */
+CC_NOINLINE void EntryList_AddIndex(struct EntryListIndex* idx, struct StringsBuffer* list, char separator);
+/* Stops the list from being indexed, and frees the index's slots. */
+CC_NOINLINE void EntryList_RemoveIndex(struct EntryListIndex* idx);
 
 CC_END_HEADER
 #endif
@@ -59,10 +59,7 @@ static void TextWidget_BuildMesh(void* widget, struct VertexTextured** vertices)
 
 static int TextWidget_Render2(void* widget, int offset) {
 	struct TextWidget* w = (struct TextWidget*)widget;
-	if (w->tex.ID) {
-		Gfx_BindTexture(w->tex.ID);
-		Gfx_DrawVb_IndexedTris_Range(4, offset);
-	}
+	if (w->tex.ID) Gfx_Draw2DRange(w->tex.ID, 4, offset);
 	return offset + 4;
 }
 
@@ -156,7 +153,6 @@ static void ButtonWidget_Render(void* widget, float delta) {
 	} else {
 		/* Split button down the middle */
 		scale = (w->width / 400.0f) / (2 * DisplayInfo.ScaleX);
-		Gfx_BindTexture(back.ID); /* avoid bind twice */
 
 		back.width = (w->width / 2);
 		back.uv.u1 = 0.0f; back.uv.u2 = BUTTON_uWIDTH * scale;
@@ -214,14 +210,11 @@ static void ButtonWidget_BuildMesh(void* widget, struct VertexTextured** vertice
 
 static int ButtonWidget_Render2(void* widget, int offset) {
 	struct ButtonWidget* w = (struct ButtonWidget*)widget;	
-	Gfx_BindTexture(Gui.ClassicTexture ? Gui.GuiClassicTex : Gui.GuiTex);
+	GfxResourceID tex = Gui.ClassicTexture ? Gui.GuiClassicTex : Gui.GuiTex;
 	/* TODO: Does this 400 need to take DPI into account */
-	Gfx_DrawVb_IndexedTris_Range(w->width >= 400 ? 4 : 8, offset);
+	Gfx_Draw2DRange(tex, w->width >= 400 ? 4 : 8, offset);
 
-	if (w->tex.ID) {
-		Gfx_BindTexture(w->tex.ID);
-		Gfx_DrawVb_IndexedTris_Range(4, offset + 8);
-	}
+	if (w->tex.ID) Gfx_Draw2DRange(w->tex.ID, 4, offset + 8);
 	return offset + 12;
 }
 
@@ -450,9 +443,7 @@ static void HotbarWidget_BuildMesh(void* widget, struct VertexTextured** vertice
 static void HotbarWidget_RenderOutline(struct HotbarWidget* w, int offset) {
 	GfxResourceID tex;
 	tex = Gui.ClassicTexture ? Gui.GuiClassicTex : Gui.GuiTex;
-
-	Gfx_BindTexture(tex);
-	Gfx_DrawVb_IndexedTris_Range(8, offset);
+	Gfx_Draw2DRange(tex, 8, offset);
 }
 
 static void HotbarWidget_RenderEntries(struct HotbarWidget* w, int offset) {
@@ -832,9 +823,7 @@ static int TableWidget_Render2(void* widget, int offset) {
 			size, size, topSelColor, bottomSelColor);
 	}
 
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	Gfx_BindDynamicVb(w->vb);
-
+	Gfx_Bind2DVb(w->vb);
 	if (w->verticesCount) {
 		IsometricDrawer_Render(w->verticesCount, offset, w->state);
 	}
@@ -1596,13 +1585,11 @@ static void TextInputWidget_BuildMesh(void* widget, struct VertexTextured** vert
 
 static int TextInputWidget_Render2(void* widget, int offset) {
 	struct InputWidget* w = (struct InputWidget*)widget;
-	Gfx_BindTexture(w->inputTex.ID);
-	Gfx_DrawVb_IndexedTris_Range(4, offset);
+	Gfx_Draw2DRange(w->inputTex.ID, 4, offset);
 	offset += 4;
 
 	if (w->showCaret && Math_Mod1((float)w->caretAccumulator) < 0.5f) {
-		Gfx_BindTexture(w->caretTex.ID);
-		Gfx_DrawVb_IndexedTris_Range(4, offset);
+		Gfx_Draw2DRange(w->caretTex.ID, 4, offset);
 	}
 	return offset + 4;
 }
@@ -2458,9 +2445,7 @@ static int TextGroupWidget_Render2(void* widget, int offset) {
 	for (i = 0; i < w->lines; i++, offset += 4)
 	{
 		if (!textures[i].ID) continue;
-
-		Gfx_BindTexture(textures[i].ID);
-		Gfx_DrawVb_IndexedTris_Range(4, offset);
+		Gfx_Draw2DRange(textures[i].ID, 4, offset);
 	}
 	return offset;
 }
@@ -2814,10 +2799,9 @@ static int ThumbstickWidget_Render2(void* widget, int offset) {
 	int i, base, flags = ThumbstickWidget_CalcDirs(w);
 
 	if (Gui.TouchTex) {
-		Gfx_BindTexture(Gui.TouchTex);
 		for (i = 0; i < 4; i++) {
 			base = (flags & (1 << i)) ? 0 : THUMBSTICKWIDGET_PER;
-			Gfx_DrawVb_IndexedTris_Range(4, offset + base + (i * 4));
+			Gfx_Draw2DRange(Gui.TouchTex, 4, offset + base + (i * 4));
 		}
 	}
 	return offset + THUMBSTICKWIDGET_MAX;
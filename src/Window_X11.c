@@ -58,6 +58,12 @@
 #undef CC_BUILD_XIM
 #endif
 
+#if defined CC_BUILD_LINUX || defined CC_BUILD_BSD
+#define CC_BUILD_XSHM
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif
+
 #define _NET_WM_STATE_REMOVE 0
 #define _NET_WM_STATE_ADD    1
 #define _NET_WM_STATE_TOGGLE 2
@@ -77,6 +83,10 @@ static Atom net_wm_state_fullscreen;
 static Atom xa_clipboard, xa_targets, xa_utf8_string, xa_data_sel;
 static Atom xa_atom = 4;
 static cc_bool grabCursor;
+#ifdef CC_BUILD_XSHM
+/* Whether the X server may still be reading pixels from the shared framebuffer */
+static cc_bool shm_pending;
+#endif
 static long win_eventMask = StructureNotifyMask | /* SubstructureNotifyMask | */ 
 	ExposureMask      | KeyReleaseMask  | KeyPressMask    | KeymapStateMask   | 
 	PointerMotionMask | FocusChangeMask | ButtonPressMask | ButtonReleaseMask | 
@@ -765,6 +775,12 @@ void Window_ProcessEvents(float delta) {
 	Window focus;
 	int focusRevert;
 
+#ifdef CC_BUILD_XSHM
+	/* X server must finish reading the pixels before they get drawn over */
+	/*  (only sync once per frame, instead of after every drawn rectangle) */
+	if (shm_pending) { XSync(win_display, False); shm_pending = false; }
+#endif
+
 	while (Window_Main.Exists) {
 		if (!XCheckIfEvent(win_display, &e, FilterEvent, (XPointer)win)) break;
 		if (XFilterEvent(&e, None) == True) continue;
@@ -1216,11 +1232,105 @@ static XImage* fb_image;
 static void* fb_data;
 static int fb_fast;
 
+#ifdef CC_BUILD_XSHM
+/* MIT-SHM lets the X server read pixels directly from memory shared with it, */
+/*  instead of all the pixels having to be sent through the X connection */
+typedef struct { XID shmseg; int shmid; char* shmaddr; Bool readOnly; } XShmSegmentInfo;
+static Bool    (*_XShmQueryExtension)(Display* dpy);
+static XImage* (*_XShmCreateImage)(Display* dpy, Visual* visual, unsigned int depth, int format,
+								char* data, XShmSegmentInfo* info, unsigned int width, unsigned int height);
+static Bool    (*_XShmAttach)(Display* dpy, XShmSegmentInfo* info);
+static Bool    (*_XShmDetach)(Display* dpy, XShmSegmentInfo* info);
+static Bool    (*_XShmPutImage)(Display* dpy, Drawable d, GC gc, XImage* image, int srcX, int srcY,
+								int dstX, int dstY, unsigned int width, unsigned int height, Bool sendEvent);
+
+static const cc_string xextLib = String_FromConst("libXext.so.6");
+static const cc_string xextAlt = String_FromConst("libXext.so");
+static cc_bool shm_loaded, shm_supported, shm_error;
+static XShmSegmentInfo shm_info;
+
+static cc_bool LoadShmFuncs(void) {
+	static const struct DynamicLibSym funcs[] = {
+		DynamicLib_Sym(XShmQueryExtension), DynamicLib_Sym(XShmCreateImage),
+		DynamicLib_Sym(XShmAttach),         DynamicLib_Sym(XShmDetach),
+		DynamicLib_Sym(XShmPutImage)
+	};
+	void* lib;
+	int i;
+
+	/* libXext is optional, so don't warn when it's missing */
+	lib = DynamicLib_Load2(&xextLib);
+	if (!lib) lib = DynamicLib_Load2(&xextAlt);
+	if (!lib) return false;
+
+	for (i = 0; i < Array_Elems(funcs); i++) 
+	{
+		*funcs[i].symAddr = DynamicLib_Get2(lib, funcs[i].name);
+		if (!(*funcs[i].symAddr)) return false;
+	}
+	return _XShmQueryExtension(win_display);
+}
+
+static int ShmErrorHandler(Display* dpy, XErrorEvent* ev) {
+	shm_error = true;
+	return 0;
+}
+
+static void FreeShmImage(void) {
+	if (shm_info.shmaddr) shmdt(shm_info.shmaddr);
+	shm_info.shmaddr = NULL;
+	XFree(fb_image);
+	fb_image = NULL;
+}
+
+/* Tries to create a framebuffer image whose pixels are in memory shared with the X server */
+static cc_bool TryAllocShmFramebuffer(int width, int height) {
+	X11_ErrorHandler oldHandler;
+	
+	if (!shm_loaded) {
+		shm_loaded    = true;
+		shm_supported = LoadShmFuncs();
+	}
+	if (!shm_supported) return false;
+
+	fb_image = _XShmCreateImage(win_display, win_visual.visual, win_visual.depth, 
+								ZPixmap, NULL, &shm_info, width, height);
+	if (!fb_image) return false;
+	shm_info.shmaddr  = NULL;
+	shm_info.readOnly = True;
+
+	shm_info.shmid = shmget(IPC_PRIVATE, fb_image->bytes_per_line * height, IPC_CREAT | 0600);
+	if (shm_info.shmid == -1) { FreeShmImage(); return false; }
+
+	shm_info.shmaddr = (char*)shmat(shm_info.shmid, NULL, 0);
+	if (shm_info.shmaddr == (char*)-1) shm_info.shmaddr = NULL;
+
+	/* Attaching fails when X server is on another machine, but that's only reported asynchronously */
+	shm_error  = !shm_info.shmaddr;
+	if (!shm_error) {
+		oldHandler = XSetErrorHandler(ShmErrorHandler);
+		_XShmAttach(win_display, &shm_info);
+		XSync(win_display, False);
+		XSetErrorHandler(oldHandler);
+	}
+
+	/* Shared memory is only actually freed once both this process and X server detach from it */
+	shmctl(shm_info.shmid, IPC_RMID, NULL);
+	if (shm_error) {
+		Platform_LogConst("Falling back to XPutImage, as X server can't use shared memory");
+		shm_supported = false;
+		FreeShmImage(); return false;
+	}
+
+	fb_image->data = shm_info.shmaddr;
+	return true;
+}
+#endif
+
 void Window_AllocFramebuffer(struct Bitmap* bmp, int width, int height) {
 	Window win = Window_Main.Handle.val;
 	if (!fb_gc) fb_gc = XCreateGC(win_display, win, 0, NULL);
 
-	bmp->scan0  = (BitmapCol*)Mem_Alloc(width * height, BITMAPCOLOR_SIZE, "window pixels");
 	bmp->width  = width;
 	bmp->height = height;
 
@@ -1228,7 +1338,21 @@ void Window_AllocFramebuffer(struct Bitmap* bmp, int width, int height) {
 	/* Easy for 24/32 bit case, but much trickier with other depths */
 	/*  (have to do a manual and slow second blit for other depths) */
 	fb_fast = win_visual.depth == 24 || win_visual.depth == 32;
-	fb_data = fb_fast ? bmp->scan0 : Mem_Alloc(width * height, BITMAPCOLOR_SIZE, "window blit");
+
+#ifdef CC_BUILD_XSHM
+	if (TryAllocShmFramebuffer(width, height)) {
+		fb_data = fb_image->data;
+		/* Can draw directly into the shared memory when the pixel layouts match */
+		fb_fast = fb_fast && fb_image->bytes_per_line == width * BITMAPCOLOR_SIZE;
+
+		bmp->scan0 = fb_fast ? (BitmapCol*)fb_data : 
+					(BitmapCol*)Mem_Alloc(width * height, BITMAPCOLOR_SIZE, "window pixels");
+		return;
+	}
+#endif
+
+	bmp->scan0 = (BitmapCol*)Mem_Alloc(width * height, BITMAPCOLOR_SIZE, "window pixels");
+	fb_data    = fb_fast ? bmp->scan0 : Mem_Alloc(width * height, BITMAPCOLOR_SIZE, "window blit");
 
 	fb_image = XCreateImage(win_display, win_visual.visual,
 		win_visual.depth, ZPixmap, 0, (char*)fb_data,
@@ -1247,6 +1371,12 @@ static void BlitFramebuffer(int x1, int y1, int width, int height, struct Bitmap
 		row = Bitmap_GetRow(bmp, y);
 		dst = ((unsigned char*)fb_image->data) + y * fb_image->bytes_per_line;
 
+		/* Same pixel format, but rows are padded differently */
+		if (win_visual.depth == 24 || win_visual.depth == 32) {
+			Mem_Copy(dst + x1 * 4, row + x1, width * 4);
+			continue;
+		}
+
 		for (x = x1; x < x1 + width; x++) {
 			src = row[x];
 			R = BitmapCol_R(src);
@@ -1282,11 +1412,32 @@ void Window_DrawFramebuffer(Rect2D r, struct Bitmap* bmp) {
 	/* Convert 32 bit depth to window depth when required */
 	if (!fb_fast) BlitFramebuffer(r.x, r.y, r.width, r.height, bmp);
 
+#ifdef CC_BUILD_XSHM
+	if (shm_info.shmaddr) {
+		_XShmPutImage(win_display, win, fb_gc, fb_image,
+			r.x, r.y, r.x, r.y, r.width, r.height, False);
+		/* Synced in Window_ProcessEvents, before the framebuffer is redrawn */
+		shm_pending = true;
+		return;
+	}
+#endif
+
 	XPutImage(win_display, win, fb_gc, fb_image,
 		r.x, r.y, r.x, r.y, r.width, r.height);
 }
 
 void Window_FreeFramebuffer(struct Bitmap* bmp) {
+#ifdef CC_BUILD_XSHM
+	if (shm_info.shmaddr) {
+		_XShmDetach(win_display, &shm_info);
+		XSync(win_display, False);
+		shm_pending = false;
+
+		if (bmp->scan0 != fb_data) Mem_Free(bmp->scan0);
+		FreeShmImage();
+		return;
+	}
+#endif
 	XFree(fb_image);
 	Mem_Free(bmp->scan0);
 	if (bmp->scan0 != fb_data) Mem_Free(fb_data);
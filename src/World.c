@@ -10,9 +10,116 @@
 #include "Game.h"
 #include "TexturePack.h"
 #include "Window.h"
+#include "Funcs.h"
+#include "EnvRenderer.h"
 
 struct _WorldData World;
 static char nameBuffer[STRING_SIZE];
+
+
+/*########################################################################################################################*
+*-----------------------------------------------------World occupancy-----------------------------------------------------*
+*#########################################################################################################################*/
+struct _WorldOccupancyData WorldOccupancy;
+#define BRICK_SIZE (1 << OCCUPANCY_BRICK_SHIFT)
+#define BRICKS_PER_CHUNK (CHUNK_SIZE / BRICK_SIZE)
+
+static void WorldOccupancy_Free(void) {
+	Mem_Free(WorldOccupancy.Bricks);
+	Mem_Free(WorldOccupancy.Chunks);
+	WorldOccupancy.Bricks = NULL;
+	WorldOccupancy.Chunks = NULL;
+}
+
+static void WorldOccupancy_Mark(int x, int y, int z) {
+	int i = WorldOccupancy_BrickPack(x >> OCCUPANCY_BRICK_SHIFT, y >> OCCUPANCY_BRICK_SHIFT, z >> OCCUPANCY_BRICK_SHIFT);
+	WorldOccupancy.Bricks[i >> 3] |= 1 << (i & 7);
+
+	i = World_ChunkPack(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+	WorldOccupancy.Chunks[i >> 3] |= 1 << (i & 7);
+}
+
+static void WorldOccupancy_Build(void) {
+	int bricksY, bricksCount;
+	int x, y, z, i;
+
+	WorldOccupancy_Free();
+	if (!World.Blocks) return;
+
+	WorldOccupancy.BricksX = (World.Width  + OCCUPANCY_BRICK_MAX) >> OCCUPANCY_BRICK_SHIFT;
+	WorldOccupancy.BricksZ = (World.Length + OCCUPANCY_BRICK_MAX) >> OCCUPANCY_BRICK_SHIFT;
+	bricksY     = (World.Height + OCCUPANCY_BRICK_MAX) >> OCCUPANCY_BRICK_SHIFT;
+	bricksCount = WorldOccupancy.BricksX * bricksY * WorldOccupancy.BricksZ;
+
+	WorldOccupancy.Bricks = (cc_uint8*)Mem_TryAllocCleared((bricksCount + 7) >> 3, 1);
+	WorldOccupancy.Chunks = (cc_uint8*)Mem_TryAllocCleared((World.ChunksCount + 7) >> 3, 1);
+	/* Not having the occupancy map just means empty space can't be skipped */
+	if (!WorldOccupancy.Bricks || !WorldOccupancy.Chunks) { WorldOccupancy_Free(); return; }
+
+	for (y = 0, i = 0; y < World.Height; y++) {
+		for (z = 0; z < World.Length; z++) {
+			for (x = 0; x < World.Width; x++, i++) 
+			{
+				if (World_GetRawBlock(i) != BLOCK_AIR) WorldOccupancy_Mark(x, y, z);
+			}
+		}
+	}
+}
+
+static cc_bool WorldOccupancy_BrickHasBlocks(int bx, int by, int bz) {
+	int minX = bx << OCCUPANCY_BRICK_SHIFT, maxX = min(minX + OCCUPANCY_BRICK_MAX, World.MaxX);
+	int minY = by << OCCUPANCY_BRICK_SHIFT, maxY = min(minY + OCCUPANCY_BRICK_MAX, World.MaxY);
+	int minZ = bz << OCCUPANCY_BRICK_SHIFT, maxZ = min(minZ + OCCUPANCY_BRICK_MAX, World.MaxZ);
+	int x, y, z;
+
+	for (y = minY; y <= maxY; y++) {
+		for (z = minZ; z <= maxZ; z++) {
+			for (x = minX; x <= maxX; x++) 
+			{
+				if (World_GetBlock(x, y, z) != BLOCK_AIR) return true;
+			}
+		}
+	}
+	return false;
+}
+
+static cc_bool WorldOccupancy_ChunkHasBricks(int cx, int cy, int cz) {
+	int minX = cx * BRICKS_PER_CHUNK, maxX = min(minX + BRICKS_PER_CHUNK, WorldOccupancy.BricksX);
+	int minY = cy * BRICKS_PER_CHUNK, maxY = min(minY + BRICKS_PER_CHUNK, (World.Height + OCCUPANCY_BRICK_MAX) >> OCCUPANCY_BRICK_SHIFT);
+	int minZ = cz * BRICKS_PER_CHUNK, maxZ = min(minZ + BRICKS_PER_CHUNK, WorldOccupancy.BricksZ);
+	int x, y, z, i;
+
+	for (y = minY; y < maxY; y++) {
+		for (z = minZ; z < maxZ; z++) {
+			for (x = minX; x < maxX; x++) 
+			{
+				i = WorldOccupancy_BrickPack(x, y, z);
+				if (WorldOccupancy_BitSet(WorldOccupancy.Bricks, i)) return true;
+			}
+		}
+	}
+	return false;
+}
+
+/* Updates the occupancy bits after the block at the given coordinates has changed */
+static void WorldOccupancy_Update(int x, int y, int z, BlockID block) {
+	int bx = x >> OCCUPANCY_BRICK_SHIFT, by = y >> OCCUPANCY_BRICK_SHIFT, bz = z >> OCCUPANCY_BRICK_SHIFT;
+	int cx = x >> CHUNK_SHIFT,           cy = y >> CHUNK_SHIFT,           cz = z >> CHUNK_SHIFT;
+	int i;
+	if (!WorldOccupancy.Bricks) return;
+
+	if (block != BLOCK_AIR) { WorldOccupancy_Mark(x, y, z); return; }
+	if (World_IsEmptyBrick(x, y, z) || WorldOccupancy_BrickHasBlocks(bx, by, bz)) return;
+
+	i = WorldOccupancy_BrickPack(bx, by, bz);
+	WorldOccupancy.Bricks[i >> 3] &= ~(1 << (i & 7));
+	if (WorldOccupancy_ChunkHasBricks(cx, cy, cz)) return;
+
+	i = World_ChunkPack(cx, cy, cz);
+	WorldOccupancy.Chunks[i >> 3] &= ~(1 << (i & 7));
+}
+
+
 /*########################################################################################################################*
 *----------------------------------------------------------World----------------------------------------------------------*
 *#########################################################################################################################*/
@@ -38,6 +145,8 @@ static void GenerateNewUuid(void) {
 }
 
 void World_Reset(void) {
+	/* Background rain height calculation reads from the blocks array */
+	EnvRenderer_StopWeatherPrefill();
 #ifdef EXTENDED_BLOCKS
 	if (World.Blocks != World.Blocks2) Mem_Free(World.Blocks2);
 	World.Blocks2 = NULL;
@@ -45,6 +154,7 @@ void World_Reset(void) {
 #endif
 	Mem_Free(World.Blocks);
 	World.Blocks = NULL;
+	WorldOccupancy_Free();
 	String_InitArray(World.Name, nameBuffer);
 
 	World_SetDimensions(0, 0, 0);
@@ -80,6 +190,7 @@ void World_SetNewMap(BlockRaw* blocks, int width, int height, int length) {
 	if (Env.CloudsHeight == -1) { Env.CloudsHeight = height + 2; }
 
 	GenerateNewUuid();
+	WorldOccupancy_Build();
 	World.Loaded = true;
 	Event_RaiseVoid(&WorldEvents.MapLoaded);
 }
@@ -128,15 +239,16 @@ void World_SetBlock(int x, int y, int z, BlockID block) {
 
 	/* defer allocation of second map array if possible */
 	if (World.Blocks == World.Blocks2) {
-		if (block < 256) return;
-		LazyInitUpper(i, block);
-		return;
+		if (block >= 256) LazyInitUpper(i, block);
+	} else {
+		World.Blocks2[i] = (BlockRaw)(block >> 8);
 	}
-	World.Blocks2[i] = (BlockRaw)(block >> 8);
+	WorldOccupancy_Update(x, y, z, block);
 }
 #else
 void World_SetBlock(int x, int y, int z, BlockID block) {
 	World.Blocks[World_Pack(x, y, z)] = block; 
+	WorldOccupancy_Update(x, y, z, block);
 }
 #endif
 
@@ -103,6 +103,35 @@ void World_SetBlock(int x, int y, int z, BlockID block);
 /* Otherwise returns the block at the given coordinates. */
 BlockID World_SafeGetBlock(int x, int y, int z);
 
+/* Coarse bitmaps of which regions of the world contain any non-air blocks */
+/* Used to skip over empty space when ray tracing or searching for collisions */
+CC_VAR extern struct _WorldOccupancyData {
+	/* One bit per 4x4x4 brick of blocks. NULL if no world loaded. */
+	cc_uint8* Bricks;
+	/* One bit per 16x16x16 chunk of blocks. NULL if no world loaded. */
+	cc_uint8* Chunks;
+	/* Number of bricks along X and Z axes. */
+	int BricksX, BricksZ;
+} WorldOccupancy;
+#define OCCUPANCY_BRICK_SHIFT 2
+#define OCCUPANCY_BRICK_MAX   3
+
+#define WorldOccupancy_BrickPack(bx, by, bz) (((by) * WorldOccupancy.BricksZ + (bz)) * WorldOccupancy.BricksX + (bx))
+#define WorldOccupancy_BitSet(bits, i) ((bits)[(i) >> 3] & (1 << ((i) & 7)))
+
+/* Whether the 4x4x4 brick containing the given coordinates contains only air. */
+/* NOTE: Does NOT check that the coordinates are inside the map. */
+static CC_INLINE cc_bool World_IsEmptyBrick(int x, int y, int z) {
+	int i = WorldOccupancy_BrickPack(x >> OCCUPANCY_BRICK_SHIFT, y >> OCCUPANCY_BRICK_SHIFT, z >> OCCUPANCY_BRICK_SHIFT);
+	return WorldOccupancy.Bricks && !WorldOccupancy_BitSet(WorldOccupancy.Bricks, i);
+}
+/* Whether the 16x16x16 chunk containing the given coordinates contains only air. */
+/* NOTE: Does NOT check that the coordinates are inside the map. */
+static CC_INLINE cc_bool World_IsEmptyChunk(int x, int y, int z) {
+	int i = World_ChunkPack(x >> CHUNK_SHIFT, y >> CHUNK_SHIFT, z >> CHUNK_SHIFT);
+	return WorldOccupancy.Chunks && !WorldOccupancy_BitSet(WorldOccupancy.Chunks, i);
+}
+
 /* Whether the given coordinates lie inside the map. */
 static CC_INLINE cc_bool World_Contains(int x, int y, int z) {
 	return (unsigned)x < (unsigned)World.Width
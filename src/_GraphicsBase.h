@@ -12,6 +12,8 @@
 #include "Logger.h"
 
 struct _GfxData Gfx;
+/* Maximum number of vertices that can be pending in the 2D batch */
+#define BATCH2D_MAX_VERTICES 256
 static GfxResourceID Gfx_quadVb, Gfx_texVb;
 const cc_string Gfx_LowPerfMessage = String_FromConst("&eRunning in reduced performance mode (game minimised or hidden)");
 
@@ -127,8 +129,8 @@ static void RecreateDynamicVb(GfxResourceID* vb, VertexFormat fmt, int maxVertic
 static void InitDefaultResources(void) {
 	Gfx.DefaultIb = Gfx_CreateIb2(GFX_MAX_INDICES, MakeIndices, NULL);
 
-	RecreateDynamicVb(&Gfx_quadVb, VERTEX_FORMAT_COLOURED, 4);
-	RecreateDynamicVb(&Gfx_texVb,  VERTEX_FORMAT_TEXTURED, 4);
+	RecreateDynamicVb(&Gfx_quadVb, VERTEX_FORMAT_COLOURED, BATCH2D_MAX_VERTICES);
+	RecreateDynamicVb(&Gfx_texVb,  VERTEX_FORMAT_TEXTURED, BATCH2D_MAX_VERTICES);
 }
 
 static void FreeDefaultResources(void) {
@@ -174,47 +176,122 @@ static CC_INLINE void EndReducedPerformance(void) {
 /*########################################################################################################################*
 *--------------------------------------------------------2D drawing-------------------------------------------------------*
 *#########################################################################################################################*/
+struct _Gfx2DStats Gfx_2DStats;
+#define BATCH2D_QUADS 1 /* Batch contains quads to upload into Gfx_quadVb/Gfx_texVb */
+#define BATCH2D_RANGE 2 /* Batch contains a range of vertices from batch2D_vb */
+
+static cc_uint8 batch2D_mode;
+static VertexFormat batch2D_fmt;
+static GfxResourceID batch2D_tex, batch2D_vb;
+static int batch2D_count, batch2D_start;
+/* Coloured vertices are also stored in here (just tightly packed) */
+static struct VertexTextured batch2D_verts[BATCH2D_MAX_VERTICES];
+
+static void Batch2D_DrawQuads(void) {
+	GfxResourceID vb = batch2D_fmt == VERTEX_FORMAT_TEXTURED ? Gfx_texVb : Gfx_quadVb;
+	if (batch2D_fmt == VERTEX_FORMAT_TEXTURED) Gfx_BindTexture(batch2D_tex);
+
+	Gfx_SetVertexFormat(batch2D_fmt);
+	Gfx_SetDynamicVbData(vb, batch2D_verts, batch2D_count);
+	Gfx_DrawVb_IndexedTris(batch2D_count);
+}
+
+static void Batch2D_DrawRange(void) {
+	/* Always rebind, as locking/updating another dynamic VB (e.g. when building */
+	/*  the next screen's mesh) may have bound a different VB on some backends */
+	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
+	Gfx_BindDynamicVb(batch2D_vb);
+
+	Gfx_BindTexture(batch2D_tex);
+	Gfx_DrawVb_IndexedTris_Range(batch2D_count, batch2D_start);
+}
+
+static void Batch2D_Submit(void) {
+	if (!batch2D_count) return;
+
+	if (batch2D_mode == BATCH2D_QUADS) {
+		Batch2D_DrawQuads();
+	} else {
+		Batch2D_DrawRange();
+	}
+
+	Gfx_2DStats.DrawCalls++;
+	Gfx_2DStats.Vertices += batch2D_count;
+	batch2D_count = 0;
+}
+
+void Gfx_Flush2D(void) {
+	Batch2D_Submit();
+}
+
+void Gfx_Bind2DVb(GfxResourceID vb) {
+	Gfx_Flush2D();
+	batch2D_vb = vb;
+}
+
+void Gfx_Draw2DRange(GfxResourceID texId, int verticesCount, int startVertex) {
+	Gfx_2DStats.Requests++;
+	if (!verticesCount) return;
+
+	/* Range can only be merged when it directly follows on from the pending range */
+	if (batch2D_count && (batch2D_mode != BATCH2D_RANGE || batch2D_tex != texId ||
+		batch2D_start + batch2D_count != startVertex)) Batch2D_Submit();
+
+	if (!batch2D_count) {
+		batch2D_mode  = BATCH2D_RANGE;
+		batch2D_tex   = texId;
+		batch2D_start = startVertex;
+	}
+	batch2D_count += verticesCount;
+	if (!gfx_rendering2D) Gfx_Flush2D();
+}
+
+/* Returns pointer to where the vertices of a new quad should be written to */
+static void* Batch2D_AddQuad(VertexFormat fmt, GfxResourceID texId) {
+	cc_uint8* ptr;
+	Gfx_2DStats.Requests++;
+
+	if (batch2D_count && (batch2D_mode != BATCH2D_QUADS || batch2D_fmt != fmt || batch2D_tex != texId ||
+		batch2D_count + 4 > BATCH2D_MAX_VERTICES)) Batch2D_Submit();
+
+	batch2D_mode = BATCH2D_QUADS;
+	batch2D_fmt  = fmt;
+	batch2D_tex  = texId;
+
+	ptr = (cc_uint8*)batch2D_verts + batch2D_count * strideSizes[fmt];
+	batch2D_count += 4;
+	return ptr;
+}
+
+/* Outside of 2D mode, there is no Gfx_End2D to guarantee the quad is drawn */
+#define Batch2D_EndQuad() if (!gfx_rendering2D) Gfx_Flush2D()
+
 #ifndef CC_BUILD_3DS
 void Gfx_Draw2DFlat(int x, int y, int width, int height, PackedCol color) {
-	struct VertexColoured* v;
-
-	Gfx_SetVertexFormat(VERTEX_FORMAT_COLOURED);
-	v = (struct VertexColoured*)Gfx_LockDynamicVb(Gfx_quadVb, VERTEX_FORMAT_COLOURED, 4);
+	struct VertexColoured* v = (struct VertexColoured*)Batch2D_AddQuad(VERTEX_FORMAT_COLOURED, 0);
 
 	v->x = (float)x;           v->y = (float)y;            v->z = 0; v->Col = color; v++;
 	v->x = (float)(x + width); v->y = (float)y;            v->z = 0; v->Col = color; v++;
 	v->x = (float)(x + width); v->y = (float)(y + height); v->z = 0; v->Col = color; v++;
 	v->x = (float)x;           v->y = (float)(y + height); v->z = 0; v->Col = color; v++;
-
-	Gfx_UnlockDynamicVb(Gfx_quadVb);
-	Gfx_DrawVb_IndexedTris(4);
+	Batch2D_EndQuad();
 }
 
 void Gfx_Draw2DGradient(int x, int y, int width, int height, PackedCol top, PackedCol bottom) {
-	struct VertexColoured* v;
-
-	Gfx_SetVertexFormat(VERTEX_FORMAT_COLOURED);
-	v = (struct VertexColoured*)Gfx_LockDynamicVb(Gfx_quadVb, VERTEX_FORMAT_COLOURED, 4);
+	struct VertexColoured* v = (struct VertexColoured*)Batch2D_AddQuad(VERTEX_FORMAT_COLOURED, 0);
 
 	v->x = (float)x;           v->y = (float)y;            v->z = 0; v->Col = top; v++;
 	v->x = (float)(x + width); v->y = (float)y;            v->z = 0; v->Col = top; v++;
 	v->x = (float)(x + width); v->y = (float)(y + height); v->z = 0; v->Col = bottom; v++;
 	v->x = (float)x;           v->y = (float)(y + height); v->z = 0; v->Col = bottom; v++;
-
-	Gfx_UnlockDynamicVb(Gfx_quadVb);
-	Gfx_DrawVb_IndexedTris(4);
+	Batch2D_EndQuad();
 }
 
 void Gfx_Draw2DTexture(const struct Texture* tex, PackedCol color) {
-	struct VertexTextured* ptr;
-
-	Gfx_SetVertexFormat(VERTEX_FORMAT_TEXTURED);
-	ptr = (struct VertexTextured*)Gfx_LockDynamicVb(Gfx_texVb, VERTEX_FORMAT_TEXTURED, 4);
+	struct VertexTextured* ptr = (struct VertexTextured*)Batch2D_AddQuad(VERTEX_FORMAT_TEXTURED, tex->ID);
 
 	Gfx_Make2DQuad(tex, color, &ptr);
-
-	Gfx_UnlockDynamicVb(Gfx_texVb);
-	Gfx_DrawVb_IndexedTris(4);
+	Batch2D_EndQuad();
 }
 #endif
 
@@ -253,9 +330,11 @@ void Gfx_Begin2D(int width, int height) {
 	gfx_hadFog = Gfx_GetFog();
 	if (gfx_hadFog) Gfx_SetFog(false);
 	gfx_rendering2D = true;
+	Mem_Set(&Gfx_2DStats, 0, sizeof(Gfx_2DStats));
 }
 
 void Gfx_End2D(void) {
+	Gfx_Flush2D();
 	Gfx_SetDepthTest(true);
 	Gfx_SetDepthWrite(true);
 	Gfx_SetAlphaBlending(false);
@@ -439,12 +518,10 @@ GfxResourceID Gfx_CreateTexture2(struct Bitmap* bmp, int rowWidth, cc_uint8 flag
 }
 
 void Texture_Render(const struct Texture* tex) {
-	Gfx_BindTexture(tex->ID);
 	Gfx_Draw2DTexture(tex, PACKEDCOL_WHITE);
 }
 
 void Texture_RenderShaded(const struct Texture* tex, PackedCol shadeColor) {
-	Gfx_BindTexture(tex->ID);
 	Gfx_Draw2DTexture(tex, shadeColor);
 }
 